@@ -25,6 +25,7 @@
 
 #include "casadi_options.hpp"
 #include "casadi_exception.hpp"
+#include <cstdlib>
 
 namespace casadi {
 
@@ -35,6 +36,9 @@ namespace casadi {
   bool CasadiOptions::profilingBinary = true;
   bool CasadiOptions::purgeSeeds = false;
   bool CasadiOptions::allowed_internal_api = false;
+  std::string CasadiOptions::compile_cache_dir =
+    getenv("CASADI_COMPILE_CACHE") ? getenv("CASADI_COMPILE_CACHE") : "";
+  int CasadiOptions::compile_num_threads = 0;
 
   void CasadiOptions::startProfiling(const std::string &filename) {
     profilingLog.open(filename.c_str(), std::ofstream::out);
@@ -79,6 +79,20 @@ namespace casadi {
 
       static bool allowed_internal_api;
 
+      /** \brief Directory for caching dynamically compiled functions
+      *  Generated sources and shared libraries are stored under a hash of the source code
+      *  and the compiler command, so that an identical function is only compiled once,
+      *  also across processes. Empty to disable.
+      *  Default: the environment variable CASADI_COMPILE_CACHE, if set, otherwise empty
+      */
+      static std::string compile_cache_dir;
+
+      /** \brief Number of threads compiling the translation units of a dynamically
+      *  compiled function in parallel, 0 for the number of available cores
+      *  Default: 0
+      */
+      static int compile_num_threads;
+
 #endif //SWIG
       // Setter and getter for catch_errors_swig
       static void setCatchErrorsSwig(bool flag) { catch_errors_swig = flag; }
@@ -105,6 +119,12 @@ namespace casadi {
 
       static void setAllowedInternalAPI(bool flag) { allowed_internal_api= flag; }
       static bool getAllowedInternalAPI() { return allowed_internal_api; }
+
+      static void setCompileCacheDir(const std::string& dir) { compile_cache_dir = dir; }
+      static std::string getCompileCacheDir() { return compile_cache_dir; }
+
+      static void setCompileNumThreads(int n) { compile_num_threads = n; }
+      static int getCompileNumThreads() { return compile_num_threads; }
   };
 
 } // namespace casadi
@@ -59,6 +59,8 @@
 #include "function/custom_function.hpp"
 #include "function/simulator.hpp"
 #include "function/parallelizer.hpp"
+#include "function/map.hpp"
+#include "function/colored_jacobian.hpp"
 #include "function/control_simulator.hpp"
 #include "function/qp_solver.hpp"
 #include "function/homotopy_nlp_solver.hpp"
@@ -32,6 +32,9 @@
 using namespace std;
 namespace casadi {
 
+  CodeGenerator::CodeGenerator() : split_units_(false), n_parts_(0) {
+  }
+
   void CodeGenerator::flush(std::ostream& s) const {
     s << includes_.str();
     s << endl;
@@ -61,6 +64,19 @@ namespace casadi {
     s << finalization_.str();
   }
 
+  void CodeGenerator::flushUnit(std::ostream& s, int k) const {
+    s << includes_.str();
+    s << endl;
+    s << "#define d double" << endl << endl;
+
+    // Auxiliaries are defined in the main file, declare the scalar ones
+    if (added_auxiliaries_.count(AUX_SQ)) s << "d sq(d x);" << endl;
+    if (added_auxiliaries_.count(AUX_SIGN)) s << "d sign(d x);" << endl;
+    s << endl;
+
+    s << units_.at(k);
+  }
+
   std::string CodeGenerator::numToString(int n) {
     stringstream ss;
     ss << n;
@@ -37,6 +37,8 @@ namespace casadi {
 
   class CASADI_EXPORT CodeGenerator {
   public:
+    /// Constructor
+    CodeGenerator();
 
     /// Add an include file optionally using a relative path "..." instead of an absolute path <...>
     void addInclude(const std::string& new_include, bool relative_path = false);
@@ -92,6 +94,9 @@ namespace casadi {
     /// Flush generated file to a stream
     void flush(std::ostream& s) const;
 
+    /// Flush an additional translation unit to a stream
+    void flushUnit(std::ostream& s, int k) const;
+
     /** Convert in integer to a string */
     static std::string numToString(int n);
 
@@ -132,6 +137,15 @@ namespace casadi {
     std::stringstream function_;
     std::stringstream finalization_;
 
+    // Place parts of large functions in separate translation units
+    bool split_units_;
+
+    // Additional translation units
+    std::vector<std::string> units_;
+
+    // Number of function parts generated so far
+    int n_parts_;
+
     // Set of already included header files
     typedef std::map<const void*, int> PointerMap;
     std::set<std::string> added_includes_;
@@ -0,0 +1,70 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_COLORED_JACOBIAN_HPP
+#define CASADI_COLORED_JACOBIAN_HPP
+
+#include "function.hpp"
+
+namespace casadi {
+
+  // Forward declaration of internal class
+  class ColoredJacobianInternal;
+
+  /** \brief Numerical Jacobian from colored directional derivatives
+
+      The Jacobian of output \a oind with respect to input \a iind of a function is
+      calculated with one forward or adjoint directional derivative per color of a coloring
+      of its sparsity pattern, a star coloring if \a symmetric. The colors are split into
+      chunks, each chunk being one evaluation of a derivative function of \a f, and the
+      chunks can be distributed over a thread pool (one work vector per thread, requires
+      re-entrant derivative functions). The directional derivatives are then scattered into
+      the nonzeros of the Jacobian, the same nonzero always being taken from the same
+      direction.
+
+      The inputs are those of \a f, the outputs are the Jacobian followed by the outputs
+      of \a f, as for Function::jacobian.
+  */
+  class CASADI_EXPORT ColoredJacobian : public Function {
+  public:
+
+    /// Default constructor
+    ColoredJacobian();
+
+    /// Create a Jacobian of output \a oind with respect to input \a iind of \a f
+    ColoredJacobian(const Function& f, int iind=0, int oind=0, bool compact=false,
+                    bool symmetric=false);
+
+    /// Access functions of the node
+    ColoredJacobianInternal* operator->();
+
+    /// Const access functions of the node
+    const ColoredJacobianInternal* operator->() const;
+  };
+
+} // namespace casadi
+
+
+#endif // CASADI_COLORED_JACOBIAN_HPP
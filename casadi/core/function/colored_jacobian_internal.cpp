@@ -0,0 +1,585 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "colored_jacobian_internal.hpp"
+#include "mx_function.hpp"
+#include "../std_vector_tools.hpp"
+#ifndef _WIN32
+#include <unistd.h>
+#endif // _WIN32
+
+using namespace std;
+
+namespace casadi {
+
+  namespace {
+    // Copy the dependency bits held in the nonzeros of a matrix
+    void copyBvec(const DMatrix& from, DMatrix& to) {
+      casadi_assert(from.nnz()==to.nnz());
+      const bvec_t* v = reinterpret_cast<const bvec_t*>(from.ptr());
+      copy(v, v+from.nnz(), reinterpret_cast<bvec_t*>(to.ptr()));
+    }
+  } // namespace
+
+#ifdef USE_CXX11
+  /// The chunks of a ColoredJacobian, for the thread pool
+  class ColoredJacobianJob : public ThreadPool::Job {
+  public:
+    ColoredJacobianJob(ColoredJacobianInternal* m, const cpv_double& arg,
+                       const cpv_double& f_res, double* jac, int* itmp, double* rtmp)
+        : m_(m), arg_(arg), f_res_(f_res), jac_(jac), itmp_(itmp), rtmp_(rtmp) {}
+
+    virtual void evaluateTask(int task, int worker) {
+      // Every worker has its own part of the work vectors
+      m_->evalChunk(task, arg_, f_res_, jac_, itmp_ + worker*m_->work_ni_,
+                    rtmp_ + worker*m_->work_nr_, m_->der_arg_[worker], m_->der_res_[worker]);
+    }
+
+  private:
+    ColoredJacobianInternal* m_;
+    const cpv_double& arg_;
+    const cpv_double& f_res_;
+    double* jac_;
+    int* itmp_;
+    double* rtmp_;
+  };
+#endif // USE_CXX11
+
+  ColoredJacobianInternal::ColoredJacobianInternal(const Function& f, int iind, int oind,
+                                                   bool compact, bool symmetric)
+      : f_(f), iind_(iind), oind_(oind), compact_(compact), symmetric_(symmetric) {
+    addOption("parallelization", OT_STRING, "serial", "", "serial|threads");
+    addOption("num_threads", OT_INTEGER, 0, "Number of worker threads (\"threads\"), "
+              "0 for the number of available cores");
+    addOption("chunk_size", OT_INTEGER, 0, "Number of directional derivatives per evaluation "
+              "of a derivative function, 0 for an equal share of the directions per thread, "
+              "at most 64");
+    addOption("triangular", OT_BOOLEAN, false, "Symmetric Jacobians only: calculate and return "
+              "only the entries on and above the diagonal");
+  }
+
+  ColoredJacobianInternal::~ColoredJacobianInternal() {
+  }
+
+  void ColoredJacobianInternal::init() {
+    // Initialize the differentiated function
+    f_.init(false);
+    casadi_assert_message(iind_>=0 && iind_<f_.getNumInputs(), "ColoredJacobian: input "
+                          << iind_ << " out of range");
+    casadi_assert_message(oind_>=0 && oind_<f_.getNumOutputs(), "ColoredJacobian: output "
+                          << oind_ << " out of range");
+
+    // Get mode
+    if (getOption("parallelization")=="serial") {
+      mode_ = SERIAL;
+    } else if (getOption("parallelization")=="threads") {
+      mode_ = THREADS;
+    } else {
+      casadi_error("Parallelization mode " << getOption("parallelization") << " unknown.");
+    }
+
+    // Number of workers
+    num_threads_ = getOption("num_threads");
+    casadi_assert_message(num_threads_>=0, "ColoredJacobian: \"num_threads\" must be "
+                          "nonnegative");
+    if (num_threads_==0) {
+#ifdef USE_CXX11
+      num_threads_ = thread::hardware_concurrency();
+#elif !defined(_WIN32)
+      num_threads_ = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+      num_threads_ = std::max(num_threads_, 1);
+    }
+    if (mode_==SERIAL) num_threads_ = 1;
+
+    // Sparsity pattern of the Jacobian with respect to the nonzeros
+    Sparsity J = f_.jacSparsity(iind_, oind_, true, symmetric_);
+
+    // Seed directions by graph coloring
+    acyclic_ = symmetric_ && f_.getOption("symmetric_coloring")=="acyclic";
+    Sparsity D1, D2;
+    if (J.nnz()>0) f_->getPartition(iind_, oind_, D1, D2, true, symmetric_, acyclic_);
+    fwd_ = !D1.isNull() || D2.isNull();
+    seed_ = D1.isNull() ? D2 : D1;
+    int ndir = seed_.isNull() ? 0 : seed_.size2();
+
+    // Nonzeros of the inputs and outputs
+    nnz_in_.resize(f_.getNumInputs());
+    for (int i=0; i<nnz_in_.size(); ++i) nnz_in_[i] = f_.input(i).nnz();
+    nnz_out_.resize(f_.getNumOutputs());
+    for (int i=0; i<nnz_out_.size(); ++i) nnz_out_[i] = f_.output(i).nnz();
+    nnz_seed_ = fwd_ ? nnz_in_[iind_] : nnz_out_[oind_];
+    nnz_sens_ = fwd_ ? nnz_out_[oind_] : nnz_in_[iind_];
+    int nnz_max = 0;
+    for (int i=0; i<nnz_in_.size(); ++i) nnz_max = std::max(nnz_max, nnz_in_[i]);
+    for (int i=0; i<nnz_out_.size(); ++i) nnz_max = std::max(nnz_max, nnz_out_[i]);
+    zeros_.resize(nnz_max, 0);
+
+    // Which direction provides which nonzero of the Jacobian. Every nonzero is taken from
+    // exactly one direction, so the result does not depend on the order of the chunks.
+    // After an acyclic coloring, the nonzeros are taken like in forward mode and contain
+    // sums that are resolved by the substitutions below.
+    vector<int> mapping;
+    Sparsity JT = J.transpose(mapping);
+    vector<bool> assigned(J.nnz(), false);
+    vector<int> count(J.size1(), 0);
+    scatter_offset_.resize(1, 0);
+    scatter_sens_.clear();
+    scatter_jac_.clear();
+    for (int d=0; d<ndir; ++d) {
+      if (symmetric_ && !acyclic_) {
+        // Number of seeded columns contributing to each row
+        for (int el=seed_.colind(d); el<seed_.colind(d+1); ++el) {
+          int c = seed_.row(el);
+          for (int k=J.colind(c); k<J.colind(c+1); ++k) count[J.row(k)]++;
+        }
+
+        // A row with a single contribution gives an entry and its transpose
+        for (int el=seed_.colind(d); el<seed_.colind(d+1); ++el) {
+          int c = seed_.row(el);
+          for (int k=J.colind(c); k<J.colind(c+1); ++k) {
+            int r = J.row(k);
+            if (count[r]!=1) continue;
+            int e[] = {k, mapping[k]};
+            for (int i=0; i<2; ++i) {
+              if (assigned[e[i]]) continue;
+              assigned[e[i]] = true;
+              scatter_sens_.push_back(r);
+              scatter_jac_.push_back(e[i]);
+            }
+          }
+        }
+
+        // Reset the counters
+        for (int el=seed_.colind(d); el<seed_.colind(d+1); ++el) {
+          int c = seed_.row(el);
+          for (int k=J.colind(c); k<J.colind(c+1); ++k) count[J.row(k)] = 0;
+        }
+      } else if (fwd_) {
+        // Forward mode: a seeded input nonzero gives a column of the Jacobian
+        for (int el=seed_.colind(d); el<seed_.colind(d+1); ++el) {
+          int c = seed_.row(el);
+          for (int k=J.colind(c); k<J.colind(c+1); ++k) {
+            assigned[k] = true;
+            scatter_sens_.push_back(J.row(k));
+            scatter_jac_.push_back(k);
+          }
+        }
+      } else {
+        // Adjoint mode: a seeded output nonzero gives a row of the Jacobian
+        for (int el=seed_.colind(d); el<seed_.colind(d+1); ++el) {
+          int r = seed_.row(el);
+          for (int k=JT.colind(r); k<JT.colind(r+1); ++k) {
+            assigned[mapping[k]] = true;
+            scatter_sens_.push_back(JT.row(k));
+            scatter_jac_.push_back(mapping[k]);
+          }
+        }
+      }
+      scatter_offset_.push_back(scatter_sens_.size());
+    }
+    for (int k=0; k<assigned.size(); ++k) {
+      casadi_assert_message(assigned[k], "ColoredJacobian: Jacobian nonzero " << k
+                            << " not determined by the coloring");
+    }
+
+    // Substitutions after an acyclic coloring: the nonzero taken for (r, c) is the sum of
+    // the entries of row r in the columns with the color of c. The off-diagonal entries
+    // of a column are grouped by the color of their row, a group with a single unknown
+    // entry gives that entry. The groups are the leaves of the two-colored trees, so
+    // peeling them determines all entries if the coloring is acyclic.
+    subst_offset_.resize(1, 0);
+    subst_jac_.clear();
+    subst_mirror_.clear();
+    subst_dep_.clear();
+    if (acyclic_) {
+      // Color of each column
+      vector<int> color(J.size2(), -1);
+      for (int d=0; d<ndir; ++d) {
+        for (int el=seed_.colind(d); el<seed_.colind(d+1); ++el) color[seed_.row(el)] = d;
+      }
+
+      // Group of each off-diagonal nonzero
+      vector<int> group(J.nnz(), -1), group_size, last_group(ndir, -1), last_owner(ndir, -1);
+      for (int c=0; c<J.size2(); ++c) {
+        for (int k=J.colind(c); k<J.colind(c+1); ++k) {
+          if (J.row(k)==c) continue;
+          int b = color[J.row(k)];
+          if (last_owner[b]!=c) {
+            last_owner[b] = c;
+            last_group[b] = group_size.size();
+            group_size.push_back(0);
+          }
+          group[k] = last_group[b];
+          group_size[group[k]]++;
+        }
+      }
+
+      // Nonzeros of each group
+      int ngroup = group_size.size();
+      vector<int> group_offset(ngroup+1, 0);
+      for (int g=0; g<ngroup; ++g) group_offset[g+1] = group_offset[g] + group_size[g];
+      vector<int> group_nz(group_offset[ngroup]), pos(group_offset.begin(), group_offset.end()-1);
+      for (int k=0; k<J.nnz(); ++k) {
+        if (group[k]>=0) group_nz[pos[group[k]]++] = k;
+      }
+
+      // Peel the groups with a single unknown entry
+      vector<bool> known(J.nnz(), false);
+      vector<int> queue;
+      for (int g=0; g<ngroup; ++g) if (group_size[g]==1) queue.push_back(g);
+      for (int q=0; q<queue.size(); ++q) {
+        int g = queue[q];
+        if (group_size[g]!=1) continue;
+
+        // The unknown entry is the transpose of the nonzero holding the sum
+        int k = -1;
+        for (int i=group_offset[g]; i<group_offset[g+1]; ++i) {
+          if (!known[group_nz[i]]) k = group_nz[i];
+        }
+        subst_jac_.push_back(mapping[k]);
+        subst_mirror_.push_back(k);
+        for (int i=group_offset[g]; i<group_offset[g+1]; ++i) {
+          if (group_nz[i]!=k) subst_dep_.push_back(group_nz[i]);
+        }
+        subst_offset_.push_back(subst_dep_.size());
+        known[k] = known[mapping[k]] = true;
+
+        // The group of the transpose has one unknown entry less
+        group_size[g] = 0;
+        int g2 = group[mapping[k]];
+        if (--group_size[g2]==1) queue.push_back(g2);
+      }
+      for (int k=0; k<J.nnz(); ++k) {
+        casadi_assert_message(group[k]<0 || known[k], "ColoredJacobian: Jacobian nonzero " << k
+                              << " not determined, the coloring is not acyclic");
+      }
+    }
+
+    // Only the entries on and above the diagonal
+    Sparsity jac_sp = f_.jacSparsity(iind_, oind_, compact_, symmetric_);
+    if (getOption("triangular")) {
+      casadi_assert_message(symmetric_, "ColoredJacobian: \"triangular\" requires a symmetric "
+                            "Jacobian");
+      vector<int> jac_col = jac_sp.getCol();
+
+      // Nonzero of the triangular part holding each entry
+      vector<int> tri(J.nnz(), -1);
+      int ntri = 0;
+      for (int k=0; k<J.nnz(); ++k) {
+        if (jac_sp.row(k)<=jac_col[k]) tri[k] = ntri++;
+      }
+      for (int k=0; k<J.nnz(); ++k) {
+        if (tri[k]<0) tri[k] = tri[mapping[k]];
+      }
+
+      // Entries taken from the directions: the triangular part, or after an acyclic
+      // coloring the diagonal and the sums needed by the substitutions
+      vector<bool> keep(J.nnz(), !acyclic_);
+      if (acyclic_) {
+        for (int c=0; c<J.size2(); ++c) {
+          for (int k=J.colind(c); k<J.colind(c+1); ++k) keep[k] = J.row(k)==c;
+        }
+        for (int i=0; i<subst_jac_.size(); ++i) keep[subst_jac_[i]] = true;
+      } else {
+        for (int k=0; k<J.nnz(); ++k) keep[k] = jac_sp.row(k)<=jac_col[k];
+      }
+      int nz = 0;
+      for (int d=0; d<ndir; ++d) {
+        int start = nz;
+        for (int i=scatter_offset_[d]; i<scatter_offset_[d+1]; ++i) {
+          if (!keep[scatter_jac_[i]]) continue;
+          scatter_sens_[nz] = scatter_sens_[i];
+          scatter_jac_[nz++] = tri[scatter_jac_[i]];
+        }
+        scatter_offset_[d] = start;
+      }
+      scatter_offset_[ndir] = nz;
+      scatter_sens_.resize(nz);
+      scatter_jac_.resize(nz);
+
+      // Substitutions in the triangular part
+      for (int i=0; i<subst_jac_.size(); ++i) {
+        subst_jac_[i] = tri[subst_jac_[i]];
+        subst_mirror_[i] = tri[subst_mirror_[i]];
+      }
+      for (int i=0; i<subst_dep_.size(); ++i) subst_dep_[i] = tri[subst_dep_[i]];
+
+      jac_sp = jac_sp.zz_triu();
+      casadi_assert(jac_sp.nnz()==ntri);
+    }
+
+    // Split the directions into chunks
+    chunk_size_ = getOption("chunk_size");
+    casadi_assert_message(chunk_size_>=0, "ColoredJacobian: \"chunk_size\" must be nonnegative");
+    if (chunk_size_==0) {
+      chunk_size_ = std::min((ndir+num_threads_-1)/num_threads_, optimized_num_dir);
+    }
+    chunk_size_ = std::max(1, std::min(chunk_size_, ndir));
+    nchunk_ = (ndir+chunk_size_-1)/chunk_size_;
+
+    // Derivative functions
+    der_ = der_last_ = Function();
+    size_t f_ni, f_nr, der_ni=0;
+    f_.nTmp(f_ni, f_nr);
+    der_nr_ = 0;
+    if (nchunk_>0) {
+      der_ = fwd_ ? f_.derForward(chunk_size_) : f_.derReverse(chunk_size_);
+      int last = ndir - (nchunk_-1)*chunk_size_;
+      der_last_ = last==chunk_size_ ? der_ : fwd_ ? f_.derForward(last) : f_.derReverse(last);
+      size_t ni, nr;
+      der_.nTmp(ni, nr);
+      der_ni = std::max(der_ni, ni);
+      der_nr_ = std::max(der_nr_, nr);
+      der_last_.nTmp(ni, nr);
+      der_ni = std::max(der_ni, ni);
+      der_nr_ = std::max(der_nr_, nr);
+    }
+
+    // Threads need re-entrant derivative functions and C++11
+    if (mode_==THREADS) {
+#ifdef USE_CXX11
+      if (nchunk_>0 && !(der_.isReentrant() && der_last_.isReentrant())) {
+        casadi_warning("ColoredJacobian: the derivative functions are not re-entrant, "
+                       "switching to serial mode.");
+        mode_ = SERIAL;
+      }
+#else // USE_CXX11
+      casadi_warning("Thread parallelization is not available, switching to serial mode. "
+                     "Recompile CasADi with a C++11 compiler.");
+      mode_ = SERIAL;
+#endif // USE_CXX11
+    }
+    if (mode_==SERIAL) num_threads_ = 1;
+    num_threads_ = std::max(1, std::min(num_threads_, nchunk_));
+
+    // Work vector per worker: evaluation, then seeds and sensitivities of a chunk
+    work_ni_ = std::max(f_ni, der_ni);
+    work_nr_ = std::max(f_nr, der_nr_) + chunk_size_*(nnz_seed_+nnz_sens_);
+
+    // Inputs are those of the function, outputs are the Jacobian and those of the function
+    setNumInputs(f_.getNumInputs());
+    for (int i=0; i<getNumInputs(); ++i) {
+      input(i) = DMatrix::zeros(f_.input(i).sparsity());
+    }
+    setNumOutputs(1+f_.getNumOutputs());
+    output(0) = DMatrix::zeros(jac_sp);
+    for (int i=0; i<f_.getNumOutputs(); ++i) {
+      output(1+i) = DMatrix::zeros(f_.output(i).sparsity());
+    }
+
+    // Arguments of the derivative functions, reserved for a full chunk
+    der_arg_.clear();
+    der_res_.clear();
+    if (mode_==THREADS) {
+      int n_seed = fwd_ ? nnz_in_.size() : nnz_out_.size();
+      int n_sens = fwd_ ? nnz_out_.size() : nnz_in_.size();
+      der_arg_.resize(num_threads_);
+      der_res_.resize(num_threads_);
+      for (int w=0; w<num_threads_; ++w) {
+        der_arg_[w].reserve(nnz_in_.size() + nnz_out_.size() + chunk_size_*n_seed);
+        der_res_[w].reserve(chunk_size_*n_sens);
+      }
+    }
+
+    // The symbolic Jacobian is created on first use
+    sym_ = Function();
+
+    // (Re)start the thread pool
+    pool_.reset(mode_==THREADS ? num_threads_ : 0);
+
+    // Call the init function of the base class
+    FunctionInternal::init();
+  }
+
+  void ColoredJacobianInternal::nTmp(size_t& ni, size_t& nr) {
+    // Nondifferentiated outputs, then one work vector per worker
+    ni = work_ni_*num_threads_;
+    nr = work_nr_*num_threads_;
+    for (int i=0; i<nnz_out_.size(); ++i) nr += nnz_out_[i];
+  }
+
+  bool ColoredJacobianInternal::isReentrant() const {
+    // The thread pool serves one call at a time
+    return mode_!=THREADS && f_.isReentrant() &&
+      (der_.isNull() || (der_.isReentrant() && der_last_.isReentrant()));
+  }
+
+  void ColoredJacobianInternal::evalD(const cpv_double& arg, const pv_double& res,
+                                      int* itmp, double* rtmp) {
+    int n_in = nnz_in_.size(), n_out = nnz_out_.size();
+
+    // Inputs, zero if not given
+    cpv_double f_arg(arg.begin(), arg.begin()+n_in);
+    for (int i=0; i<n_in; ++i) if (f_arg[i]==0) f_arg[i] = getPtr(zeros_);
+
+    // Evaluate the function, the derivative functions need the nondifferentiated outputs
+    double* w = rtmp + work_nr_*num_threads_;
+    pv_double f_res(n_out);
+    for (int i=0; i<n_out; ++i) {
+      f_res[i] = w;
+      w += nnz_out_[i];
+    }
+    f_->evalD(f_arg, f_res, itmp, rtmp);
+    for (int i=0; i<n_out; ++i) {
+      if (res[1+i]!=0) copy(f_res[i], f_res[i]+nnz_out_[i], res[1+i]);
+    }
+
+    // Quick return if the Jacobian is not needed
+    if (res[0]==0) return;
+    cpv_double f_res_c(f_res.begin(), f_res.end());
+
+    if (mode_==SERIAL) {
+      // Evaluate one chunk after the other in the same work vector
+      cpv_double der_arg;
+      pv_double der_res;
+      for (int c=0; c<nchunk_; ++c) {
+        evalChunk(c, f_arg, f_res_c, res[0], itmp, rtmp, der_arg, der_res);
+      }
+    } else if (mode_==THREADS) {
+#ifdef USE_CXX11
+      ColoredJacobianJob job(this, f_arg, f_res_c, res[0], itmp, rtmp);
+      vector<double> task_cputime(nchunk_, 1);
+      vector<int> task_allocation;
+      int n_stolen;
+      pool_->run(job, task_cputime, task_allocation, n_stolen);
+      if (gather_stats_) {
+        stats_["num_threads"] = pool_->size();
+        stats_["task_allocation"] = task_allocation;
+        stats_["task_cputime"] = task_cputime;
+        stats_["n_stolen"] = n_stolen;
+      }
+#endif // USE_CXX11
+    }
+
+    // Substitutions after an acyclic coloring
+    double* jac = res[0];
+    for (int i=0; i<subst_jac_.size(); ++i) {
+      double v = jac[subst_jac_[i]];
+      for (int k=subst_offset_[i]; k<subst_offset_[i+1]; ++k) v -= jac[subst_dep_[k]];
+      jac[subst_jac_[i]] = jac[subst_mirror_[i]] = v;
+    }
+  }
+
+  void ColoredJacobianInternal::evalChunk(int c, const cpv_double& arg, const cpv_double& f_res,
+                                          double* jac, int* itmp, double* rtmp,
+                                          cpv_double& der_arg, pv_double& der_res) {
+    int n_in = nnz_in_.size(), n_out = nnz_out_.size();
+
+    // Directions of the chunk
+    int d0 = c*chunk_size_;
+    int nd = std::min(chunk_size_, seed_.size2()-d0);
+    Function& der = nd==chunk_size_ ? der_ : der_last_;
+
+    // Seeds and sensitivities, after the work vector of the derivative function
+    double* seed = rtmp + der_nr_;
+    double* sens = seed + chunk_size_*nnz_seed_;
+    fill_n(seed, nd*nnz_seed_, 0);
+    for (int d=0; d<nd; ++d) {
+      for (int el=seed_.colind(d0+d); el<seed_.colind(d0+d+1); ++el) {
+        seed[d*nnz_seed_ + seed_.row(el)] = 1;
+      }
+    }
+
+    // Nondifferentiated inputs and outputs, then the seeds, one direction at a time
+    int n_seed = fwd_ ? n_in : n_out, n_sens = fwd_ ? n_out : n_in;
+    int ind_seed = fwd_ ? iind_ : oind_, ind_sens = fwd_ ? oind_ : iind_;
+    der_arg.assign(arg.begin(), arg.end());
+    der_arg.insert(der_arg.end(), f_res.begin(), f_res.end());
+    der_res.assign(nd*n_sens, static_cast<double*>(0));
+    for (int d=0; d<nd; ++d) {
+      for (int i=0; i<n_seed; ++i) {
+        der_arg.push_back(i==ind_seed ? seed + d*nnz_seed_ : getPtr(zeros_));
+      }
+      der_res[d*n_sens + ind_sens] = sens + d*nnz_sens_;
+    }
+
+    // Evaluate the directional derivatives
+    der->evalD(der_arg, der_res, itmp, rtmp);
+
+    // Scatter into the Jacobian
+    for (int d=0; d<nd; ++d) {
+      const double* sens_d = sens + d*nnz_sens_;
+      for (int k=scatter_offset_[d0+d]; k<scatter_offset_[d0+d+1]; ++k) {
+        jac[scatter_jac_[k]] = sens_d[scatter_sens_[k]];
+      }
+    }
+  }
+
+  void ColoredJacobianInternal::deepCopyMembers(
+      std::map<SharedObjectNode*, SharedObject>& already_copied) {
+    FunctionInternal::deepCopyMembers(already_copied);
+    f_ = deepcopy(f_, already_copied);
+    der_ = deepcopy(der_, already_copied);
+    der_last_ = deepcopy(der_last_, already_copied);
+    sym_ = deepcopy(sym_, already_copied);
+  }
+
+  Function& ColoredJacobianInternal::symbolic() {
+    if (sym_.isNull()) {
+      sym_ = f_->getJacobian(iind_, oind_, compact_, symmetric_);
+      sym_.init();
+
+      // Only the entries on and above the diagonal
+      if (sym_.output(0).sparsity()!=output(0).sparsity()) {
+        vector<MX> arg = symbolicInput();
+        vector<MX> res = sym_(arg);
+        res[0] = res[0].setSparse(output(0).sparsity());
+        sym_ = MXFunction(arg, res);
+        sym_.init();
+      }
+    }
+    return sym_;
+  }
+
+  void ColoredJacobianInternal::evalSX(const std::vector<SX>& arg, std::vector<SX>& res) {
+    symbolic()->evalSX(arg, res);
+  }
+
+  void ColoredJacobianInternal::spEvaluate(bool fwd) {
+    Function& sym = symbolic();
+
+    // Pass the seeds, propagate and collect the sensitivities
+    for (int i=0; i<getNumInputs(); ++i) copyBvec(input(i), sym.input(i));
+    for (int i=0; i<getNumOutputs(); ++i) copyBvec(output(i), sym.output(i));
+    sym.spInit(fwd);
+    sym.spEvaluate(fwd);
+    for (int i=0; i<getNumInputs(); ++i) copyBvec(sym.input(i), input(i));
+    for (int i=0; i<getNumOutputs(); ++i) copyBvec(sym.output(i), output(i));
+  }
+
+  Function ColoredJacobianInternal::getDerForward(int nfwd) {
+    return symbolic().derForward(nfwd);
+  }
+
+  Function ColoredJacobianInternal::getDerReverse(int nadj) {
+    return symbolic().derReverse(nadj);
+  }
+
+  void ColoredJacobianInternal::print(std::ostream &stream) const {
+    stream << "ColoredJacobian(" << f_.getOption("name") << ", " << iind_ << ", " << oind_
+           << ")";
+  }
+
+} // namespace casadi
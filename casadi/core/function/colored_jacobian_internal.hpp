@@ -0,0 +1,161 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_COLORED_JACOBIAN_INTERNAL_HPP
+#define CASADI_COLORED_JACOBIAN_INTERNAL_HPP
+
+#include "colored_jacobian.hpp"
+#include "function_internal.hpp"
+#include "thread_pool.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief  Internal node class for ColoredJacobian */
+  class CASADI_EXPORT ColoredJacobianInternal : public FunctionInternal {
+    friend class ColoredJacobian;
+
+  protected:
+    /// Constructor
+    ColoredJacobianInternal(const Function& f, int iind, int oind, bool compact, bool symmetric);
+
+  public:
+    /// Clone
+    virtual ColoredJacobianInternal* clone() const { return new ColoredJacobianInternal(*this);}
+
+    /// Destructor
+    virtual ~ColoredJacobianInternal();
+
+    /// Initialize
+    virtual void init();
+
+    /// Evaluate numerically, work vectors given
+    virtual void evalD(const cpv_double& arg, const pv_double& res, int* itmp, double* rtmp);
+
+    /// Can evalD be called concurrently, given separate work vectors?
+    virtual bool isReentrant() const;
+
+    /// Get number of temporary variables needed
+    virtual void nTmp(size_t& ni, size_t& nr);
+
+    /** \brief Evaluate the directional derivatives of chunk \a c and scatter them into the
+        Jacobian, \a der_arg and \a der_res are reused for the arguments of the derivative
+        function */
+    void evalChunk(int c, const cpv_double& arg, const cpv_double& f_res, double* jac,
+                   int* itmp, double* rtmp, cpv_double& der_arg, pv_double& der_res);
+
+    /// Evaluate symbolically, SX type
+    virtual void evalSX(const std::vector<SX>& arg, std::vector<SX>& res);
+
+    /// Propagate sparsity through the symbolic Jacobian
+    virtual bool spCanEvaluate(bool fwd) { return true;}
+
+    /// Propagate sparsity through the symbolic Jacobian
+    virtual void spEvaluate(bool fwd);
+
+    /// Derivatives of the symbolic Jacobian
+    virtual Function getDerForward(int nfwd);
+    virtual bool hasDerForward() const { return true;}
+    virtual Function getDerReverse(int nadj);
+    virtual bool hasDerReverse() const { return true;}
+
+    /// Symbolic Jacobian with the same inputs and outputs, created on first use
+    Function& symbolic();
+
+    /// Deep copy data members
+    virtual void deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied);
+
+    /// Print description
+    virtual void print(std::ostream &stream) const;
+
+    /// Differentiated function
+    Function f_;
+
+    /// Differentiated input and output
+    int iind_, oind_;
+
+    /// Jacobian with respect to nonzeros, symmetric Jacobian
+    bool compact_, symmetric_;
+
+    /// Acyclic coloring of a symmetric Jacobian, recovery by substitution
+    bool acyclic_;
+
+    /// Evaluation strategies
+    enum Mode {SERIAL, THREADS};
+
+    /// Evaluation strategy
+    Mode mode_;
+
+    /// Number of worker threads
+    int num_threads_;
+
+    /// Thread pool, THREADS mode only
+    OwnedThreadPool pool_;
+
+    /// Forward or adjoint directional derivatives
+    bool fwd_;
+
+    /// Seed matrix: the seed nonzeros of each direction
+    Sparsity seed_;
+
+    /// Number of directions per chunk and number of chunks
+    int chunk_size_, nchunk_;
+
+    /// Derivative functions for a full and for the last chunk
+    Function der_, der_last_;
+
+    /// Symbolic Jacobian, for symbolic evaluation, sparsity propagation and derivatives
+    Function sym_;
+
+    /// Arguments of the derivative functions per worker, THREADS mode only
+    std::vector<cpv_double> der_arg_;
+    std::vector<pv_double> der_res_;
+
+    /// For each direction, the sensitivity nonzeros taken and the Jacobian nonzeros they give
+    std::vector<int> scatter_offset_, scatter_sens_, scatter_jac_;
+
+    /** \brief Substitutions after an acyclic coloring, in order: the Jacobian nonzero
+        subst_jac_[i], minus the nonzeros subst_dep_[subst_offset_[i]...subst_offset_[i+1]-1],
+        is the value of subst_jac_[i] and of its transpose subst_mirror_[i] */
+    std::vector<int> subst_offset_, subst_jac_, subst_mirror_, subst_dep_;
+
+    /// Nonzeros of each input and output of the differentiated function
+    std::vector<int> nnz_in_, nnz_out_;
+
+    /// Nonzeros of the seeds and sensitivities
+    int nnz_seed_, nnz_sens_;
+
+    /// Zeros, passed for inputs without seeds
+    std::vector<double> zeros_;
+
+    /// Work vector sizes per worker
+    size_t work_ni_, work_nr_, der_nr_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_COLORED_JACOBIAN_INTERNAL_HPP
@@ -30,6 +30,7 @@
 #include "../std_vector_tools.hpp"
 #include "../matrix/matrix_tools.hpp"
 #include "parallelizer.hpp"
+#include "map.hpp"
 
 using namespace std;
 
@@ -76,6 +77,14 @@ namespace casadi {
     (*this)->call(arg, res, always_inline, never_inline);
   }
 
+  Function Function::map(int n, const Dictionary& opts) {
+    assertInit();
+    Map ret(*this, n);
+    ret.setOption(opts);
+    ret.init();
+    return ret;
+  }
+
   vector<vector<MX> > Function::callParallel(const vector<vector<MX> > &x,
                                              const Dictionary& paropt) {
     assertInit();
@@ -128,6 +137,36 @@ namespace casadi {
     (*this)->evaluate();
   }
 
+  void Function::nTmp(size_t& ni, size_t& nr) {
+    assertInit();
+    (*this)->nTmp(ni, nr);
+  }
+
+  void Function::evalD(const std::vector<const double*>& arg, const std::vector<double*>& res,
+                       int* itmp, double* rtmp) {
+    assertInit();
+    casadi_assert_message(arg.size()==getNumInputs(),
+                          "Function::evalD: Expected " << getNumInputs() << " inputs, got "
+                          << arg.size() << ".");
+    casadi_assert_message(res.size()==getNumOutputs(),
+                          "Function::evalD: Expected " << getNumOutputs() << " outputs, got "
+                          << res.size() << ".");
+    (*this)->evalD(arg, res, itmp, rtmp);
+  }
+
+  bool Function::isReentrant() const {
+    return (*this)->isReentrant();
+  }
+
+  void Function::evaluateInto(const std::vector<double*>& res,
+                              const std::vector<const std::vector<int>*>& perm) {
+    assertInit();
+    casadi_assert_message(res.size()==getNumOutputs(),
+                          "Function::evaluateInto: Expected " << getNumOutputs()
+                          << " outputs, got " << res.size() << ".");
+    (*this)->evaluateInto(res, perm);
+  }
+
   int Function::getNumInputNonzeros() const {
     return (*this)->getNumInputNonzeros();
   }
@@ -174,6 +174,40 @@ namespace casadi {
     /** \brief  Evaluate */
     void evaluate();
 
+#ifndef SWIG
+    /// \cond INTERNAL
+    /** \brief Get the size of the work vectors needed by evalD */
+    void nTmp(size_t& ni, size_t& nr);
+
+    /** \brief Evaluate numerically with caller-owned memory
+     *
+     * \a arg and \a res hold pointers to the nonzeros of the inputs and outputs (null pointers
+     * allowed for outputs), \a itmp and \a rtmp point to work vectors of at least the
+     * sizes returned by nTmp. The input and output members of the function are not touched.
+     * If isReentrant() returns true, several threads may call this concurrently,
+     * each with its own work vectors.
+     */
+    void evalD(const std::vector<const double*>& arg, const std::vector<double*>& res,
+               int* itmp, double* rtmp);
+
+    /** \brief Can evalD be called concurrently with separate work vectors? */
+    bool isReentrant() const;
+
+    /** \brief Evaluate, writing the outputs to external memory
+     *
+     * The inputs are taken from the input members. The nonzeros of output \a i are written
+     * to \a res[i], if not null, instead of to the output member, e.g. directly into the
+     * memory of a solver. If \a perm is given and \a perm[i] is not null, nonzero \a k
+     * of output \a i is written to \a res[i][(*perm[i])[k]] instead, e.g. to scatter into
+     * a dense matrix. SXFunction writes such outputs there directly, other functions
+     * scatter them from the output member.
+     */
+    void evaluateInto(const std::vector<double*>& res,
+                      const std::vector<const std::vector<int>*>& perm
+                      = std::vector<const std::vector<int>*>());
+    /// \endcond
+#endif // SWIG
+
     ///@{
     /** \brief Generate a Jacobian function of output \a oind with respect to input \a iind
      * \param iind The index of the input
@@ -377,6 +411,12 @@ namespace casadi {
     std::vector<std::vector<MX> > callParallel(const std::vector<std::vector<MX> > &arg,
                                                const Dictionary& paropt=Dictionary());
 
+    /** \brief  Create a function that evaluates this function for \a n sets of arguments
+        The inputs and outputs are horizontal concatenations, see Map.
+        \param opts Set of options to be passed to the Map
+    */
+    Function map(int n, const Dictionary& opts=Dictionary());
+
     /** \brief Get a function that calculates \a nfwd forward derivatives and nadj adjoint derivatives
      *         Legacy function: Use derForward and derReverse instead.
      *
@@ -32,19 +32,97 @@
 #include "../sx/sx_tools.hpp"
 #include "../mx/mx_tools.hpp"
 #include "external_function.hpp"
+#include "thread_pool.hpp"
+#include "colored_jacobian.hpp"
 
 #include "../casadi_options.hpp"
 #include "../profiling.hpp"
 
 #include <cctype>
+#include <deque>
 #ifdef WITH_DL
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
+#include <sstream>
+#include <cerrno>
+#ifdef _WIN32
+#include <process.h>
+#include <direct.h>
+#define getpid _getpid
+#else // _WIN32
+#include <unistd.h>
+#include <sys/stat.h>
+#endif // _WIN32
+#ifdef USE_CXX11
+#include <atomic>
+#endif // USE_CXX11
 #endif // WITH_DL
 
+// Heap allocations are counted in debug builds
+#if !defined(NDEBUG) && defined(USE_CXX11)
+#define CASADI_COUNT_ALLOC
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#endif // !defined(NDEBUG) && defined(USE_CXX11)
+
 using namespace std;
 
+#ifdef CASADI_COUNT_ALLOC
+namespace casadi {
+  namespace {
+    // Number of heap allocations of the process so far
+    std::atomic<long> n_heap_alloc(0);
+  } // namespace
+} // namespace casadi
+
+// Replacements of the global allocation functions that count the allocations,
+// the array and nothrow forms call these
+CASADI_EXPORT void* operator new(std::size_t size) {
+  ++casadi::n_heap_alloc;
+  void* ptr = std::malloc(size==0 ? 1 : size);
+  if (ptr==0) throw std::bad_alloc();
+  return ptr;
+}
+
+CASADI_EXPORT void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+#endif // CASADI_COUNT_ALLOC
+
 namespace casadi {
+  namespace {
+    /* Pointer arrays for evaluations in work vectors owned by the caller: one pair per
+       nesting level of such calls on the current thread. A deque, so that adding a
+       level leaves the arrays of the enclosing levels in place. */
+    struct EvalPointers {
+      deque<pair<cpv_double, pv_double> > level;
+      size_t depth;
+    };
+#ifdef USE_CXX11
+    thread_local EvalPointers eval_pointers = EvalPointers();
+#else // USE_CXX11
+    // No worker threads without C++11
+    EvalPointers eval_pointers = EvalPointers();
+#endif // USE_CXX11
+  } // namespace
+
+  EvalPointersScope::EvalPointersScope(size_t max_arg, size_t max_res) {
+    if (eval_pointers.depth==eval_pointers.level.size()) {
+      eval_pointers.level.push_back(pair<cpv_double, pv_double>());
+    }
+    pair<cpv_double, pv_double>& p = eval_pointers.level[eval_pointers.depth++];
+    if (p.first.size()<max_arg) p.first.resize(max_arg);
+    if (p.second.size()<max_res) p.second.resize(max_res);
+    arg = &p.first;
+    res = &p.second;
+  }
+
+  EvalPointersScope::~EvalPointersScope() {
+    eval_pointers.depth--;
+  }
+
   FunctionInternal::FunctionInternal() {
     setOption("name", "unnamed_function"); // name of the function
     addOption("verbose",                  OT_BOOLEAN,             false,
@@ -62,6 +140,32 @@ namespace casadi {
               "Weighting factor for sparsity pattern calculation calculation."
               "Overrides default behavior. Set to 0 and 1 to force forward and "
               "reverse mode respectively. Cf. option \"ad_weight\".");
+    addOption("sp_words",                 OT_INTEGER,             GenericType(),
+              "Number of 64-bit words propagated per nonzero in sparsity pattern calculation, "
+              "i.e. the number of seed directions per sweep divided by 64. Defaults to 4 for "
+              "functions that can propagate several words in one pass, otherwise 1.");
+    addOption("jac_num_threads",          OT_INTEGER,             1,
+              "Number of threads evaluating the directional derivatives of the Jacobians "
+              "created with jacobian(). Other values than 1 give a ColoredJacobian, which "
+              "evaluates chunks of the colored seed directions on a thread pool, 0 for the "
+              "number of available cores. Also used for the Hessian of the Lagrangian in "
+              "NLP solvers.");
+    addOption("coloring_ordering",        OT_STRING,              "default",
+              "Order in which the graph coloring visits the columns when computing the seed "
+              "directions of a Jacobian. The default is the natural order for unsymmetric and "
+              "largest first for symmetric Jacobians.",
+              "default|none|largest_first|smallest_last|incidence_degree");
+    addOption("coloring_recolor",         OT_INTEGER,             0,
+              "Number of iterated greedy recoloring passes after the coloring of an "
+              "unsymmetric Jacobian. A pass never increases the number of colors.");
+    addOption("symmetric_coloring",       OT_STRING,              "star",
+              "Coloring of symmetric Jacobians (Hessians). An acyclic coloring needs fewer "
+              "directions than a star coloring, but the entries are recovered by substitution, "
+              "hence jacobian() returns a ColoredJacobian.", "star|acyclic");
+    addOption("sp_threads",               OT_INTEGER,             1,
+              "Number of threads performing the sweeps of the hierarchical sparsity pattern "
+              "calculation, 0 for the number of available cores. Only used for functions "
+              "that can propagate several words in one pass.");
     //addOption("ad_mode",                  OT_STRING,              "automatic",
     //          "Deprecated option, use \"ad_weight\" instead. Ignored.");
     addOption("user_data",                OT_VOIDPTR,             GenericType(),
@@ -75,6 +179,12 @@ namespace casadi {
               "Throw exceptions when the numerical values of the inputs don't make sense");
     addOption("gather_stats",             OT_BOOLEAN,             false,
               "Flag to indicate whether statistics must be gathered");
+    addOption("codegen_reentrant",        OT_BOOLEAN,             false,
+              "Place the work vectors of the generated evaluateWrap and evaluate wrappers "
+              "on the stack rather than in static memory, making them safe to call from "
+              "multiple threads. The exported eval and evalBatch always take the work "
+              "vectors from the caller, with sizes given by nwork. evalBatch calls eval "
+              "for one set of inputs after the other, it is not vectorized.");
     addOption("custom_forward",  OT_DERIVATIVEGENERATOR,   GenericType(),
               "Function that returns a derivative function given a number of forward "
               "mode directional derivatives. Overrides default routines.");
@@ -86,6 +196,10 @@ namespace casadi {
 
     verbose_ = false;
     user_data_ = 0;
+    n_realloc_work_ = 0;
+    n_alloc_eval_ = 0;
+    n_compile_cache_hit_ = n_compile_cache_miss_ = 0;
+    n_sp_sweeps_ = 0;
     monitor_inputs_ = false;
     monitor_outputs_ = false;
   }
@@ -97,11 +211,18 @@ namespace casadi {
   void FunctionInternal::deepCopyMembers(
       std::map<SharedObjectNode*, SharedObject>& already_copied) {
     OptionsFunctionalityNode::deepCopyMembers(already_copied);
+    // Cached derivatives that have not been copied (yet) are dropped, not shared
     for (vector<WeakRef>::iterator j=derivative_fwd_.begin(); j!=derivative_fwd_.end(); ++j) {
-      if (!j->isNull()) *j = getcopy(j->shared(), already_copied);
+      if (!j->isNull()) {
+        SharedObject der = getcopy(j->shared(), already_copied);
+        *j = der.isNull() ? WeakRef() : WeakRef(der);
+      }
     }
     for (vector<WeakRef>::iterator j=derivative_adj_.begin(); j!=derivative_adj_.end(); ++j) {
-      if (!j->isNull()) *j = getcopy(j->shared(), already_copied);
+      if (!j->isNull()) {
+        SharedObject der = getcopy(j->shared(), already_copied);
+        *j = der.isNull() ? WeakRef() : WeakRef(der);
+      }
     }
 
 
@@ -419,6 +540,131 @@ namespace casadi {
     r = 0;
     for (int i=begin; i<end; ++i) r |= s[i];
   }
+
+  void bvec_toggle(bvec_t* s, int begin, int end, int j, int nw) {
+    for (int i=begin; i<end; ++i) {
+      s[i*nw + j/bvec_size] ^= (bvec_t(1) << (j%bvec_size));
+    }
+  }
+
+  bool bvec_or(const bvec_t* s, bvec_t* r, int begin, int end, int nw) {
+    fill_n(r, nw, bvec_t(0));
+    for (int i=begin; i<end; ++i) {
+      for (int k=0; k<nw; ++k) r[k] |= s[i*nw+k];
+    }
+    for (int k=0; k<nw; ++k) if (r[k]) return true;
+    return false;
+  }
+
+  /// Seeds, lookup table and result of one sweep of the hierarchical sparsity detection
+  struct SpSweep {
+    // Seed direction seed_dir[i] is set for the seed nonzeros [seed_begin[i], seed_end[i])
+    std::vector<int> seed_begin, seed_end, seed_dir;
+
+    // Offset from the seed direction to the fine seed block, per coarse sensitivity block
+    IMatrix lookup;
+
+    // Dependencies found
+    std::vector<int> jrow, jcol;
+  };
+
+  /// Performs the planned sweeps of one level of the hierarchical sparsity detection
+  class SpSweepEvaluator {
+  public:
+    SpSweepEvaluator(FunctionInternal* f, bool fwd, int iind, int oind, int nw,
+                     int n_workers, const std::vector<int>& coarse_col,
+                     const std::vector<int>& fine_col, const std::vector<int>& fine_col_lookup,
+                     std::vector<SpSweep>& sweeps)
+      : f_(f), fwd_(fwd), iind_(iind), oind_(oind), nw_(nw), coarse_col_(coarse_col),
+        fine_col_(fine_col), fine_col_lookup_(fine_col_lookup), sweeps_(sweeps) {
+      // Every worker has its own seeds, sensitivities and work vectors
+      int nz_seed = fwd ? f->input(iind).nnz() : f->output(oind).nnz();
+      int nz_sens = fwd ? f->output(oind).nnz() : f->input(iind).nnz();
+      seed_.resize(n_workers, vector<bvec_t>(nz_seed*nw, 0));
+      sens_.resize(n_workers, vector<bvec_t>(nz_sens*nw, 0));
+      w_.resize(n_workers, vector<bvec_t>(f->rtmp_.size()*nw, 0));
+      spsens_.resize(n_workers, vector<bvec_t>(nw, 0));
+      lookup_dense_.resize(n_workers, vector<int>(nw*bvec_size, 0));
+    }
+
+    /// Perform sweep s on a given worker
+    void evaluate(int s, int worker) {
+      SpSweep& sw = sweeps_[s];
+      bvec_t* seed = getPtr(seed_[worker]);
+      bvec_t* sens = getPtr(sens_[worker]);
+      bvec_t* spsens = getPtr(spsens_[worker]);
+      int* lookup_dense = getPtr(lookup_dense_[worker]);
+
+      // Toggle on seeds
+      for (int i=0; i<sw.seed_dir.size(); ++i) {
+        bvec_toggle(seed, sw.seed_begin[i], sw.seed_end[i], sw.seed_dir[i], nw_);
+      }
+
+      // Propagate the dependencies
+      f_->spEvaluateWide(fwd_, iind_, oind_, seed, sens, nw_, getPtr(w_[worker]));
+
+      // Loop over the cols of coarse blocks
+      const IMatrix& lookup = sw.lookup;
+      for (int cri=0; cri<coarse_col_.size()-1; ++cri) {
+
+        // Scatter the column of the lookup table
+        for (int el=lookup.colind(cri); el<lookup.colind(cri+1); ++el) {
+          lookup_dense[lookup.row(el)] = lookup.data()[el];
+        }
+
+        // Loop over the cols of fine blocks within the current coarse block
+        for (int fri=fine_col_lookup_[coarse_col_[cri]];
+             fri<fine_col_lookup_[coarse_col_[cri+1]]; ++fri) {
+          // Lump individual sensitivities together into fine block,
+          // next iteration if no sparsity
+          if (!bvec_or(sens, spsens, fine_col_[fri], fine_col_[fri+1], nw_)) continue;
+
+          // Loop over all bvec_bits
+          for (int k=0; k<nw_; ++k) {
+            if (!spsens[k]) continue;
+            for (int i=0; i<bvec_size; ++i) {
+              if (spsens[k] & (bvec_t(1) << i)) {
+                // if dependency is found, add it to the new sparsity pattern
+                int bvec_i = i + k*bvec_size;
+                sw.jrow.push_back(bvec_i+lookup_dense[bvec_i]);
+                sw.jcol.push_back(fri);
+              }
+            }
+          }
+        }
+
+        // Restore the dense lookup table
+        for (int el=lookup.colind(cri); el<lookup.colind(cri+1); ++el) {
+          lookup_dense[lookup.row(el)] = 0;
+        }
+      }
+
+      // Toggle off seeds, ready for next sweep
+      for (int i=0; i<sw.seed_dir.size(); ++i) {
+        bvec_toggle(seed, sw.seed_begin[i], sw.seed_end[i], sw.seed_dir[i], nw_);
+      }
+    }
+
+  private:
+    FunctionInternal* f_;
+    bool fwd_;
+    int iind_, oind_, nw_;
+    const std::vector<int> &coarse_col_, &fine_col_, &fine_col_lookup_;
+    std::vector<SpSweep>& sweeps_;
+    std::vector<std::vector<bvec_t> > seed_, sens_, w_, spsens_;
+    std::vector<std::vector<int> > lookup_dense_;
+  };
+
+#ifdef USE_CXX11
+  /// The sweeps of the hierarchical sparsity detection, for the thread pool
+  class SpSweepJob : public ThreadPool::Job {
+  public:
+    explicit SpSweepJob(SpSweepEvaluator& e) : e_(e) {}
+    virtual void evaluateTask(int task, int worker) { e_.evaluate(task, worker);}
+  private:
+    SpSweepEvaluator& e_;
+  };
+#endif // USE_CXX11
   /// \endcond
 
   Sparsity FunctionInternal::getJacSparsityPlain(int iind, int oind) {
@@ -428,13 +674,17 @@ namespace casadi {
     // Number of nonzero outputs
     int nz_out = output(oind).nnz();
 
+    // Number of words per nonzero and number of directions per sweep
+    int nw = spWords();
+    int ndir = nw*bvec_size;
+
     // Number of forward sweeps we must make
-    int nsweep_fwd = nz_in/bvec_size;
-    if (nz_in%bvec_size>0) nsweep_fwd++;
+    int nsweep_fwd = nz_in/ndir;
+    if (nz_in%ndir>0) nsweep_fwd++;
 
     // Number of adjoint sweeps we must make
-    int nsweep_adj = nz_out/bvec_size;
-    if (nz_out%bvec_size>0) nsweep_adj++;
+    int nsweep_adj = nz_out/ndir;
+    if (nz_out%ndir>0) nsweep_adj++;
 
     // Get weighting factor
     double w = adWeightSp();
@@ -457,12 +707,6 @@ namespace casadi {
       if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
     }
 
-    // Get seeds and sensitivities
-    bvec_t* input_v = get_bvec_t(inputNoCheck(iind).data());
-    bvec_t* output_v = get_bvec_t(outputNoCheck(oind).data());
-    bvec_t* seed_v = use_fwd ? input_v : output_v;
-    bvec_t* sens_v = use_fwd ? output_v : input_v;
-
     // Number of sweeps needed
     int nsweep = use_fwd ? nsweep_fwd : nsweep_adj;
 
@@ -470,11 +714,15 @@ namespace casadi {
     int nz_seed = use_fwd ? nz_in  : nz_out;
     int nz_sens = use_fwd ? nz_out : nz_in;
 
+    // Seeds, sensitivities and work vector, nw words per nonzero
+    vector<bvec_t> seed_v(nz_seed*nw, 0), sens_v(nz_sens*nw, 0), w_v(rtmp_.size()*nw, 0);
+
     // Print
     if (verbose()) {
       std::cout << "FunctionInternal::getJacSparsity: using "
                 << (use_fwd ? "forward" : "adjoint") << " mode: ";
-      std::cout << nsweep << " sweeps needed for " << nz_seed << " directions" << endl;
+      std::cout << nsweep << " sweeps needed for " << nz_seed << " directions, "
+                << ndir << " directions per sweep" << endl;
     }
 
     // Progress
@@ -497,51 +745,51 @@ namespace casadi {
       }
 
       // Nonzero offset
-      int offset = s*bvec_size;
+      int offset = s*ndir;
 
       // Number of local seed directions
-      int ndir_local = std::min(bvec_size, nz_seed-offset);
+      int ndir_local = std::min(ndir, nz_seed-offset);
 
       for (int i=0; i<ndir_local; ++i) {
-        seed_v[offset+i] |= bvec_t(1)<<i;
+        seed_v[(offset+i)*nw + i/bvec_size] |= bvec_t(1)<<(i%bvec_size);
       }
 
       // Propagate the dependencies
-      spEvaluate(use_fwd);
+      spEvaluateWide(use_fwd, iind, oind, getPtr(seed_v), getPtr(sens_v), nw, getPtr(w_v));
 
       // Loop over the nonzeros of the output
       for (int el=0; el<nz_sens; ++el) {
+        for (int k=0; k<nw; ++k) {
 
-        // Get the sparsity sensitivity
-        bvec_t spsens = sens_v[el];
-
-        // Clear the sensitivities for the next sweep
-        if (!use_fwd) {
-          sens_v[el] = 0;
-        }
+          // Get the sparsity sensitivity
+          bvec_t spsens = sens_v[el*nw+k];
 
-        // If there is a dependency in any of the directions
-        if (0!=spsens) {
+          // If there is a dependency in any of the directions
+          if (0!=spsens) {
 
-          // Loop over seed directions
-          for (int i=0; i<ndir_local; ++i) {
+            // Loop over seed directions
+            for (int i=0; i<bvec_size; ++i) {
 
-            // If dependents on the variable
-            if ((bvec_t(1) << i) & spsens) {
-              // Add to pattern
-              jcol.push_back(el);
-              jrow.push_back(i+offset);
+              // If dependents on the variable
+              if ((bvec_t(1) << i) & spsens) {
+                // Add to pattern
+                jcol.push_back(el);
+                jrow.push_back(i+k*bvec_size+offset);
+              }
             }
           }
         }
       }
 
       // Remove the seeds
-      for (int i=0; i<bvec_size && offset+i<nz_seed; ++i) {
-        seed_v[offset+i] = 0;
+      for (int i=0; i<ndir_local; ++i) {
+        seed_v[(offset+i)*nw + i/bvec_size] = 0;
       }
     }
 
+    // Statistics
+    stats_["n_sp_sweeps"] = n_sp_sweeps_ += nsweep;
+
     // Set inputs and outputs to zero
     for (int ind=0; ind<getNumInputs(); ++ind) input(ind).setZero();
     for (int ind=0; ind<getNumOutputs(); ++ind) output(ind).setZero();
@@ -781,6 +1029,7 @@ namespace casadi {
     }
 
     casadi_log("Number of sweeps: " << nsweeps);
+    stats_["n_sp_sweeps"] = n_sp_sweeps_ += nsweeps;
     casadi_log("Formed Jacobian sparsity pattern (dimension " << r.shape() <<
                ", " << r.nnz() << " nonzeros, " << (100.0*r.nnz())/r.numel() << " % nonzeros).");
 
@@ -820,6 +1069,20 @@ namespace casadi {
     // Rows of the fine blocks
     std::vector<int> fine_row;
 
+    // Maximum number of words per nonzero
+    int nw_max = spWords();
+
+#ifdef USE_CXX11
+    // Threads performing the sweeps, requires a re-entrant propagation
+    int n_threads = 1;
+    if (spCanEvaluateWide()) {
+      n_threads = getOption("sp_threads");
+      casadi_assert_message(n_threads>=0, "Option \"sp_threads\" must be nonnegative");
+      if (n_threads==0) n_threads = std::max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    ThreadPool pool(n_threads>1 ? n_threads : 0);
+#endif // USE_CXX11
+
     // In each iteration, subdivide each coarse block in this many fine blocks
     int subdivision = bvec_size;
 
@@ -838,13 +1101,6 @@ namespace casadi {
     // Get weighting factor
     double w = adWeightSp();
 
-    // Lookup table for bvec_t
-    std::vector<bvec_t> bvec_lookup;
-    bvec_lookup.reserve(bvec_size);
-    for (int i=0;i<bvec_size;++i) {
-      bvec_lookup.push_back(bvec_t(1) << i);
-    }
-
     while (!hasrun || coarse_col.size()!=nz_out+1 || coarse_row.size()!=nz_in+1) {
       casadi_log("Block size: " << granularity_col << " x " << granularity_row);
 
@@ -887,19 +1143,10 @@ namespace casadi {
       // Reset the virtual machine
       spInit(use_fwd);
 
-      // Get seeds and sensitivities
-      bvec_t* input_v = get_bvec_t(inputNoCheck(iind).data());
-      bvec_t* output_v = get_bvec_t(outputNoCheck(oind).data());
-      bvec_t* seed_v = use_fwd ? input_v : output_v;
-      bvec_t* sens_v = use_fwd ? output_v : input_v;
-
       // The number of zeros in the seed and sensitivity directions
       int nz_seed = use_fwd ? nz_in  : nz_out;
       int nz_sens = use_fwd ? nz_out : nz_in;
 
-      // Clear the seeds
-      for (int i=0; i<nz_seed; ++i) seed_v[i]=0;
-
       // Choose the active jacobian coloring scheme
       Sparsity D = use_fwd ? D1 : D2;
 
@@ -939,19 +1186,27 @@ namespace casadi {
       std::vector<int> fine_col_lookup = lookupvector(fine_col, nz_sens+1);
       std::vector<int> fine_row_lookup = lookupvector(fine_row, nz_seed+1);
 
+      // The maximum number of fine blocks contained in one coarse block
+      int n_fine_blocks_max = fine_row_lookup[coarse_row[1]]-fine_row_lookup[coarse_row[0]];
+
+      // Use as many words per nonzero as needed to cover all directions in one sweep, if possible
+      int nw = (D.size2()*n_fine_blocks_max + bvec_size-1)/bvec_size;
+      nw = std::max(1, std::min(nw, nw_max));
+      int ndir = nw*bvec_size;
+
       // Triplet data used as a lookup table
       std::vector<int> lookup_col;
       std::vector<int> lookup_row;
       std::vector<int> lookup_value;
 
+      // Seeds and lookup tables of the sweeps, the last one being filled
+      std::vector<SpSweep> sweeps(1);
+
       // Loop over all coarse seed directions from the coloring
       for (int csd=0; csd<D.size2(); ++csd) {
 
-        // The maximum number of fine blocks contained in one coarse block
-        int n_fine_blocks_max = fine_row_lookup[coarse_row[1]]-fine_row_lookup[coarse_row[0]];
-
         int fci_offset = 0;
-        int fci_cap = bvec_size-bvec_i;
+        int fci_cap = ndir-bvec_i;
 
         // Flag to indicate if all fine blocks have been handled
         bool f_finished = false;
@@ -983,9 +1238,11 @@ namespace casadi {
                 lookup_value.push_back(value);
               }
 
-              // Toggle on seeds
-              bvec_toggle(seed_v, fine_row[fci+fci_start], fine_row[fci+fci_start+1],
-                          bvec_i+bvec_i_mod);
+              // Seeds to be toggled on
+              SpSweep& sw = sweeps.back();
+              sw.seed_begin.push_back(fine_row[fci+fci_start]);
+              sw.seed_end.push_back(fine_row[fci+fci_start+1]);
+              sw.seed_dir.push_back(bvec_i+bvec_i_mod);
               bvec_i_mod++;
             }
           }
@@ -994,67 +1251,24 @@ namespace casadi {
           bvec_i+= min(n_fine_blocks_max, fci_cap);
 
           // Check if bvec buffer is full
-          if (bvec_i==bvec_size || csd==D.size2()-1) {
-            // Calculate sparsity for bvec_size directions at once
-
-            // Statistics
-            nsweeps+=1;
-
+          if ((bvec_i==ndir || csd==D.size2()-1) && !sweeps.back().seed_dir.empty()) {
             // Construct lookup table
-            IMatrix lookup = IMatrix::triplet(lookup_row, lookup_col, lookup_value, bvec_size,
-                                              coarse_col.size());
-
-            // Propagate the dependencies
-            spEvaluate(use_fwd);
-
-            // Temporary bit work vector
-            bvec_t spsens;
-
-            // Loop over the cols of coarse blocks
-            for (int cri=0;cri<coarse_col.size()-1;++cri) {
-
-              // Loop over the cols of fine blocks within the current coarse block
-              for (int fri=fine_col_lookup[coarse_col[cri]];
-                   fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
-                // Lump individual sensitivities together into fine block
-                bvec_or(sens_v, spsens, fine_col[fri], fine_col[fri+1]);
-
-                // Next iteration if no sparsity
-                if (!spsens) continue;
-
-                // Loop over all bvec_bits
-                for (int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
-                  if (spsens & bvec_lookup[bvec_i]) {
-                    // if dependency is found, add it to the new sparsity pattern
-                    jrow.push_back(bvec_i+lookup.elem(bvec_i, cri));
-                    jcol.push_back(fri);
-                  }
-                }
-              }
-            }
-
-            // Clear the forward seeds/adjoint sensitivities, ready for next bvec sweep
-            for (int ind=0; ind<getNumInputs(); ++ind) {
-              vector<double> &v = inputNoCheck(ind).data();
-              if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
-            }
-
-            // Clear the adjoint seeds/forward sensitivities, ready for next bvec sweep
-            for (int ind=0; ind<getNumOutputs(); ++ind) {
-              vector<double> &v = outputNoCheck(ind).data();
-              if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
-            }
+            sweeps.back().lookup = IMatrix::triplet(lookup_row, lookup_col, lookup_value, ndir,
+                                                    coarse_col.size());
 
             // Clean lookup table
             lookup_col.clear();
             lookup_row.clear();
             lookup_value.clear();
+
+            // Start the next sweep
+            sweeps.push_back(SpSweep());
           }
 
           if (n_fine_blocks_max>fci_cap) {
             fci_offset += min(n_fine_blocks_max, fci_cap);
             bvec_i = 0;
-            fci_cap = bvec_size;
+            fci_cap = ndir;
           } else {
             f_finished = true;
           }
@@ -1062,6 +1276,49 @@ namespace casadi {
         }
 
       }
+      sweeps.pop_back();
+
+      // Statistics
+      nsweeps += sweeps.size();
+
+      // Calculate sparsity for ndir directions per sweep, the sweeps are independent
+#ifdef USE_CXX11
+      if (pool.size()>1 && sweeps.size()>1) {
+        SpSweepEvaluator e(this, use_fwd, iind, oind, nw, pool.size(), coarse_col, fine_col,
+                           fine_col_lookup, sweeps);
+        SpSweepJob job(e);
+        vector<double> task_cputime(sweeps.size(), 1);
+        vector<int> task_allocation;
+        int n_stolen;
+        pool.run(job, task_cputime, task_allocation, n_stolen);
+      } else {
+#endif // USE_CXX11
+        SpSweepEvaluator e(this, use_fwd, iind, oind, nw, 1, coarse_col, fine_col,
+                           fine_col_lookup, sweeps);
+        for (int s=0; s<sweeps.size(); ++s) {
+          e.evaluate(s, 0);
+
+          // Clear the forward seeds/adjoint sensitivities, ready for next bvec sweep
+          for (int ind=0; ind<getNumInputs(); ++ind) {
+            vector<double> &v = inputNoCheck(ind).data();
+            if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
+          }
+
+          // Clear the adjoint seeds/forward sensitivities, ready for next bvec sweep
+          for (int ind=0; ind<getNumOutputs(); ++ind) {
+            vector<double> &v = outputNoCheck(ind).data();
+            if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
+          }
+        }
+#ifdef USE_CXX11
+      }
+#endif // USE_CXX11
+
+      // Collect the dependencies in the order of the sweeps, independent of the scheduling
+      for (int s=0; s<sweeps.size(); ++s) {
+        jrow.insert(jrow.end(), sweeps[s].jrow.begin(), sweeps[s].jrow.end());
+        jcol.insert(jcol.end(), sweeps[s].jcol.begin(), sweeps[s].jcol.end());
+      }
 
       // Swap results if adjoint mode was used
       if (use_fwd) {
@@ -1078,6 +1335,7 @@ namespace casadi {
       hasrun = true;
     }
     casadi_log("Number of sweeps: " << nsweeps);
+    stats_["n_sp_sweeps"] = n_sp_sweeps_ += nsweeps;
     casadi_log("Formed Jacobian sparsity pattern (dimension " << r.shape() <<
                ", " << r.nnz() << " nonzeros, " << (100.0*r.nnz())/r.numel() << " % nonzeros).");
 
@@ -1088,7 +1346,8 @@ namespace casadi {
     // Check if we are able to propagate dependencies through the function
     if (spCanEvaluate(true) || spCanEvaluate(false)) {
 
-      if (input(iind).nnz()>3*bvec_size && output(oind).nnz()>3*bvec_size) {
+      int ndir = spWords()*bvec_size;
+      if (input(iind).nnz()>3*ndir && output(oind).nnz()>3*ndir) {
         if (symmetric) {
           return getJacSparsityHierarchicalSymm(iind, oind);
         } else {
@@ -1171,8 +1430,25 @@ namespace casadi {
     return jsp_ref;
   }
 
+  int FunctionInternal::coloringOrdering(bool symmetric) {
+    string ordering = getOption("coloring_ordering");
+    if (ordering=="default") {
+      return symmetric ? 1 : 0;
+    } else if (ordering=="none") {
+      return 0;
+    } else if (ordering=="largest_first") {
+      return 1;
+    } else if (ordering=="smallest_last") {
+      return 2;
+    } else {
+      casadi_assert_message(ordering=="incidence_degree", "Coloring ordering " << ordering
+                            << " unknown.");
+      return 3;
+    }
+  }
+
   void FunctionInternal::getPartition(int iind, int oind, Sparsity& D1, Sparsity& D2,
-                                      bool compact, bool symmetric) {
+                                      bool compact, bool symmetric, bool acyclic) {
     log("FunctionInternal::getPartition begin");
 
     // Sparsity pattern with transpose
@@ -1180,16 +1456,29 @@ namespace casadi {
     Sparsity A = symmetric ? AT : AT.T();
 
     // Get seed matrices by graph coloring
-    if (symmetric) {
+    if (symmetric && acyclic) {
+      casadi_assert(hasDerForward());
+
+      // Acyclic coloring, recovery by substitution
+      log("FunctionInternal::getPartition acyclicColoring");
+      D1 = A.acyclicColoring(coloringOrdering(true));
+      casadi_log("Acyclic coloring completed: " << D1.size2() << " directional derivatives "
+                 "needed (" << A.size1() << " without coloring).");
+
+    } else if (symmetric) {
       casadi_assert(hasDerForward());
 
       // Star coloring if symmetric
       log("FunctionInternal::getPartition starColoring");
-      D1 = A.starColoring();
+      D1 = A.starColoring(coloringOrdering(true));
       casadi_log("Star coloring completed: " << D1.size2() << " directional derivatives needed ("
                  << A.size1() << " without coloring).");
 
     } else {
+      // Column ordering and recoloring passes
+      int ordering = coloringOrdering(false);
+      int recolor = getOption("coloring_recolor");
+
       casadi_assert(hasDerForward() || hasDerReverse());
       // Get weighting factor
       double w = adWeight();
@@ -1218,7 +1507,7 @@ namespace casadi {
           log("FunctionInternal::getPartition unidirectional coloring (forward mode)");
           int max_colorings_to_test = best_coloring>=w*A.size1() ? A.size1() :
             floor(best_coloring/w);
-          D1 = AT.unidirectionalColoring(A, max_colorings_to_test);
+          D1 = AT.unidirectionalColoring(A, max_colorings_to_test, ordering, recolor);
           if (D1.isNull()) {
             if (verbose()) cout << "Forward mode coloring interrupted (more than "
                                << max_colorings_to_test << " needed)." << endl;
@@ -1234,7 +1523,7 @@ namespace casadi {
           int max_colorings_to_test = best_coloring>=(1-w)*A.size2() ? A.size2() :
             floor(best_coloring/(1-w));
 
-          D2 = A.unidirectionalColoring(AT, max_colorings_to_test);
+          D2 = A.unidirectionalColoring(AT, max_colorings_to_test, ordering, recolor);
           if (D2.isNull()) {
             if (verbose()) cout << "Adjoint mode coloring interrupted (more than "
                                << max_colorings_to_test << " needed)." << endl;
@@ -1252,23 +1541,89 @@ namespace casadi {
     log("FunctionInternal::getPartition end");
   }
 
-  void FunctionInternal::evaluate() {
+  void FunctionInternal::prepareEvaluate() {
     // Allocate temporary memory if needed
     size_t ni, nr;
     nTmp(ni, nr);
+    if (ni>itmp_.capacity() || nr>rtmp_.capacity()
+        || eval_arg_.size()!=getNumInputs() || eval_res_.size()!=getNumOutputs()) {
+      // Should only happen for the first call
+#ifndef NDEBUG
+      stats_["n_realloc_work"] = ++n_realloc_work_;
+#endif // NDEBUG
+      eval_arg_.resize(getNumInputs());
+      eval_res_.resize(getNumOutputs());
+    }
     itmp_.resize(ni);
     rtmp_.resize(nr);
 
     // Get pointers to input arguments
-    cpv_double arg(getNumInputs());
-    for (int i=0; i<arg.size(); ++i) arg[i]=input(i).ptr();
+    for (int i=0; i<eval_arg_.size(); ++i) eval_arg_[i]=inputNoCheck(i).ptr();
+  }
 
-    // Get pointers to output arguments
-    pv_double res(getNumOutputs());
-    for (int i=0; i<res.size(); ++i) res[i]=output(i).ptr();
+  void FunctionInternal::evalCounted(const std::vector<const std::vector<int>*>& perm) {
+#ifdef CASADI_COUNT_ALLOC
+    long n_alloc = n_heap_alloc;
+#endif // CASADI_COUNT_ALLOC
 
     // Call memory-less
-    evalD(arg, res, getPtr(itmp_), getPtr(rtmp_));
+    if (perm.empty()) {
+      evalD(eval_arg_, eval_res_, getPtr(itmp_), getPtr(rtmp_));
+    } else {
+      evalDPermuted(eval_arg_, eval_res_, perm, getPtr(itmp_), getPtr(rtmp_));
+    }
+
+#ifdef CASADI_COUNT_ALLOC
+    // Also counts allocations of other threads, such as the workers of a thread pool
+    n_alloc_eval_ += n_heap_alloc - n_alloc;
+    stats_["n_alloc_eval"] = n_alloc_eval_;
+#endif // CASADI_COUNT_ALLOC
+  }
+
+  void FunctionInternal::evaluate() {
+    prepareEvaluate();
+
+    // Get pointers to output arguments
+    for (int i=0; i<eval_res_.size(); ++i) eval_res_[i]=outputNoCheck(i).ptr();
+
+    evalCounted();
+  }
+
+  void FunctionInternal::evaluateInto(const pv_double& res,
+                                      const std::vector<const std::vector<int>*>& perm) {
+    casadi_assert(res.size()==getNumOutputs());
+    casadi_assert(perm.empty() || perm.size()==getNumOutputs());
+    prepareEvaluate();
+
+    // Outputs are written to the external memory directly, if given
+    for (int i=0; i<eval_res_.size(); ++i) {
+      eval_res_[i] = res[i]!=0 ? res[i] : outputNoCheck(i).ptr();
+    }
+    for (int i=0; i<perm.size(); ++i) {
+      casadi_assert(res[i]==0 || perm[i]==0 || perm[i]->size()==outputNoCheck(i).nnz());
+    }
+
+    evalCounted(perm);
+  }
+
+  void FunctionInternal::evalDPermuted(const cpv_double& arg, const pv_double& res,
+                                       const std::vector<const std::vector<int>*>& perm,
+                                       int* itmp, double* rtmp) {
+    // Evaluate the permuted outputs into the output members
+    EvalPointersScope scope(0, res.size());
+    pv_double& res_unperm = *scope.res;
+    for (int i=0; i<res.size(); ++i) {
+      res_unperm[i] = res[i]!=0 && perm[i]!=0 ? outputNoCheck(i).ptr() : res[i];
+    }
+    evalD(arg, res_unperm, itmp, rtmp);
+
+    // Scatter them
+    for (int i=0; i<perm.size(); ++i) {
+      if (res[i]==0 || perm[i]==0) continue;
+      const vector<int>& p = *perm[i];
+      const double* v = outputNoCheck(i).ptr();
+      for (int k=0; k<p.size(); ++k) res[i][p[k]] = v[k];
+    }
   }
 
   void FunctionInternal::evalD(const cpv_double& arg,
@@ -1351,6 +1706,38 @@ namespace casadi {
     }
   }
 
+  void FunctionInternal::spEvaluateWide(bool fwd, int iind, int oind, const bvec_t* seed,
+                                        bvec_t* sens, int nw, bvec_t* w) {
+    // Seeds and sensitivities in the input and output buffers
+    bvec_t* input_v = get_bvec_t(inputNoCheck(iind).data());
+    bvec_t* output_v = get_bvec_t(outputNoCheck(oind).data());
+    bvec_t* seed_v = fwd ? input_v : output_v;
+    bvec_t* sens_v = fwd ? output_v : input_v;
+    int nz_seed = fwd ? input(iind).nnz() : output(oind).nnz();
+    int nz_sens = fwd ? output(oind).nnz() : input(iind).nnz();
+
+    // One sweep per word
+    for (int k=0; k<nw; ++k) {
+      for (int i=0; i<nz_seed; ++i) seed_v[i] = seed[i*nw+k];
+      if (!fwd) fill_n(sens_v, nz_sens, bvec_t(0));
+      spEvaluate(fwd);
+      for (int i=0; i<nz_sens; ++i) sens[i*nw+k] = sens_v[i];
+    }
+
+    // Clear the seeds and sensitivities
+    fill_n(seed_v, nz_seed, bvec_t(0));
+    fill_n(sens_v, nz_sens, bvec_t(0));
+  }
+
+  int FunctionInternal::spWords() {
+    if (hasSetOption("sp_words")) {
+      int nw = getOption("sp_words");
+      casadi_assert_message(nw>=1, "Option \"sp_words\" must be positive");
+      return nw;
+    }
+    return spCanEvaluateWide() ? 4 : 1;
+  }
+
   void FunctionInternal::spEvaluateViaJacSparsity(bool fwd) {
     if (fwd) {
       // Clear the outputs
@@ -1426,7 +1813,19 @@ namespace casadi {
 
     } else {
       // Generate a Jacobian
-      Function ret = getJacobian(iind, oind, compact, symmetric);
+      Function ret;
+      int jac_num_threads = getOption("jac_num_threads");
+      bool acyclic = symmetric && getOption("symmetric_coloring")=="acyclic";
+      if (jac_num_threads==1 && !acyclic) {
+        ret = getJacobian(iind, oind, compact, symmetric);
+      } else {
+        // Colored directional derivatives, evaluated in chunks on a thread pool
+        ret = ColoredJacobian(shared_from_this<Function>(), iind, oind, compact, symmetric);
+        if (jac_num_threads!=1) {
+          ret.setOption("parallelization", "threads");
+          ret.setOption("num_threads", jac_num_threads);
+        }
+      }
 
       // Give it a suitable name
       stringstream ss;
@@ -1903,6 +2302,27 @@ namespace casadi {
   }
 
   void FunctionInternal::generateCode(std::ostream &cfile, bool generate_main) {
+    CodeGenerator gen;
+    generateCode(cfile, generate_main, gen);
+  }
+
+  void FunctionInternal::generateCode(std::ostream &cfile, std::vector<std::string>& units) {
+    CodeGenerator gen;
+    gen.split_units_ = true;
+    generateCode(cfile, false, gen);
+
+    // Collect the additional translation units
+    units.resize(gen.units_.size());
+    for (int k=0; k<units.size(); ++k) {
+      stringstream ss;
+      ss << "/* This function was automatically generated by CasADi */" << endl;
+      gen.flushUnit(ss, k);
+      units[k] = ss.str();
+    }
+  }
+
+  void FunctionInternal::generateCode(std::ostream &cfile, bool generate_main,
+                                      CodeGenerator& gen) {
     assertInit();
 
     // set stream parameters
@@ -1913,9 +2333,6 @@ namespace casadi {
     // Print header
     cfile << "/* This function was automatically generated by CasADi */" << endl;
 
-    // Create a code generator object
-    CodeGenerator gen;
-
     // Generate function inputs and outputs information
     generateIO(gen);
 
@@ -1925,14 +2342,42 @@ namespace casadi {
     // Flush the code generator
     gen.flush(cfile);
 
+    // Number of inputs and outputs
+    int n_in = getNumInputs();
+    int n_out = getNumOutputs();
+
+    // Batched evaluation, the k-th set of inputs and outputs start at offset k*nnz. This is
+    // a convenience loop over eval in one work vector, not vectorized over the sets
+    cfile << "/* Evaluate n sets of inputs one after the other, not vectorized */" << endl;
+    cfile << "int evalBatch(int n, const d* const* arg, d* const* res, int* iw, d* w) {"
+          << endl;
+    cfile << "  const d* arg1[" << std::max(n_in, 1) << "];" << endl;
+    cfile << "  d* res1[" << std::max(n_out, 1) << "];" << endl;
+    cfile << "  int k, flag;" << endl;
+    cfile << "  for (k=0; k<n; ++k) {" << endl;
+    for (int i=0; i<n_in; ++i) {
+      cfile << "    arg1[" << i << "] = arg[" << i << "] ? arg[" << i << "] + k*"
+            << input(i).nnz() << " : 0;" << endl;
+    }
+    for (int i=0; i<n_out; ++i) {
+      cfile << "    res1[" << i << "] = res[" << i << "] ? res[" << i << "] + k*"
+            << output(i).nnz() << " : 0;" << endl;
+    }
+    cfile << "    flag = eval(arg1, res1, iw, w);" << endl;
+    cfile << "    if (flag) return flag;" << endl;
+    cfile << "  }" << endl;
+    cfile << "  return 0;" << endl;
+    cfile << "}" << endl << endl;
+
     // Define wrapper function
     cfile << "int evaluateWrap(const d** arg, d** res) {" << endl;
 
-    // Temporary memory
+    // Temporary memory, static unless the wrapper is required to be re-entrant
     size_t ni, nr;
     nTmp(ni, nr);
-    cfile << "  static int iw[" << ni << "];" << endl;
-    cfile << "  static d w[" << nr << "];" << endl;
+    string wstorage = getOption("codegen_reentrant") ? "  " : "  static ";
+    cfile << wstorage << "int iw[" << std::max(ni, size_t(1)) << "];" << endl;
+    cfile << wstorage << "d w[" << std::max(nr, size_t(1)) << "];" << endl;
     cfile << "  return eval(arg, res, iw, w);" << endl;
     cfile << "}" << endl << endl;
 
@@ -1940,8 +2385,6 @@ namespace casadi {
     cfile << "void evaluate(";
 
     // Declare inputs
-    int n_in = getNumInputs();
-    int n_out = getNumOutputs();
     for (int i=0; i<n_in; ++i) {
       cfile << "const d* x" << i;
       if (i+1<n_in+n_out) cfile << ", ";
@@ -1974,9 +2417,6 @@ namespace casadi {
 
     // Create a main for debugging and profiling: TODO: Cleanup and expose to user, see #617
     if (generate_main) {
-      int n_in = getNumInputs();
-      int n_out = getNumOutputs();
-
       cfile << "#include <stdio.h>" << endl;
       cfile << "int main() {" << endl;
       cfile << "  int i, j;" << endl;
@@ -2150,6 +2590,180 @@ namespace casadi {
     s << endl;
   }
 
+#ifdef WITH_DL
+  namespace {
+    // 64-bit FNV-1a hash of a string, as hexadecimal digits
+    std::string hashString(const std::string& s) {
+      unsigned long long h = 14695981039346656037ULL;
+      for (std::string::const_iterator c=s.begin(); c!=s.end(); ++c) {
+        h ^= static_cast<unsigned char>(*c);
+        h *= 1099511628211ULL;
+      }
+      std::stringstream ss;
+      ss << std::hex;
+      ss.width(16);
+      ss.fill('0');
+      ss << h;
+      return ss.str();
+    }
+
+    // Create a directory and its parents, if they do not exist yet (as mkdir -p)
+    bool makeDirectories(const std::string& dir) {
+      size_t pos = 0;
+      while (pos!=std::string::npos) {
+        pos = dir.find_first_of("/\\", pos+1);
+        std::string path = dir.substr(0, pos);
+#ifdef _WIN32
+        int flag = _mkdir(path.c_str());
+#else // _WIN32
+        int flag = mkdir(path.c_str(), 0777);
+#endif // _WIN32
+        if (flag!=0 && errno!=EEXIST) return false;
+      }
+      return true;
+    }
+
+    // Quote a file name for use in a shell command
+    std::string shellQuote(const std::string& s) {
+#ifdef _WIN32
+      return "\"" + s + "\"";
+#else // _WIN32
+      // Single quotes, a single quote itself is closed, escaped and reopened
+      std::string ret = "'";
+      for (std::string::const_iterator c=s.begin(); c!=s.end(); ++c) {
+        if (*c=='\'') {
+          ret += "'\\''";
+        } else {
+          ret += *c;
+        }
+      }
+      return ret + "'";
+#endif // _WIN32
+    }
+
+    // Remove a file, returns false if it exists but cannot be removed
+    bool removeFile(const std::string& filename) {
+      return remove(filename.c_str())==0 || errno==ENOENT;
+    }
+
+    // Number of temporary file names handed out, distinguishes concurrent compilations
+    // within a process
+#ifdef USE_CXX11
+    std::atomic<long> n_tmp_names(0);
+#else // USE_CXX11
+    long n_tmp_names = 0;
+#endif // USE_CXX11
+
+    // Read a file into a string, returns false if it cannot be opened
+    bool readFile(const std::string& filename, std::string& content) {
+      std::ifstream file(filename.c_str(), std::ios::binary);
+      if (!file.good()) return false;
+      std::stringstream ss;
+      ss << file.rdbuf();
+      content = ss.str();
+      return true;
+    }
+
+    // Compile a shared library
+    void compileFile(const std::string& compile_command, const std::string& fdescr,
+                     const std::string& dlname, bool verbose) {
+      if (verbose) {
+        cout << "Compiling " << fdescr <<  " using \"" << compile_command << "\"" << endl;
+      }
+      time_t time1 = time(0);
+      int flag = system(compile_command.c_str());
+      time_t time2 = time(0);
+      double comp_time = difftime(time2, time1);
+      casadi_assert_message(flag==0, "Compilation failed");
+      if (verbose) {
+        cout << "Compiled " << fdescr << " (" << dlname << ") in " << comp_time << " s."  << endl;
+      }
+    }
+
+    // Write a string to a file
+    void writeFile(const std::string& filename, const std::string& content) {
+      std::ofstream file(filename.c_str(), std::ios::binary);
+      file << content;
+      file.close();
+      casadi_assert_message(file.good(), "Failed to write " << filename);
+    }
+
+#ifdef USE_CXX11
+    /// Compilation of translation units, for the thread pool
+    class CompileJob : public ThreadPool::Job {
+    public:
+      CompileJob(const std::vector<std::string>& commands, const std::string& fdescr,
+                 const std::vector<std::string>& objects, bool verbose)
+          : commands_(commands), fdescr_(fdescr), objects_(objects), verbose_(verbose) {}
+      virtual void evaluateTask(int task, int worker) {
+        compileFile(commands_[task], fdescr_, objects_[task], verbose_);
+      }
+    private:
+      const std::vector<std::string>& commands_;
+      const std::string& fdescr_;
+      const std::vector<std::string>& objects_;
+      bool verbose_;
+    };
+#endif // USE_CXX11
+
+    // Compile the main source and additional translation units, if any, to a shared library
+    void compileLibrary(const std::string& compiler, const std::string& dlflag,
+                        const std::vector<std::string>& cnames, const std::string& fdescr,
+                        const std::string& dlname, bool verbose) {
+      // Single translation unit
+      int n = cnames.size();
+      if (n==1) {
+        compileFile(compiler + " " + dlflag + " " + shellQuote(cnames[0]) + " -o "
+                    + shellQuote(dlname), fdescr, dlname, verbose);
+        return;
+      }
+
+      // Compile each unit to an object file
+      vector<string> objects(n), commands(n);
+      vector<double> cost(n);
+      for (int k=0; k<n; ++k) {
+        objects[k] = cnames[k] + ".o";
+        commands[k] = compiler + " -c " + shellQuote(cnames[k]) + " -o " + shellQuote(objects[k]);
+        std::ifstream file(cnames[k].c_str(), std::ios::binary | std::ios::ate);
+        cost[k] = static_cast<double>(file.tellg());
+      }
+      int n_threads = 1;
+#ifdef USE_CXX11
+      n_threads = CasadiOptions::compile_num_threads;
+      casadi_assert_message(n_threads>=0, "CasadiOptions::compile_num_threads must be nonnegative");
+      if (n_threads==0) n_threads = std::max(1, static_cast<int>(thread::hardware_concurrency()));
+      n_threads = std::min(n_threads, n);
+#endif // USE_CXX11
+      try {
+        if (n_threads==1) {
+          for (int k=0; k<n; ++k) compileFile(commands[k], fdescr, objects[k], verbose);
+        } else {
+#ifdef USE_CXX11
+          ThreadPool pool(n_threads);
+          CompileJob job(commands, fdescr, objects, verbose);
+          vector<int> allocation;
+          int n_stolen;
+          pool.run(job, cost, allocation, n_stolen);
+#endif // USE_CXX11
+        }
+
+        // Link
+        string link_command = compiler + " " + dlflag;
+        for (int k=0; k<n; ++k) link_command += " " + shellQuote(objects[k]);
+        link_command += " -o " + shellQuote(dlname);
+        compileFile(link_command, fdescr, dlname, verbose);
+      } catch(...) {
+        // Remove object files, also if compilation failed
+        for (int k=0; k<n; ++k) remove(objects[k].c_str());
+        throw;
+      }
+
+      // Remove object files
+      for (int k=0; k<n; ++k) remove(objects[k].c_str());
+    }
+  } // namespace
+#endif // WITH_DL
+
   Function FunctionInternal::dynamicCompilation(Function f, std::string fname, std::string fdescr,
                                                 std::string compiler) {
 #ifdef WITH_DL
@@ -2165,38 +2779,118 @@ namespace casadi {
     bool f_is_init = f.isInit();
     if (!f_is_init) f.init();
 
-    // Filenames
-    string cname = fname + ".c";
-    string dlname = fname + ".so";
-
-    // Remove existing files, if any
-    string rm_command = "rm -rf " + cname + " " + dlname;
-    int flag = system(rm_command.c_str());
-    casadi_assert_message(flag==0, "Failed to remove old source");
-
-    // Codegen it
-    f.generateCode(cname);
-    if (verbose_) {
-      cout << "Generated c-code for " << fdescr << " (" << cname << ")" << endl;
-    }
-
-    // Compile it
-    string compile_command = compiler + " " + dlflag + " " + cname + " -o " + dlname;
-    if (verbose_) {
-      cout << "Compiling " << fdescr <<  " using \"" << compile_command << "\"" << endl;
-    }
+    // Name of the compiled library
+    string dlname;
+
+    const string& cache_dir = CasadiOptions::compile_cache_dir;
+    if (cache_dir.empty()) {
+      // Filenames
+      string cname = fname + ".c";
+      dlname = "./" + fname + ".so";
+
+      // Remove existing files, if any
+      casadi_assert_message(removeFile(cname) && removeFile(dlname), "Failed to remove old source");
+
+      // Codegen it, large functions may be split into several translation units
+      stringstream src;
+      vector<string> units;
+      f->generateCode(src, units);
+      vector<string> cnames(1, cname);
+      writeFile(cname, src.str());
+      for (int k=0; k<units.size(); ++k) {
+        stringstream uname;
+        uname << fname << "_u" << k << ".c";
+        cnames.push_back(uname.str());
+        writeFile(uname.str(), units[k]);
+      }
+      if (verbose_) {
+        cout << "Generated c-code for " << fdescr << " (" << cname << ", "
+             << units.size() << " additional units)" << endl;
+      }
 
-    time_t time1 = time(0);
-    flag = system(compile_command.c_str());
-    time_t time2 = time(0);
-    double comp_time = difftime(time2, time1);
-    casadi_assert_message(flag==0, "Compilation failed");
-    if (verbose_) {
-      cout << "Compiled " << fdescr << " (" << dlname << ") in " << comp_time << " s."  << endl;
+      // Compile it
+      compileLibrary(compiler, dlflag, cnames, fdescr, dlname, verbose_);
+    } else {
+      // Generate the source, the cache key is the hash of the source and the compiler command
+      stringstream ss;
+      vector<string> units;
+      f->generateCode(ss, units);
+      string src = ss.str();
+      string all_src = src;
+      for (int k=0; k<units.size(); ++k) all_src += units[k];
+      // Note that fname is not part of the key since it may contain instance-specific data
+      string key = "casadi_" + hashString(compiler + " " + dlflag + "\n" + all_src);
+      string cname = cache_dir + "/" + key + ".c";
+      dlname = cache_dir + "/" + key + ".so";
+      vector<string> unames(units.size());
+      for (int k=0; k<units.size(); ++k) {
+        stringstream uname;
+        uname << cache_dir << "/" << key << "_u" << k << ".c";
+        unames[k] = uname.str();
+      }
+
+      // A hit requires identical sources next to the library, guarding against collisions
+      string cached_src;
+      bool hit = readFile(cname, cached_src) && cached_src==src
+        && std::ifstream(dlname.c_str()).good();
+      for (int k=0; hit && k<units.size(); ++k) {
+        hit = readFile(unames[k], cached_src) && cached_src==units[k];
+      }
+      if (hit) {
+        stats_["n_compile_cache_hit"] = ++n_compile_cache_hit_;
+        if (verbose_) {
+          cout << "Found " << fdescr << " in the compile cache (" << dlname << ")" << endl;
+        }
+      } else {
+        stats_["n_compile_cache_miss"] = ++n_compile_cache_miss_;
+
+        // Make sure that the cache directory exists, without passing it through a shell
+        casadi_assert_message(makeDirectories(cache_dir),
+                              "Failed to create compile cache directory " << cache_dir);
+
+        // Other processes and threads may be populating the cache concurrently: compile into
+        // files that are private to this call and move them into place with an atomic rename
+        stringstream suffix;
+        suffix << ".tmp" << getpid() << "_" << n_tmp_names++;
+        string cname_tmp = cache_dir + "/" + key + suffix.str() + ".c";
+        string dlname_tmp = dlname + suffix.str();
+        vector<string> cnames_tmp(1, cname_tmp);
+        for (int k=0; k<units.size(); ++k) {
+          stringstream uname_tmp;
+          uname_tmp << cache_dir << "/" << key << "_u" << k << suffix.str() << ".c";
+          cnames_tmp.push_back(uname_tmp.str());
+        }
+        try {
+          writeFile(cname_tmp, src);
+          for (int k=0; k<units.size(); ++k) writeFile(cnames_tmp[k+1], units[k]);
+          if (verbose_) {
+            cout << "Generated c-code for " << fdescr << " (" << cname_tmp << ", "
+                 << units.size() << " additional units)" << endl;
+          }
+          compileLibrary(compiler, dlflag, cnames_tmp, fdescr, dlname_tmp, verbose_);
+
+          // The library is published before the sources, the main source marks the entry
+          // as complete
+          casadi_assert_message(rename(dlname_tmp.c_str(), dlname.c_str())==0,
+                                "Failed to move " << dlname_tmp << " into the compile cache");
+          for (int k=0; k<units.size(); ++k) {
+            casadi_assert_message(rename(cnames_tmp[k+1].c_str(), unames[k].c_str())==0,
+                                  "Failed to move " << cnames_tmp[k+1]
+                                  << " into the compile cache");
+          }
+          casadi_assert_message(rename(cname_tmp.c_str(), cname.c_str())==0,
+                                "Failed to move " << cname_tmp << " into the compile cache");
+        } catch(...) {
+          // Leave no temporary files in the cache
+          removeFile(dlname_tmp);
+          for (int k=0; k<cnames_tmp.size(); ++k) removeFile(cnames_tmp[k]);
+          throw;
+        }
+      }
     }
 
     // Load it
-    ExternalFunction f_gen("./" + dlname);
+    ExternalFunction f_gen(dlname);
     f_gen.setOption("name", fname + "_gen");
 
     // Initialize it if f was initialized
@@ -2295,6 +2989,7 @@ namespace casadi {
         fill_n(output_i, output(i).nnz(), 0);
       } else {
         copy(res[i], res[i]+output(i).nnz(), output_i);
+        fill_n(res[i], output(i).nnz(), 0);
       }
     }
 
@@ -68,6 +68,18 @@ namespace casadi {
     /** \brief  Evaluate using internal data structures */
     virtual void evaluate();
 
+    /** \brief  Evaluate with the outputs written to external memory, cf. Function */
+    void evaluateInto(const pv_double& res, const std::vector<const std::vector<int>*>& perm);
+
+    /** \brief  Size the work vectors and pointer arrays of evaluate() and evaluateInto(),
+        point eval_arg_ to the inputs */
+    void prepareEvaluate();
+
+    /** \brief  Call evalD, or evalDPermuted if \a perm is not empty, with the work vectors
+        and pointer arrays of evaluate(), counting its heap allocations in debug builds */
+    void evalCounted(const std::vector<const std::vector<int>*>& perm
+                     = std::vector<const std::vector<int>*>());
+
     /** \brief  Obtain solver name from Adaptor */
     virtual std::string getAdaptorSolverName() const { return ""; }
 
@@ -92,9 +104,35 @@ namespace casadi {
     /** \brief  Reset the sparsity propagation */
     virtual void spInit(bool fwd) {}
 
+    /** \brief  Propagate nw bit vectors per nonzero from input iind to output oind (forward)
+        or from output oind to input iind (backward), work vector given
+        Seeds and sensitivities are stored with the nw words of each nonzero contiguous.
+        The work vector must have length nw*rtmp_.size().
+        The default implementation makes nw calls to spEvaluate, spInit must have been called. */
+    virtual void spEvaluateWide(bool fwd, int iind, int oind, const bvec_t* seed, bvec_t* sens,
+                                int nw, bvec_t* w);
+
+    /** \brief  Can the class propagate several words per nonzero in a single pass?
+        If so, the inputs and outputs are not used and spEvaluateWide can be called
+        concurrently, given separate work vectors. */
+    virtual bool spCanEvaluateWide() { return false;}
+
+    /** \brief  Number of words per nonzero in sparsity pattern calculation */
+    int spWords();
+
     /** \brief  Evaluate numerically, work vectors given */
     virtual void evalD(const cpv_double& arg, const pv_double& res, int* itmp, double* rtmp);
 
+    /** \brief  Evaluate numerically in the work vectors of the class, with nonzero k of
+        output i written to res[i][(*perm[i])[k]] if perm[i] is not null, cf. evaluateInto.
+        By default, such outputs are evaluated into the output members and scattered */
+    virtual void evalDPermuted(const cpv_double& arg, const pv_double& res,
+                               const std::vector<const std::vector<int>*>& perm,
+                               int* itmp, double* rtmp);
+
+    /** \brief  Can evalD be called concurrently, given separate work vectors? */
+    virtual bool isReentrant() const { return false;}
+
     /** \brief  Evaluate symbolically, SXElement type, possibly nonmatching sparsity patterns */
     virtual void evalSX(const std::vector<SX>& arg, std::vector<SX>& res);
 
@@ -231,6 +269,15 @@ namespace casadi {
     /** \brief  Print to a stream */
     virtual void generateCode(std::ostream &cfile, bool generate_main);
 
+    /** \brief  Print to a stream, parts of large functions in additional translation units
+     * The additional units, if any, are returned in \a units and must be linked with the
+     * main file.
+     */
+    void generateCode(std::ostream &cfile, std::vector<std::string>& units);
+
+    /** \brief  Print to a stream using a given code generator */
+    void generateCode(std::ostream &cfile, bool generate_main, CodeGenerator& gen);
+
     /** \brief Generate code for function inputs and outputs */
     void generateIO(CodeGenerator& gen);
 
@@ -255,8 +302,16 @@ namespace casadi {
     /** \brief Check if the numerical values of the supplied bounds make sense */
     virtual void checkInputs() const {}
 
-    /** \brief Get the unidirectional or bidirectional partition */
-    void getPartition(int iind, int oind, Sparsity& D1, Sparsity& D2, bool compact, bool symmetric);
+    /** \brief Get the unidirectional or bidirectional partition
+     *
+     * Symmetric Jacobians use a star coloring, which allows a direct recovery, or
+     * an acyclic coloring if \a acyclic, which requires a recovery by substitution.
+     */
+    void getPartition(int iind, int oind, Sparsity& D1, Sparsity& D2, bool compact, bool symmetric,
+                      bool acyclic=false);
+
+    /// Column ordering for the graph colorings, cf. option "coloring_ordering"
+    int coloringOrdering(bool symmetric);
 
     /// Verbose mode?
     bool verbose() const;
@@ -345,7 +400,8 @@ namespace casadi {
     /** \brief  Log the status of the solver, function given */
     void log(const std::string& fcn, const std::string& msg) const;
 
-    /// Codegen function
+    /** \brief Codegen function, compile it to a shared library and load it
+     * Uses the compile cache if CasadiOptions::compile_cache_dir is set */
     Function dynamicCompilation(Function f, std::string fname, std::string fdescr,
                                 std::string compiler);
 
@@ -427,6 +483,26 @@ namespace casadi {
     /** \brief  Temporary vector needed for the evaluation (real) */
     std::vector<double> rtmp_;
 
+    /** \brief  Pointers to the inputs and outputs, used by evaluate() */
+    cpv_double eval_arg_;
+    pv_double eval_res_;
+
+    /** \brief  Number of times evaluate() had to grow its own work vectors and pointer
+        arrays, stays constant in steady state. Only counted in debug builds, the member
+        is kept in all builds so that the class layout does not depend on NDEBUG.
+        Allocations made by evalD itself are not counted */
+    int n_realloc_work_;
+
+    /** \brief  Number of heap allocations made during the evalD calls of evaluate(),
+        stays constant in steady state. Only counted in debug builds with C++11 */
+    int n_alloc_eval_;
+
+    /** \brief  Number of sparsity propagation sweeps in Jacobian sparsity calculations */
+    int n_sp_sweeps_;
+
+    /** \brief  Compile cache hits and misses in dynamicCompilation */
+    int n_compile_cache_hit_, n_compile_cache_miss_;
+
     /// User-set field
     void* user_data_;
 
@@ -454,6 +530,25 @@ namespace casadi {
     std::vector<std::vector<MatType> > symbolicAdjSeed(int nadj, const std::vector<MatType>& v);
   };
 
+  /** \brief  Pointer arrays for an evaluation in work vectors owned by the caller
+
+      Reserves the pointer arrays of one nesting level of such calls on the current thread
+      for the lifetime of the object. The arrays only grow and may be longer than
+      requested, so nested and concurrent calls do not allocate in steady state.
+  */
+  class CASADI_EXPORT EvalPointersScope {
+  public:
+    /// Constructor, reserves arrays of at least the given lengths
+    EvalPointersScope(size_t max_arg, size_t max_res);
+
+    /// Destructor, releases the nesting level
+    ~EvalPointersScope();
+
+    /// Pointer arrays of the nesting level
+    cpv_double* arg;
+    pv_double* res;
+  };
+
   // Template implementations
   template<typename MatType>
   bool FunctionInternal::purgable(const std::vector<MatType>& v) {
@@ -63,6 +63,9 @@ namespace casadi {
 
     input_.scheme = SCHEME_LinsolInput;
     output_.scheme = SCHEME_LinsolOutput;
+
+    addOption("rhs_block", OT_INTEGER, 16,
+              "Number of right-hand-sides that are solved for together");
   }
 
   void LinearSolverInternal::init() {
@@ -71,6 +74,11 @@ namespace casadi {
 
     // Not prepared
     prepared_ = false;
+
+    // Read options
+    rhs_block_ = getOption("rhs_block");
+    casadi_assert_message(rhs_block_>0, "LinearSolverInternal::init: \"rhs_block\" must be "
+                          "positive, got " << rhs_block_ << ".");
   }
 
   LinearSolverInternal::~LinearSolverInternal() {
@@ -120,6 +128,90 @@ namespace casadi {
     solve(getPtr(x), nrhs, transpose);
   }
 
+  void LinearSolverInternal::gatherPanel(int n, int nb, const int* p, bool inv,
+                                         const double* x, double* t) {
+    for (int r=0; r<nb; ++r) {
+      const double* xr = x + r*n;
+      if (p==0) {
+        for (int k=0; k<n; ++k) t[k*nb+r] = xr[k];
+      } else if (inv) {
+        for (int k=0; k<n; ++k) t[p[k]*nb+r] = xr[k];
+      } else {
+        for (int k=0; k<n; ++k) t[k*nb+r] = xr[p[k]];
+      }
+    }
+  }
+
+  void LinearSolverInternal::scatterPanel(int n, int nb, const int* p, bool inv,
+                                          const double* t, double* x) {
+    for (int r=0; r<nb; ++r) {
+      double* xr = x + r*n;
+      if (p==0) {
+        for (int k=0; k<n; ++k) xr[k] = t[k*nb+r];
+      } else if (inv) {
+        for (int k=0; k<n; ++k) xr[p[k]] = t[k*nb+r];
+      } else {
+        for (int k=0; k<n; ++k) xr[k] = t[p[k]*nb+r];
+      }
+    }
+  }
+
+  void LinearSolverInternal::lsolvePanel(int n, const int* colind, const int* row,
+                                         const double* val, double* t, int nb) {
+    for (int j=0; j<n; ++j) {
+      double* tj = t + j*nb;
+      double d = val[colind[j]];
+      for (int r=0; r<nb; ++r) tj[r] /= d;
+      for (int el=colind[j]+1; el<colind[j+1]; ++el) {
+        double* ti = t + row[el]*nb;
+        double l = val[el];
+        for (int r=0; r<nb; ++r) ti[r] -= l*tj[r];
+      }
+    }
+  }
+
+  void LinearSolverInternal::ltsolvePanel(int n, const int* colind, const int* row,
+                                          const double* val, double* t, int nb) {
+    for (int j=n-1; j>=0; --j) {
+      double* tj = t + j*nb;
+      for (int el=colind[j]+1; el<colind[j+1]; ++el) {
+        const double* ti = t + row[el]*nb;
+        double l = val[el];
+        for (int r=0; r<nb; ++r) tj[r] -= l*ti[r];
+      }
+      double d = val[colind[j]];
+      for (int r=0; r<nb; ++r) tj[r] /= d;
+    }
+  }
+
+  void LinearSolverInternal::usolvePanel(int n, const int* colind, const int* row,
+                                         const double* val, double* t, int nb) {
+    for (int j=n-1; j>=0; --j) {
+      double* tj = t + j*nb;
+      double d = val[colind[j+1]-1];
+      for (int r=0; r<nb; ++r) tj[r] /= d;
+      for (int el=colind[j]; el<colind[j+1]-1; ++el) {
+        double* ti = t + row[el]*nb;
+        double u = val[el];
+        for (int r=0; r<nb; ++r) ti[r] -= u*tj[r];
+      }
+    }
+  }
+
+  void LinearSolverInternal::utsolvePanel(int n, const int* colind, const int* row,
+                                          const double* val, double* t, int nb) {
+    for (int j=0; j<n; ++j) {
+      double* tj = t + j*nb;
+      for (int el=colind[j]; el<colind[j+1]-1; ++el) {
+        const double* ti = t + row[el]*nb;
+        double u = val[el];
+        for (int r=0; r<nb; ++r) tj[r] -= u*ti[r];
+      }
+      double d = val[colind[j+1]-1];
+      for (int r=0; r<nb; ++r) tj[r] /= d;
+    }
+  }
+
   void LinearSolverInternal::
   callForwardLinsol(const std::vector<MX>& arg, const std::vector<MX>& res,
                 const std::vector<std::vector<MX> >& fseed,
@@ -105,6 +105,36 @@ namespace casadi {
     /// Obtain a symbolic Cholesky factorization
     virtual Sparsity getFactorizationSparsity(bool transpose) const;
 
+    ///@{
+    /** \brief Permute a panel of nb right-hand-sides between column-major storage with
+     * leading dimension n, x[r*n+i], and interleaved storage, t[i*nb+r]
+     *
+     * Gather: t(k) = x(p[k]), or t(p[k]) = x(k) if \a inv. Scatter: x(k) = t(p[k]), or
+     * x(p[k]) = t(k) if \a inv. A null \a p is the identity, cf. cs_pvec and cs_ipvec.
+     */
+    static void gatherPanel(int n, int nb, const int* p, bool inv, const double* x, double* t);
+    static void scatterPanel(int n, int nb, const int* p, bool inv, const double* t, double* x);
+    ///@}
+
+    ///@{
+    /** \brief Sparse triangular solves for a panel of nb interleaved right-hand-sides
+     *
+     * The factor is given in compressed column format with the diagonal entry stored first
+     * (L) or last (U) in each column, cf. cs_lsolve, cs_ltsolve, cs_usolve and cs_utsolve.
+     */
+    static void lsolvePanel(int n, const int* colind, const int* row, const double* val,
+                            double* t, int nb);
+    static void ltsolvePanel(int n, const int* colind, const int* row, const double* val,
+                             double* t, int nb);
+    static void usolvePanel(int n, const int* colind, const int* row, const double* val,
+                            double* t, int nb);
+    static void utsolvePanel(int n, const int* colind, const int* row, const double* val,
+                             double* t, int nb);
+    ///@}
+
+    /// Number of right-hand-sides solved for together
+    int rhs_block_;
+
     /// Obtain a numeric Cholesky factorization
     virtual DMatrix getFactorization(bool transpose) const;
 
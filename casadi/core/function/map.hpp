@@ -0,0 +1,68 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_MAP_HPP
+#define CASADI_MAP_HPP
+
+#include "function.hpp"
+
+namespace casadi {
+
+  // Forward declaration of internal class
+  class MapInternal;
+
+  /** \brief Evaluation of a function for many sets of arguments
+
+      The inputs and outputs of a Map are the horizontal concatenations of \a n
+      inputs and outputs of the mapped function, such that the nonzeros of each
+      evaluation are stored contiguously. The whole map is a single node in an
+      expression graph, and its derivatives are maps of the derivatives of the
+      mapped function.
+
+      The evaluations can be serial (one work vector reused for all of them),
+      distributed over a thread pool (one work vector per thread, requires a
+      re-entrant function) or batched (SXFunction only, each operation applied to
+      all evaluations at once).
+  */
+  class CASADI_EXPORT Map : public Function {
+  public:
+
+    /// Default constructor
+    Map();
+
+    /// Create a Map of \a n evaluations of \a f
+    Map(const Function& f, int n);
+
+    /// Access functions of the node
+    MapInternal* operator->();
+
+    /// Const access functions of the node
+    const MapInternal* operator->() const;
+  };
+
+} // namespace casadi
+
+
+#endif // CASADI_MAP_HPP
@@ -0,0 +1,344 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "map_internal.hpp"
+#include "sx_function_internal.hpp"
+#ifndef _WIN32
+#include <unistd.h>
+#endif // _WIN32
+
+using namespace std;
+
+namespace casadi {
+
+  namespace {
+    // Point to the nonzeros of evaluation j, v and v_j may be longer than nnz
+    template<typename T>
+    void lanePointers(const vector<T*>& v, const vector<int>& nnz, int j, vector<T*>& v_j) {
+      for (int i=0; i<nnz.size(); ++i) v_j[i] = v[i]==0 ? 0 : v[i] + j*nnz[i];
+    }
+
+    // n copies of sp side by side, also for n==0
+    Sparsity horzrep(const Sparsity& sp, int n) {
+      return n==0 ? Sparsity(sp.size1(), 0) : horzcat(vector<Sparsity>(n, sp));
+    }
+  } // namespace
+
+#ifdef USE_CXX11
+  /// The evaluations of a Map, for the thread pool
+  class MapJob : public ThreadPool::Job {
+  public:
+    MapJob(MapInternal* m, const cpv_double& arg, const pv_double& res, int* itmp, double* rtmp)
+        : m_(m), arg_(arg), res_(res), itmp_(itmp), rtmp_(rtmp) {}
+
+    virtual void evaluateTask(int task, int worker) {
+      // Every worker has its own part of the work vectors, and pointer arrays of its thread
+      EvalPointersScope scope(m_->getNumInputs(), m_->getNumOutputs());
+      lanePointers(arg_, m_->nnz_in_, task, *scope.arg);
+      lanePointers(res_, m_->nnz_out_, task, *scope.res);
+      m_->f_->evalD(*scope.arg, *scope.res, itmp_ + worker*m_->f_ni_, rtmp_ + worker*m_->f_nr_);
+    }
+
+  private:
+    MapInternal* m_;
+    const cpv_double& arg_;
+    const pv_double& res_;
+    int* itmp_;
+    double* rtmp_;
+  };
+#endif // USE_CXX11
+
+  MapInternal::MapInternal(const Function& f, int n) : f_(f), n_(n) {
+    addOption("parallelization", OT_STRING, "serial", "", "serial|threads|batch");
+    addOption("num_threads", OT_INTEGER, 0, "Number of worker threads (\"threads\"), "
+              "0 for the number of available cores");
+    casadi_assert_message(n>=0, "Map: the number of evaluations must be nonnegative");
+  }
+
+  MapInternal::~MapInternal() {
+  }
+
+  void MapInternal::init() {
+    // Initialize the mapped function
+    f_.init(false);
+
+    // Get mode
+    if (getOption("parallelization")=="serial") {
+      mode_ = SERIAL;
+    } else if (getOption("parallelization")=="threads") {
+      mode_ = THREADS;
+    } else if (getOption("parallelization")=="batch") {
+      mode_ = BATCH;
+    } else {
+      casadi_error("Parallelization mode " << getOption("parallelization") << " unknown.");
+    }
+
+    // Threads need a re-entrant function and C++11
+    if (mode_==THREADS) {
+#ifdef USE_CXX11
+      if (!f_.isReentrant()) {
+        casadi_warning("Map: the mapped function is not re-entrant, switching to serial mode.");
+        mode_ = SERIAL;
+      }
+#else // USE_CXX11
+      casadi_warning("Thread parallelization is not available, switching to serial mode. "
+                     "Recompile CasADi with a C++11 compiler.");
+      mode_ = SERIAL;
+#endif // USE_CXX11
+    }
+
+    // Batched evaluation is implemented for SXFunction only
+    if (mode_==BATCH && !is_a<SXFunction>(f_)) {
+      casadi_warning("Map: batched evaluation requires an SXFunction, switching to serial mode.");
+      mode_ = SERIAL;
+    }
+
+    // Number of workers
+    num_threads_ = getOption("num_threads");
+    casadi_assert_message(num_threads_>=0, "Map: \"num_threads\" must be nonnegative");
+    if (num_threads_==0) {
+#ifdef USE_CXX11
+      num_threads_ = thread::hardware_concurrency();
+#elif !defined(_WIN32)
+      num_threads_ = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+      num_threads_ = std::max(num_threads_, 1);
+    }
+    num_threads_ = std::min(num_threads_, n_);
+
+    // Inputs and outputs are horizontal concatenations of those of the mapped function
+    setNumInputs(f_.getNumInputs());
+    nnz_in_.resize(getNumInputs());
+    for (int i=0; i<getNumInputs(); ++i) {
+      input(i) = DMatrix::zeros(horzrep(f_.input(i).sparsity(), n_));
+      nnz_in_[i] = f_.input(i).nnz();
+    }
+    setNumOutputs(f_.getNumOutputs());
+    nnz_out_.resize(getNumOutputs());
+    for (int i=0; i<getNumOutputs(); ++i) {
+      output(i) = DMatrix::zeros(horzrep(f_.output(i).sparsity(), n_));
+      nnz_out_[i] = f_.output(i).nnz();
+    }
+
+    // Work vectors of the mapped function
+    f_.nTmp(f_ni_, f_nr_);
+
+    // (Re)start the thread pool
+    pool_.reset(mode_==THREADS ? num_threads_ : 0);
+
+    // Call the init function of the base class
+    FunctionInternal::init();
+  }
+
+  void MapInternal::nTmp(size_t& ni, size_t& nr) {
+    switch (mode_) {
+    case SERIAL:
+      // One work vector, reused for every evaluation
+      ni = f_ni_;
+      nr = f_nr_;
+      break;
+    case THREADS:
+      // One work vector per thread
+      ni = f_ni_*num_threads_;
+      nr = f_nr_*num_threads_;
+      break;
+    case BATCH:
+      // One work vector with n_ entries per element, then the transposed inputs and outputs
+      ni = f_ni_;
+      nr = f_nr_*n_;
+      for (int i=0; i<nnz_in_.size(); ++i) nr += nnz_in_[i]*n_;
+      for (int i=0; i<nnz_out_.size(); ++i) nr += nnz_out_[i]*n_;
+      break;
+    }
+  }
+
+  bool MapInternal::isReentrant() const {
+    // The thread pool serves one call at a time
+    return mode_!=THREADS && f_.isReentrant();
+  }
+
+  void MapInternal::evalD(const cpv_double& arg, const pv_double& res,
+                          int* itmp, double* rtmp) {
+    int n_in = getNumInputs(), n_out = getNumOutputs();
+    if (mode_==SERIAL) {
+      // Evaluate one after the other in the same work vector
+      EvalPointersScope scope(n_in, n_out);
+      for (int j=0; j<n_; ++j) {
+        lanePointers(arg, nnz_in_, j, *scope.arg);
+        lanePointers(res, nnz_out_, j, *scope.res);
+        f_->evalD(*scope.arg, *scope.res, itmp, rtmp);
+      }
+    } else if (mode_==THREADS) {
+#ifdef USE_CXX11
+      MapJob job(this, arg, res, itmp, rtmp);
+      vector<double> task_cputime(n_, 1);
+      vector<int> task_allocation;
+      int n_stolen;
+      pool_->run(job, task_cputime, task_allocation, n_stolen);
+      if (gather_stats_) {
+        stats_["num_threads"] = pool_->size();
+        stats_["task_allocation"] = task_allocation;
+        stats_["task_cputime"] = task_cputime;
+        stats_["n_stolen"] = n_stolen;
+      }
+#endif // USE_CXX11
+    } else if (mode_==BATCH) {
+      // Transpose the inputs to a structure of arrays
+      EvalPointersScope scope(n_in, n_out);
+      cpv_double& arg_soa = *scope.arg;
+      pv_double& res_soa = *scope.res;
+      double* w = rtmp + f_nr_*n_;
+      for (int i=0; i<n_in; ++i) {
+        int nnz = nnz_in_[i];
+        arg_soa[i] = 0;
+        if (arg[i]!=0) {
+          for (int j=0; j<n_; ++j) {
+            for (int k=0; k<nnz; ++k) w[k*n_ + j] = arg[i][j*nnz + k];
+          }
+          arg_soa[i] = w;
+        }
+        w += nnz*n_;
+      }
+      for (int i=0; i<n_out; ++i) {
+        res_soa[i] = res[i]==0 ? 0 : w;
+        w += nnz_out_[i]*n_;
+      }
+
+      // Evaluate all at once
+      static_cast<SXFunctionInternal*>(f_.operator->())->evalDBatch(arg_soa, res_soa, n_, rtmp);
+
+      // Transpose the outputs back
+      for (int i=0; i<n_out; ++i) {
+        if (res[i]!=0) {
+          int nnz = nnz_out_[i];
+          for (int j=0; j<n_; ++j) {
+            for (int k=0; k<nnz; ++k) res[i][j*nnz + k] = res_soa[i][k*n_ + j];
+          }
+        }
+      }
+    }
+  }
+
+  void MapInternal::evalSX(const std::vector<SX>& arg, std::vector<SX>& res) {
+    // Quick return if no evaluations
+    res.resize(getNumOutputs());
+    if (n_==0) {
+      for (int i=0; i<res.size(); ++i) res[i] = SX::zeros(output(i).sparsity());
+      return;
+    }
+
+    // Split up the arguments
+    vector<vector<SX> > arg_split(arg.size());
+    for (int i=0; i<arg.size(); ++i) {
+      int ncol = f_.input(i).size2();
+      vector<int> offset(n_+1);
+      for (int j=0; j<=n_; ++j) offset[j] = j*ncol;
+      arg_split[i] = horzsplit(arg[i], offset);
+    }
+
+    // Evaluate symbolically
+    vector<vector<SX> > res_split(getNumOutputs(), vector<SX>(n_));
+    vector<SX> arg_j(arg.size());
+    for (int j=0; j<n_; ++j) {
+      for (int i=0; i<arg.size(); ++i) arg_j[i] = arg_split[i][j];
+      vector<SX> res_j = f_(arg_j);
+      for (int i=0; i<res_j.size(); ++i) res_split[i][j] = res_j[i];
+    }
+
+    // Concatenate the results
+    for (int i=0; i<res.size(); ++i) res[i] = horzcat(res_split[i]);
+  }
+
+  void MapInternal::spFwd(const std::vector<const bvec_t*>& arg,
+                          const std::vector<bvec_t*>& res, int* itmp, bvec_t* rtmp) {
+    vector<const bvec_t*> arg_j(getNumInputs());
+    vector<bvec_t*> res_j(getNumOutputs());
+    for (int j=0; j<n_; ++j) {
+      lanePointers(arg, nnz_in_, j, arg_j);
+      lanePointers(res, nnz_out_, j, res_j);
+      f_->spFwd(arg_j, res_j, itmp, rtmp);
+    }
+  }
+
+  void MapInternal::spAdj(const std::vector<bvec_t*>& arg,
+                          const std::vector<bvec_t*>& res, int* itmp, bvec_t* rtmp) {
+    vector<bvec_t*> arg_j(getNumInputs());
+    vector<bvec_t*> res_j(getNumOutputs());
+    for (int j=0; j<n_; ++j) {
+      lanePointers(arg, nnz_in_, j, arg_j);
+      lanePointers(res, nnz_out_, j, res_j);
+      f_->spAdj(arg_j, res_j, itmp, rtmp);
+    }
+  }
+
+  void MapInternal::spEvaluate(bool fwd) {
+    // Propagate in the own work vectors, seeds and sensitivities in the inputs and outputs
+    size_t ni, nr;
+    nTmp(ni, nr);
+    itmp_.resize(ni);
+    rtmp_.resize(nr);
+    vector<bvec_t*> res(getNumOutputs());
+    for (int i=0; i<res.size(); ++i) res[i] = reinterpret_cast<bvec_t*>(output(i).ptr());
+    if (fwd) {
+      vector<const bvec_t*> arg(getNumInputs());
+      for (int i=0; i<arg.size(); ++i) arg[i] = reinterpret_cast<const bvec_t*>(input(i).ptr());
+      spFwd(arg, res, getPtr(itmp_), get_bvec_t(rtmp_));
+    } else {
+      vector<bvec_t*> arg(getNumInputs());
+      for (int i=0; i<arg.size(); ++i) {
+        arg[i] = reinterpret_cast<bvec_t*>(input(i).ptr());
+        fill_n(arg[i], input(i).nnz(), 0);
+      }
+      spAdj(arg, res, getPtr(itmp_), get_bvec_t(rtmp_));
+    }
+  }
+
+  Function MapInternal::getDerForward(int nfwd) {
+    // The inputs and outputs of the derivative are ordered the same way for every evaluation
+    Map ret(f_.derForward(nfwd), n_);
+    ret.setOption(dictionary());
+    ret.init();
+    return ret;
+  }
+
+  Function MapInternal::getDerReverse(int nadj) {
+    // The inputs and outputs of the derivative are ordered the same way for every evaluation
+    Map ret(f_.derReverse(nadj), n_);
+    ret.setOption(dictionary());
+    ret.init();
+    return ret;
+  }
+
+  void MapInternal::deepCopyMembers(
+      std::map<SharedObjectNode*, SharedObject>& already_copied) {
+    FunctionInternal::deepCopyMembers(already_copied);
+    f_ = deepcopy(f_, already_copied);
+  }
+
+  void MapInternal::print(std::ostream &stream) const {
+    stream << "Map(" << f_.getOption("name") << ", " << n_ << ")";
+  }
+
+} // namespace casadi
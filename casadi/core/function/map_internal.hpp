@@ -0,0 +1,127 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_MAP_INTERNAL_HPP
+#define CASADI_MAP_INTERNAL_HPP
+
+#include "map.hpp"
+#include "function_internal.hpp"
+#include "thread_pool.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief  Internal node class for Map */
+  class CASADI_EXPORT MapInternal : public FunctionInternal {
+    friend class Map;
+
+  protected:
+    /// Constructor
+    MapInternal(const Function& f, int n);
+
+  public:
+    /// Clone
+    virtual MapInternal* clone() const { return new MapInternal(*this);}
+
+    /// Destructor
+    virtual ~MapInternal();
+
+    /// Initialize
+    virtual void init();
+
+    /// Evaluate numerically, work vectors given
+    virtual void evalD(const cpv_double& arg, const pv_double& res, int* itmp, double* rtmp);
+
+    /// Can evalD be called concurrently, given separate work vectors?
+    virtual bool isReentrant() const;
+
+    /// Get number of temporary variables needed
+    virtual void nTmp(size_t& ni, size_t& nr);
+
+    /// Evaluate symbolically, SXElement type
+    virtual void evalSX(const std::vector<SX>& arg, std::vector<SX>& res);
+
+    /// Propagate sparsity forward
+    virtual void spFwd(const std::vector<const bvec_t*>& arg,
+                       const std::vector<bvec_t*>& res, int* itmp, bvec_t* rtmp);
+
+    /// Propagate sparsity backwards
+    virtual void spAdj(const std::vector<bvec_t*>& arg,
+                       const std::vector<bvec_t*>& res, int* itmp, bvec_t* rtmp);
+
+    /// Is the class able to propagate seeds through the algorithm?
+    virtual bool spCanEvaluate(bool fwd) { return true;}
+
+    /// Propagate the sparsity pattern through a set of directional derivatives
+    virtual void spEvaluate(bool fwd);
+
+    ///@{
+    /** \brief Generate a function that calculates \a nfwd forward derivatives */
+    virtual Function getDerForward(int nfwd);
+    virtual bool hasDerForward() const { return true;}
+    ///@}
+
+    ///@{
+    /** \brief Generate a function that calculates \a nadj adjoint derivatives */
+    virtual Function getDerReverse(int nadj);
+    virtual bool hasDerReverse() const { return true;}
+    ///@}
+
+    /// Deep copy data members
+    virtual void deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied);
+
+    /// Print description
+    virtual void print(std::ostream &stream) const;
+
+    /// Mapped function
+    Function f_;
+
+    /// Number of evaluations
+    int n_;
+
+    /// Evaluation strategies
+    enum Mode {SERIAL, THREADS, BATCH};
+
+    /// Evaluation strategy
+    Mode mode_;
+
+    /// Number of worker threads
+    int num_threads_;
+
+    /// Thread pool, THREADS mode only
+    OwnedThreadPool pool_;
+
+    /// Nonzeros of each input and output of the mapped function
+    std::vector<int> nnz_in_, nnz_out_;
+
+    /// Work vector sizes of the mapped function
+    size_t f_ni_, f_nr_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_MAP_INTERNAL_HPP
@@ -335,6 +335,10 @@ namespace casadi {
     itmp_.resize(nitmp);
     rtmp_.resize(nrtmp+wind);
 
+    // Pointer arrays for the numerical evaluation
+    oarg_.resize(max_arg_);
+    ores_.resize(max_res_);
+
     // Reset the temporary variables
     for (int i=0; i<nodes.size(); ++i) {
       if (nodes[i]) {
@@ -399,24 +403,83 @@ namespace casadi {
 
   void MXFunctionInternal::evalD(const cpv_double& arg,
                                  const pv_double& res, int* itmp, double* rtmp) {
+    // Profiling is done in a separate loop, to keep the checks out of this one
+    if (CasadiOptions::profiling) return evalDProfiling(arg, res, itmp, rtmp);
+
     casadi_log("MXFunctionInternal::evalD():begin "  << getOption("name"));
+
+    // Make sure that there are no free variables
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      repr(ss);
+      casadi_error("Cannot evaluate \"" << ss.str() << "\" since variables "
+                   << free_vars_ << " are free.");
+    }
+
+    // The pointer arrays of the class can only be used when evaluating in the work vector
+    // of the class. Otherwise the memory is owned by the caller and there may be
+    // concurrent calls, so the arrays are those of the nesting level on this thread
+    bool own_memory = rtmp==getPtr(rtmp_);
+    EvalPointersScope scope(own_memory ? 0 : max_arg_, own_memory ? 0 : max_res_);
+    cpv_double& oarg = own_memory ? oarg_ : *scope.arg;
+    pv_double& ores = own_memory ? ores_ : *scope.res;
+
+    // Evaluate all of the nodes of the algorithm:
+    // should only evaluate nodes that have not yet been calculated!
+    for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      if (it->op==OP_INPUT) {
+        // Pass an input
+        double *w = rtmp+workloc_[it->res.front()];
+        int i=it->arg.front();
+        int nnz=inputNoCheck(i).nnz();
+        if (arg[i]==0) {
+          fill(w, w+nnz, 0);
+        } else {
+          copy(arg[i], arg[i]+nnz, w);
+        }
+      } else if (it->op==OP_OUTPUT) {
+        // Get an output
+        double *w = rtmp+workloc_[it->arg.front()];
+        int i=it->res.front();
+        if (res[i]!=0) copy(w, w+outputNoCheck(i).nnz(), res[i]);
+      } else {
+        // Point pointers to the data corresponding to the element
+        for (int i=0; i<it->arg.size(); ++i)
+          oarg[i] = it->arg[i]>=0 ? rtmp+workloc_[it->arg[i]] : 0;
+        for (int i=0; i<it->res.size(); ++i)
+          ores[i] = it->res[i]>=0 ? rtmp+workloc_[it->res[i]] : 0;
+
+        // Evaluate
+        it->data->evalD(oarg, ores, itmp, rtmp);
+      }
+    }
+
+    casadi_log("MXFunctionInternal::evalD():end "  << getOption("name"));
+  }
+
+  bool MXFunctionInternal::isReentrant() const {
+    // The profiling loop shares the pointer arrays of the class
+    if (CasadiOptions::profiling) return false;
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      if (it->op!=OP_INPUT && it->op!=OP_OUTPUT && !it->data->isReentrant()) return false;
+    }
+    return true;
+  }
+
+  void MXFunctionInternal::evalDProfiling(const cpv_double& arg,
+                                          const pv_double& res, int* itmp, double* rtmp) {
+    casadi_log("MXFunctionInternal::evalDProfiling():begin "  << getOption("name"));
     // Set up timers for profiling
     double time_zero=0;
     double time_start=0;
     double time_stop=0;
-    if (CasadiOptions::profiling) {
-      time_zero = getRealTime();
-      if (CasadiOptions::profilingBinary) {
-        profileWriteEntry(CasadiOptions::profilingLog, this);
-      } else {
-        CasadiOptions::profilingLog  << "start " << this << ":" <<getOption("name") << std::endl;
-      }
+    time_zero = getRealTime();
+    if (CasadiOptions::profilingBinary) {
+      profileWriteEntry(CasadiOptions::profilingLog, this);
+    } else {
+      CasadiOptions::profilingLog  << "start " << this << ":" <<getOption("name") << std::endl;
     }
 
-    // Work vector and temporaries to hold pointers to operation input and outputs
-    vector<const double*> oarg(max_arg_);
-    vector<double*> ores(max_res_);
-
     // Make sure that there are no free variables
     if (!free_vars_.empty()) {
       std::stringstream ss;
@@ -429,9 +492,7 @@ namespace casadi {
     // should only evaluate nodes that have not yet been calculated!
     int alg_counter = 0;
     for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it, ++alg_counter) {
-      if (CasadiOptions::profiling) {
-        time_start = getRealTime(); // Start timer
-      }
+      time_start = getRealTime(); // Start timer
 
       if (it->op==OP_INPUT) {
         // Pass an input
@@ -451,49 +512,43 @@ namespace casadi {
       } else {
         // Point pointers to the data corresponding to the element
         for (int i=0; i<it->arg.size(); ++i)
-          oarg[i] = it->arg[i]>=0 ? rtmp+workloc_[it->arg[i]] : 0;
+          oarg_[i] = it->arg[i]>=0 ? rtmp+workloc_[it->arg[i]] : 0;
         for (int i=0; i<it->res.size(); ++i)
-          ores[i] = it->res[i]>=0 ? rtmp+workloc_[it->res[i]] : 0;
+          ores_[i] = it->res[i]>=0 ? rtmp+workloc_[it->res[i]] : 0;
 
         // Evaluate
-        it->data->evalD(oarg, ores, itmp, rtmp);
+        it->data->evalD(oarg_, ores_, itmp, rtmp);
       }
 
       // Write out profiling information
-      if (CasadiOptions::profiling) {
-        time_stop = getRealTime(); // Stop timer
-
-        if (CasadiOptions::profilingBinary) {
-          profileWriteTime(CasadiOptions::profilingLog, this, alg_counter,
-                           time_stop-time_start, time_stop-time_zero);
-        } else {
-          CasadiOptions::profilingLog  << (time_stop-time_start)*1e6 << " ns | "
-                                       << (time_stop-time_zero)*1e3 << " ms | "
-                                       << this << ":" <<getOption("name") << ":"
-                                       << alg_counter <<"|";
-          if (it->op == OP_CALL) {
-            Function f = it->data->getFunction();
-            CasadiOptions::profilingLog << f.get() << ":" << f.getOption("name");
-          }
-          CasadiOptions::profilingLog << "|";
-          print(CasadiOptions::profilingLog, *it);
+      time_stop = getRealTime(); // Stop timer
+      if (CasadiOptions::profilingBinary) {
+        profileWriteTime(CasadiOptions::profilingLog, this, alg_counter,
+                         time_stop-time_start, time_stop-time_zero);
+      } else {
+        CasadiOptions::profilingLog  << (time_stop-time_start)*1e6 << " ns | "
+                                     << (time_stop-time_zero)*1e3 << " ms | "
+                                     << this << ":" <<getOption("name") << ":"
+                                     << alg_counter <<"|";
+        if (it->op == OP_CALL) {
+          Function f = it->data->getFunction();
+          CasadiOptions::profilingLog << f.get() << ":" << f.getOption("name");
         }
-
+        CasadiOptions::profilingLog << "|";
+        print(CasadiOptions::profilingLog, *it);
       }
     }
 
-    if (CasadiOptions::profiling) {
-      time_stop = getRealTime();
-      if (CasadiOptions::profilingBinary) {
-        profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_zero);
-      } else {
-        CasadiOptions::profilingLog  << "stop " << this << ":"
-                                     <<getOption("name") << (time_stop-time_zero)*1e3
-                                     << " ms" << std::endl;
-      }
+    time_stop = getRealTime();
+    if (CasadiOptions::profilingBinary) {
+      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_zero);
+    } else {
+      CasadiOptions::profilingLog  << "stop " << this << ":"
+                                   <<getOption("name") << (time_stop-time_zero)*1e3
+                                   << " ms" << std::endl;
     }
 
-    casadi_log("MXFunctionInternal::evalD():end "  << getOption("name"));
+    casadi_log("MXFunctionInternal::evalDProfiling():end "  << getOption("name"));
   }
 
   void MXFunctionInternal::print(ostream &stream, const AlgEl& el) const {
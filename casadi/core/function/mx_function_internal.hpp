@@ -60,6 +60,10 @@ namespace casadi {
     // Length of pointer arrays needed during evaluation
     std::size_t max_arg_, max_res_;
 
+    // Pointer arrays for the numerical evaluation, allocated in init
+    std::vector<const double*> oarg_;
+    std::vector<double*> ores_;
+
     /// Free variables
     std::vector<MX> free_vars_;
 
@@ -79,6 +83,12 @@ namespace casadi {
     /** \brief  Evaluate numerically, work vectors given */
     virtual void evalD(const cpv_double& arg, const pv_double& res, int* itmp, double* rtmp);
 
+    /** \brief  Can evalD be called concurrently, given separate work vectors? */
+    virtual bool isReentrant() const;
+
+    /** \brief  Evaluate numerically with timings written to the profiling log */
+    void evalDProfiling(const cpv_double& arg, const pv_double& res, int* itmp, double* rtmp);
+
     /** \brief  Print description */
     virtual void print(std::ostream &stream) const;
 
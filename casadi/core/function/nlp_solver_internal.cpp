@@ -26,6 +26,7 @@
 #include "nlp_solver_internal.hpp"
 #include "mx_function.hpp"
 #include "sx_function.hpp"
+#include "colored_jacobian.hpp"
 #include "../sx/sx_tools.hpp"
 #include "../mx/mx_tools.hpp"
 
@@ -79,6 +80,7 @@ namespace casadi {
     // prevent deletion of the object)
     ref_.assignNodeNoCount(this);
 
+    hess_lag_triu_ = false;
   }
 
   NlpSolverInternal::~NlpSolverInternal() {
@@ -320,8 +322,22 @@ namespace casadi {
       hessLag = getOption("hess_lag");
     } else {
       Function& gradLag = this->gradLag();
+      if (nlp_.hasSetOption("jac_num_threads")) {
+        gradLag.setOption("jac_num_threads", nlp_.getOption("jac_num_threads"));
+      }
       log("Generating Hessian of the Lagrangian");
-      hessLag = gradLag.jacobian(NL_X, NL_NUM_OUT+NL_X, false, true);
+      if (hess_lag_triu_) {
+        // Compressed directional derivatives, only the upper triangular part is recovered
+        hessLag = ColoredJacobian(gradLag, NL_X, NL_NUM_OUT+NL_X, false, true);
+        hessLag.setOption("triangular", true);
+        int jac_num_threads = gradLag.getOption("jac_num_threads");
+        if (jac_num_threads!=1) {
+          hessLag.setOption("parallelization", "threads");
+          hessLag.setOption("num_threads", jac_num_threads);
+        }
+      } else {
+        hessLag = gradLag.jacobian(NL_X, NL_NUM_OUT+NL_X, false, true);
+      }
       log("Hessian function generated");
     }
     hessLag.setOption("name", "hess_lag");
@@ -135,6 +135,9 @@ namespace casadi {
     // Hessian of the Lagrangian
     Function hessLag_;
 
+    /// Generate a Hessian of the Lagrangian with only the entries on and above the diagonal
+    bool hess_lag_triu_;
+
     // Gradient of the Lagrangian
     Function gradLag_;
 
@@ -29,13 +29,34 @@
 #ifdef WITH_OPENMP
 #include <omp.h>
 #endif //WITH_OPENMP
+#ifndef _WIN32
+#include <cstdio>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#endif // _WIN32
 
 using namespace std;
 
 namespace casadi {
 
-  ParallelizerInternal::ParallelizerInternal(const std::vector<Function>& funcs) : funcs_(funcs) {
-    addOption("parallelization", OT_STRING, "serial", "", "serial|openmp|mpi");
+#ifdef USE_CXX11
+  /// The tasks of a Parallelizer, for the thread pool
+  class ParallelizerJob : public ThreadPool::Job {
+  public:
+    explicit ParallelizerJob(ParallelizerInternal* p) : p_(p) {}
+    virtual void evaluateTask(int task, int worker) { p_->evaluateTask(task);}
+  private:
+    ParallelizerInternal* p_;
+  };
+#endif // USE_CXX11
+
+  ParallelizerInternal::ParallelizerInternal(const std::vector<Function>& funcs)
+      : funcs_(funcs) {
+    addOption("parallelization", OT_STRING, "serial", "", "serial|openmp|threads|processes|mpi");
+    addOption("num_threads", OT_INTEGER, 0, "Number of worker threads (\"threads\") or "
+              "processes (\"processes\"), 0 for the number of available cores");
   }
 
   ParallelizerInternal::~ParallelizerInternal() {
@@ -47,8 +68,13 @@ namespace casadi {
       mode_ = SERIAL;
     } else if (getOption("parallelization")=="openmp") {
       mode_ = OPENMP;
+    } else if (getOption("parallelization")=="threads") {
+      mode_ = THREADS;
+    } else if (getOption("parallelization")=="processes") {
+      mode_ = PROCESSES;
     } else if (getOption("parallelization")=="mpi") {
-      mode_ = MPI;
+      casadi_warning("MPI parallelization is not available, switching to \"processes\".");
+      mode_ = PROCESSES;
     } else {
       casadi_error("Parallelization mode " << getOption("parallelization") << " unknown.");
     }
@@ -62,6 +88,37 @@ namespace casadi {
     }
 #endif // WITH_OPENMP
 
+    // The thread pool requires C++11
+#ifndef USE_CXX11
+    if (mode_ == THREADS) {
+      casadi_warning("Thread parallelization is not available, switching to serial mode. "
+                     "Recompile CasADi with a C++11 compiler.");
+      mode_ = SERIAL;
+    }
+#endif // USE_CXX11
+
+    // Multiple processes require fork
+#ifdef _WIN32
+    if (mode_ == PROCESSES) {
+      casadi_warning("Process parallelization is not available on Windows, "
+                     "switching to serial mode.");
+      mode_ = SERIAL;
+    }
+#endif // _WIN32
+
+    // Number of workers
+    num_threads_ = getOption("num_threads");
+    casadi_assert_message(num_threads_>=0, "Parallelizer: \"num_threads\" must be nonnegative");
+    if (num_threads_==0) {
+#ifdef USE_CXX11
+      num_threads_ = thread::hardware_concurrency();
+#elif !defined(_WIN32)
+      num_threads_ = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+      num_threads_ = std::max(num_threads_, 1);
+    }
+    num_threads_ = std::min(num_threads_, static_cast<int>(funcs_.size()));
+
     // Check if a node is a copy of another
     copy_of_.resize(funcs_.size(), -1);
     map<void*, int> is_copy_of;
@@ -80,8 +137,8 @@ namespace casadi {
       // Initialize
       it->init(false);
 
-      // Make sure that the functions are unique if we are using OpenMP
-      if (mode_==OPENMP && it!=funcs_.begin())
+      // Make sure that the functions are unique if we are using OpenMP or threads
+      if ((mode_==OPENMP || mode_==THREADS) && it!=funcs_.begin())
         it->makeUnique();
 
     }
@@ -106,6 +163,12 @@ namespace casadi {
         output(j) = funcs_[i].output(j-outind_[i]);
     }
 
+    // No timings available yet, assume equal cost
+    last_cputime_.assign(funcs_.size(), 1);
+
+    // (Re)start the thread pool
+    pool_.reset(mode_==THREADS ? num_threads_ : 0);
+
     // Call the init function of the base class
     FunctionInternal::init();
   }
@@ -164,9 +227,115 @@ namespace casadi {
       casadi_error("ParallelizerInternal::evaluate: OPENMP support was not available "
                    "during CasADi compilation");
 #endif //WITH_OPENMP
-    } else if (mode_ == MPI) {
-      casadi_error("ParallelizerInternal::evaluate: MPI not implemented");
+    } else if (mode_ == THREADS) {
+      evaluateThreads();
+    } else if (mode_ == PROCESSES) {
+      evaluateProcesses();
+    }
+  }
+
+  void ParallelizerInternal::evaluateThreads() {
+#ifdef USE_CXX11
+    // Start with the timings of the last call, idle workers steal the remaining tasks
+    ParallelizerJob job(this);
+    vector<double> task_cputime = last_cputime_;
+    vector<int> task_allocation;
+    int n_stolen;
+    pool_->run(job, task_cputime, task_allocation, n_stolen);
+    last_cputime_ = task_cputime;
+
+    if (gather_stats_) {
+      stats_["num_threads"] = pool_->size();
+      stats_["task_allocation"] = task_allocation;
+      stats_["task_cputime"] = task_cputime;
+      stats_["n_stolen"] = n_stolen;
+    }
+#else // USE_CXX11
+    casadi_error("ParallelizerInternal::evaluate: Thread support was not available "
+                 "during CasADi compilation");
+#endif // USE_CXX11
+  }
+
+  void ParallelizerInternal::evaluateProcesses() {
+#ifndef _WIN32
+    int ntask = funcs_.size();
+
+    // Shared memory layout: task counter, then per task the status, the worker and the
+    // time spent, then the nonzeros of all outputs
+    vector<int> offset(getNumOutputs()+1, 3*ntask);
+    for (int j=0; j<getNumOutputs(); ++j) offset[j+1] = offset[j] + output(j).nnz();
+    size_t sz = sizeof(double)*(1+offset.back());
+    void* shm = mmap(0, sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    casadi_assert_message(shm!=MAP_FAILED, "Parallelizer: Could not allocate shared memory");
+    int* next_task = static_cast<int*>(shm);
+    *next_task = 0;
+    double* data = static_cast<double*>(shm) + 1;
+    double* status = data;
+    double* allocation = data + ntask;
+    double* cputime = data + 2*ntask;
+    fill(status, status+ntask, -1);
+
+    // Flush the output streams so that the buffers are not written by every process
+    cout.flush();
+    fflush(0);
+
+    // Start the workers, every worker takes the next unprocessed task until all are done
+    vector<pid_t> pid(num_threads_, -1);
+    for (int w=0; w<num_threads_; ++w) {
+      pid[w] = fork();
+      if (pid[w]==0) {
+        int task;
+        while ((task = __sync_fetch_and_add(next_task, 1)) < ntask) {
+          timeval t0, t1;
+          gettimeofday(&t0, 0);
+          try {
+            evaluateTask(task);
+            for (int j=outind_[task]; j<outind_[task+1]; ++j) {
+              copy(output(j).begin(), output(j).end(), data+offset[j]);
+            }
+            status[task] = 0;
+          } catch(exception& e) {
+            cerr << "Parallelizer: task " << task << " failed: " << e.what() << endl;
+            status[task] = 1;
+          }
+          gettimeofday(&t1, 0);
+          allocation[task] = w;
+          cputime[task] = (t1.tv_sec - t0.tv_sec) + 1e-6*(t1.tv_usec - t0.tv_usec);
+        }
+        cout.flush();
+        fflush(0);
+        _exit(0);
+      }
+    }
+
+    // Wait for the workers to finish, tasks not processed because a fork failed are
+    // detected by their status
+    bool failed = false;
+    for (int w=0; w<num_threads_; ++w) {
+      if (pid[w]<0) continue;
+      int wstatus;
+      if (waitpid(pid[w], &wstatus, 0)<0 || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus)!=0)
+        failed = true;
+    }
+    for (int task=0; task<ntask; ++task) failed = failed || status[task]!=0;
+
+    // Collect the results
+    if (!failed) {
+      for (int j=0; j<getNumOutputs(); ++j) {
+        copy(data+offset[j], data+offset[j+1], output(j).begin());
+      }
+      if (gather_stats_) {
+        stats_["num_threads"] = num_threads_;
+        stats_["task_allocation"] = vector<int>(allocation, allocation+ntask);
+        stats_["task_cputime"] = vector<double>(cputime, cputime+ntask);
+      }
     }
+    munmap(shm, sz);
+    casadi_assert_message(!failed, "Parallelizer: a worker process failed");
+#else // _WIN32
+    casadi_error("ParallelizerInternal::evaluate: Process parallelization is not available "
+                 "on Windows");
+#endif // _WIN32
   }
 
   void ParallelizerInternal::evaluateTask(int task) {
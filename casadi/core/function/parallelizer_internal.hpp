@@ -29,6 +29,7 @@
 #include <vector>
 #include "parallelizer.hpp"
 #include "function_internal.hpp"
+#include "thread_pool.hpp"
 
 /// \cond INTERNAL
 
@@ -64,6 +65,12 @@ namespace casadi {
     /// Evaluate a single task
     virtual void evaluateTask(int task);
 
+    /// Evaluate the tasks with the thread pool
+    void evaluateThreads();
+
+    /// Evaluate the tasks in forked processes, results returned in shared memory
+    void evaluateProcesses();
+
     /// Reset the sparsity propagation
     virtual void spInit(bool use_fwd);
 
@@ -115,10 +122,19 @@ namespace casadi {
     std::vector<int> copy_of_;
 
     /// Parallelization modes
-    enum Mode {SERIAL, OPENMP, MPI};
+    enum Mode {SERIAL, OPENMP, THREADS, PROCESSES};
 
     /// Mode
     Mode mode_;
+
+    /// Number of worker threads or processes
+    int num_threads_;
+
+    /// Thread pool, THREADS mode only
+    OwnedThreadPool pool_;
+
+    /// Time spent on each task during the last call, used to distribute the tasks
+    std::vector<double> last_cputime_;
   };
 
 
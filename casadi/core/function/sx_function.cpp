@@ -173,6 +173,16 @@ SX SXFunction::getFree() const {
   return (*this)->free_vars_;
 }
 
+void SXFunction::evaluateBatch(const vector<const double*>& arg, const vector<double*>& res,
+                               int n, double* w) {
+  assertInit();
+  casadi_assert_message(arg.size()==getNumInputs(),
+                        "SXFunction::evaluateBatch: Wrong number of inputs");
+  casadi_assert_message(res.size()==getNumOutputs(),
+                        "SXFunction::evaluateBatch: Wrong number of outputs");
+  (*this)->evalDBatch(arg, res, n, w);
+}
+
 int SXFunction::getWorkSize() const {
   return (*this)->rtmp_.size();
 }
@@ -198,6 +198,22 @@ namespace casadi {
     /** \brief Access the algorithm directly */
     const std::vector<ScalarAtomic>& algorithm() const;
 #endif // SWIG
+/// \endcond
+
+/// \cond INTERNAL
+#ifndef SWIG
+    /** \brief Evaluate numerically for \a n input sets in a single pass over the algorithm
+     *
+     * Inputs and outputs are laid out as a structure of arrays: arg[i][k*n + j] holds
+     * nonzero k of input i for input set j, and likewise for res. Each atomic operation
+     * is then applied to n contiguous values, which allows the compiler to vectorize.
+     * Null pointers in \a arg are treated as zero, null pointers in \a res are skipped.
+     * The work vector \a w is owned by the caller and must hold getWorkSize()*n entries,
+     * so that separate calls with separate work vectors may run concurrently.
+     */
+    void evaluateBatch(const std::vector<const double*>& arg, const std::vector<double*>& res,
+                       int n, double* w);
+#endif // SWIG
 /// \endcond
 
     /** \brief Get the number of atomic operations */
@@ -30,6 +30,8 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <map>
+#include <cstring>
 #include "../std_vector_tools.hpp"
 #include "../sx/sx_tools.hpp"
 #include "../sx/sx_node.hpp"
@@ -51,6 +53,15 @@ namespace casadi {
               "compilation to a CPU or GPU using OpenCL");
     addOption("just_in_time_opencl", OT_BOOLEAN, false,
               "Just-in-time compilation for numeric evaluation using OpenCL (experimental)");
+    addOption("cse", OT_BOOLEAN, false,
+              "Merge structurally identical subexpressions when building the algorithm");
+    addOption("codegen_split", OT_INTEGER, 0,
+              "Split the generated code into functions of at most this many operations, "
+              "0 for a single function. Values that are live across the parts are passed "
+              "in the work vector. With dynamic compilation, the parts are placed in "
+              "separate translation units that are compiled in parallel. This shortens "
+              "the compile time of very large functions, but the generated code runs "
+              "slower, about 20% in codegen_split_benchmark.");
 
     // Check for duplicate entries among the input expressions
     bool has_duplicates = false;
@@ -167,6 +178,72 @@ namespace casadi {
   }
 
 
+  void SXFunctionInternal::evalDPermuted(const cpv_double& arg, const pv_double& res,
+                                         const std::vector<const std::vector<int>*>& perm,
+                                         int* itmp, double* rtmp) {
+    // Profiling, OpenCL and the error for free variables are handled by evalD
+    bool plain = free_vars_.empty() && !CasadiOptions::profiling;
+#ifdef WITH_OPENCL
+    plain = plain && !just_in_time_opencl_;
+#endif // WITH_OPENCL
+    if (!plain) return FunctionInternal::evalDPermuted(arg, res, perm, itmp, rtmp);
+
+    // As evalD, with nonzero i2 of output i0 written to position (*perm[i0])[i2]
+    for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      switch (it->op) {
+        CASADI_MATH_FUN_BUILTIN(rtmp[it->i1], rtmp[it->i2], rtmp[it->i0])
+        case OP_CONST: rtmp[it->i0] = it->d; break;
+        case OP_INPUT: rtmp[it->i0] = arg[it->i1][it->i2]; break;
+        case OP_OUTPUT:
+          if (res[it->i0]) {
+            const vector<int>* p = perm[it->i0];
+            res[it->i0][p==0 ? it->i2 : (*p)[it->i2]] = rtmp[it->i1];
+          }
+          break;
+      }
+    }
+  }
+
+  void SXFunctionInternal::evalDBatch(const cpv_double& arg, const pv_double& res, int n,
+                                      double* rtmp) {
+    casadi_log("SXFunctionInternal::evalDBatch():begin  " << getOption("name"));
+
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      repr(ss);
+      casadi_error("Cannot evaluate \"" << ss.str() << "\" since variables "
+                   << free_vars_ << " are free.");
+    }
+    casadi_assert_message(n>=0, "SXFunctionInternal::evalDBatch: Negative batch size");
+
+    // Evaluate the algorithm, one dispatch per instruction and n lanes per dispatch
+    for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      double* w0 = rtmp + it->i0*n;
+      switch (it->op) {
+      case OP_CONST:
+        fill_n(w0, n, it->d);
+        break;
+      case OP_INPUT:
+        if (arg[it->i1]) {
+          copy(arg[it->i1] + it->i2*n, arg[it->i1] + (it->i2+1)*n, w0);
+        } else {
+          fill_n(w0, n, 0.);
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[it->i0]) {
+          copy(rtmp + it->i1*n, rtmp + (it->i1+1)*n, res[it->i0] + it->i2*n);
+        }
+        break;
+      default:
+        // Element-wise over the lanes, the loops are vectorized by the compiler
+        casadi_math<double>::fun(it->op, rtmp + it->i1*n, rtmp + it->i2*n, w0, n);
+      }
+    }
+
+    casadi_log("SXFunctionInternal::evalDBatch():end " << getOption("name"));
+  }
+
   SX SXFunctionInternal::hess(int iind, int oind) {
     casadi_assert_message(output(oind).numel() == 1, "Function must be scalar");
     SX g = grad(iind, oind);
@@ -260,31 +337,117 @@ namespace casadi {
     // Add auxiliaries. TODO: Only add the auxiliaries that are actually used
     gen.addAuxiliary(CodeGenerator::AUX_SQ);
     gen.addAuxiliary(CodeGenerator::AUX_SIGN);
+
+    // Quick return if the function is not split
+    int nalg = algorithm_.size();
+    if (codegen_split_==0 || nalg<=codegen_split_) return;
+
+    // Values passed between the parts in the work vector
+    vector<bool> in_work;
+    liveAcrossParts(in_work);
+
+    // Define the parts, called in order by the body
+    vector<int> def(rtmp_.size(), -1);
+    for (int begin=0; begin<nalg; begin+=codegen_split_) {
+      stringstream name;
+      name << getSanitizedName() << "_p" << gen.n_parts_++;
+      stringstream part;
+      part << "void " << name.str() << "(const " << type << "* const* arg, " << type
+           << "* const* res, " << type << "* w) {" << endl;
+      generateSegment(part, type, gen, begin, std::min(begin+codegen_split_, nalg), in_work, def);
+      part << "}" << endl << endl;
+
+      if (gen.split_units_) {
+        // Separate translation unit, declare only
+        gen.units_.push_back(part.str());
+        stream << "void " << name.str() << "(const " << type << "* const* arg, " << type
+               << "* const* res, " << type << "* w);" << endl;
+      } else {
+        stream << part.str();
+      }
+    }
+    if (gen.split_units_) stream << endl;
   }
 
   void SXFunctionInternal::generateBody(std::ostream &stream, const std::string& type,
                                         CodeGenerator& gen) const {
+    // Current definition of each work vector element
+    vector<int> def(rtmp_.size(), -1);
+
+    // Single function
+    int nalg = algorithm_.size();
+    if (codegen_split_==0 || nalg<=codegen_split_) {
+      generateSegment(stream, type, gen, 0, nalg, vector<bool>(nalg, false), def);
+      return;
+    }
+
+    // Call the parts defined by generateDeclarations
+    int nparts = (nalg+codegen_split_-1)/codegen_split_;
+    for (int k=0; k<nparts; ++k) {
+      stream << "  " << getSanitizedName() << "_p" << (gen.n_parts_-nparts+k)
+             << "(arg, res, w);" << endl;
+    }
+  }
+
+  void SXFunctionInternal::liveAcrossParts(std::vector<bool>& in_work) const {
+    in_work.resize(algorithm_.size());
+    fill(in_work.begin(), in_work.end(), false);
+    vector<int> def(rtmp_.size(), -1);
+    for (int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      int part = k/codegen_split_;
+
+      // Operands, read before the result is written
+      int ndep = 0;
+      switch (e.op) {
+      case OP_CONST:
+      case OP_INPUT: ndep = 0; break;
+      case OP_OUTPUT: ndep = 1; break;
+      default: ndep = casadi_math<double>::ndeps(e.op);
+      }
+      if (ndep>=1 && def[e.i1]/codegen_split_!=part) in_work[def[e.i1]] = true;
+      if (ndep>=2 && def[e.i2]/codegen_split_!=part) in_work[def[e.i2]] = true;
+
+      // Result
+      if (e.op!=OP_OUTPUT) def[e.i0] = k;
+    }
+  }
+
+  void SXFunctionInternal::generateSegment(std::ostream &stream, const std::string& type,
+                                           CodeGenerator& gen, int begin, int end,
+                                           const std::vector<bool>& in_work,
+                                           std::vector<int>& def) const {
 
     // Which variables have been declared
     vector<bool> declared(rtmp_.size(), false);
 
     // Run the algorithm
-    for (vector<AlgEl>::const_iterator it = algorithm_.begin(); it!=algorithm_.end(); ++it) {
+    for (int k=begin; k<end; ++k) {
+      const AlgEl* it = &algorithm_[k];
+
       // Indent
       stream << "  ";
 
       if (it->op==OP_OUTPUT) {
         stream << "if (res[" << it->i0 << "]!=0) "
-               << "res["<< it->i0 << "][" << it->i2 << "]=" << "a" << it->i1;
-      } else {
-        // Declare result if not already declared
-        if (!declared[it->i0]) {
-          stream << type << " ";
-          declared[it->i0]=true;
+               << "res["<< it->i0 << "][" << it->i2 << "]=";
+        if (in_work[def[it->i1]]) {
+          stream << "w[" << it->i1 << "]";
+        } else {
+          stream << "a" << it->i1;
         }
-
+      } else {
         // Where to store the result
-        stream << "a" << it->i0 << "=";
+        if (in_work[k]) {
+          stream << "w[" << it->i0 << "]=";
+        } else {
+          // Declare result if not already declared
+          if (!declared[it->i0]) {
+            stream << type << " ";
+            declared[it->i0]=true;
+          }
+          stream << "a" << it->i0 << "=";
+        }
 
         // What to store
         if (it->op==OP_CONST) {
@@ -295,15 +458,19 @@ namespace casadi {
           int ndep = casadi_math<double>::ndeps(it->op);
           casadi_math<double>::printPre(it->op, stream);
           for (int c=0; c<ndep; ++c) {
-            if (c==0) {
-              stream << "a" << it->i1;
+            int ind = c==0 ? it->i1 : it->i2;
+            if (c!=0) casadi_math<double>::printSep(it->op, stream);
+            if (in_work[def[ind]]) {
+              stream << "w[" << ind << "]";
             } else {
-              casadi_math<double>::printSep(it->op, stream);
-              stream << "a" << it->i2;
+              stream << "a" << ind;
             }
           }
           casadi_math<double>::printPost(it->op, stream);
         }
+
+        // Update the current definition
+        def[it->i0] = k;
       }
       stream  << ";" << endl;
     }
@@ -350,6 +517,54 @@ namespace casadi {
       }
     }
 
+    // Nodes removed by common subexpression elimination
+    vector<SXNode*> duplicates;
+
+    // Eliminate common subexpressions
+    if (getOption("cse")) {
+      int n_before = nodes.size();
+
+      // Structurally identical operations and constants seen so far
+      map<pair<int, pair<int, int> >, int> op_map;
+      map<unsigned long long, int> const_map;
+
+      // Compact the list of nodes, a duplicate gets the place of the first occurrence
+      int k=0;
+      for (int i=0; i<nodes.size(); ++i) {
+        SXNode* t = nodes[i];
+        if (t!=0 && !t->isSymbolic()) {
+          // Place of an earlier, identical node, or k if there is none
+          int first;
+          if (t->isConstant()) {
+            // Compare bit patterns, so that e.g. 0 and -0 are not merged
+            double v = t->getValue();
+            unsigned long long v_bits;
+            memcpy(&v_bits, &v, sizeof(v_bits));
+            first = const_map.insert(make_pair(v_bits, k)).first->second;
+          } else {
+            int op = t->getOp();
+            int i1 = t->dep(0).get()->temp;
+            int i2 = t->dep(1).get()->temp;
+            if (operation_checker<CommChecker>(op) && i1>i2) swap(i1, i2);
+            first = op_map.insert(make_pair(make_pair(op, make_pair(i1, i2)), k)).first->second;
+          }
+          if (first!=k) {
+            t->temp = first;
+            duplicates.push_back(t);
+            continue;
+          }
+        }
+        if (t) t->temp = k;
+        nodes[k++] = t;
+      }
+      nodes.resize(k);
+
+      if (verbose()) {
+        cout << "SXFunctionInternal::init: Common subexpression elimination reduced the "
+             << "algorithm from " << n_before << " to " << nodes.size() << " elements" << endl;
+      }
+    }
+
     // Sort the nodes by type
     constants_.clear();
     operations_.clear();
@@ -507,6 +722,9 @@ namespace casadi {
         nodes[i]->temp = 0;
       }
     }
+    for (vector<SXNode*>::iterator it=duplicates.begin(); it!=duplicates.end(); ++it) {
+      (*it)->temp = 0;
+    }
 
     // Now mark each input's place in the algorithm
     for (vector<pair<int, SXNode*> >::const_iterator it=symb_loc.begin();
@@ -548,6 +766,10 @@ namespace casadi {
       }
     }
 
+    // Split the generated code into parts
+    codegen_split_ = getOption("codegen_split");
+    casadi_assert_message(codegen_split_>=0, "Option \"codegen_split\" must be nonnegative");
+
     // Initialize just-in-time compilation for numeric evaluation using OpenCL
     just_in_time_opencl_ = getOption("just_in_time_opencl");
     if (just_in_time_opencl_) {
@@ -991,6 +1213,112 @@ namespace casadi {
     }
   }
 
+  /// \cond INTERNAL
+  // Wide sparsity propagation with NW words per element, NW==0 means nw at runtime.
+  // A compile-time NW allows the compiler to unroll and vectorize the word loops.
+  template<int NW>
+  void spPropagateWide(const vector<ScalarAtomic>& algorithm, bool fwd, int iind,
+                       int oind, const bvec_t* seed, bvec_t* sens, bvec_t* w, int nw) {
+    const int n = NW>0 ? NW : nw;
+    if (fwd) {
+      for (vector<ScalarAtomic>::const_iterator it=algorithm.begin();
+           it!=algorithm.end(); ++it) {
+        switch (it->op) {
+        case OP_CONST:
+        case OP_PARAMETER:
+          for (int k=0; k<n; ++k) w[it->i0*n+k] = 0;
+          break;
+        case OP_INPUT:
+          if (it->i1==iind) {
+            for (int k=0; k<n; ++k) w[it->i0*n+k] = seed[it->i2*n+k];
+          } else {
+            for (int k=0; k<n; ++k) w[it->i0*n+k] = 0;
+          }
+          break;
+        case OP_OUTPUT:
+          if (it->i0==oind) {
+            const bvec_t* w1 = w + it->i1*n;
+            for (int k=0; k<n; ++k) sens[it->i2*n+k] = w1[k];
+          }
+          break;
+        default: // Unary or binary operation
+          {
+            bvec_t* w0 = w + it->i0*n;
+            const bvec_t* w1 = w + it->i1*n;
+            const bvec_t* w2 = w + it->i2*n;
+            for (int k=0; k<n; ++k) w0[k] = w1[k] | w2[k];
+          }
+        }
+      }
+    } else {
+      for (vector<ScalarAtomic>::const_reverse_iterator it=algorithm.rbegin();
+           it!=algorithm.rend(); ++it) {
+        switch (it->op) {
+        case OP_CONST:
+        case OP_PARAMETER:
+          for (int k=0; k<n; ++k) w[it->i0*n+k] = 0;
+          break;
+        case OP_INPUT:
+          {
+            bvec_t* w0 = w + it->i0*n;
+            if (it->i1==iind) {
+              for (int k=0; k<n; ++k) sens[it->i2*n+k] = w0[k];
+            }
+            for (int k=0; k<n; ++k) w0[k] = 0;
+          }
+          break;
+        case OP_OUTPUT:
+          if (it->i0==oind) {
+            bvec_t* w1 = w + it->i1*n;
+            for (int k=0; k<n; ++k) w1[k] |= seed[it->i2*n+k];
+          }
+          break;
+        default: // Unary or binary operation
+          {
+            // Note: the result may share its location with one of the arguments
+            bvec_t* w0 = w + it->i0*n;
+            bvec_t* w1 = w + it->i1*n;
+            bvec_t* w2 = w + it->i2*n;
+            for (int k=0; k<n; ++k) {
+              bvec_t s = w0[k];
+              w0[k] = 0;
+              w1[k] |= s;
+              w2[k] |= s;
+            }
+          }
+        }
+      }
+    }
+  }
+  /// \endcond
+
+  bool SXFunctionInternal::spCanEvaluateWide() {
+    return !just_in_time_sparsity_;
+  }
+
+  void SXFunctionInternal::spEvaluateWide(bool fwd, int iind, int oind, const bvec_t* seed,
+                                          bvec_t* sens, int nw, bvec_t* w) {
+    if (!spCanEvaluateWide()) {
+      FunctionInternal::spEvaluateWide(fwd, iind, oind, seed, sens, nw, w);
+      return;
+    }
+
+    // Clear the work vector, nw words per element
+    if (!fwd) fill_n(w, rtmp_.size()*nw, bvec_t(0));
+
+    // Sensitivities of nonzeros that do not appear in the algorithm are zero
+    int nz_sens = fwd ? output(oind).nnz() : input(iind).nnz();
+    fill_n(sens, nz_sens*nw, bvec_t(0));
+
+    switch (nw) {
+    case 1: spPropagateWide<1>(algorithm_, fwd, iind, oind, seed, sens, w, nw); break;
+    case 2: spPropagateWide<2>(algorithm_, fwd, iind, oind, seed, sens, w, nw); break;
+    case 4: spPropagateWide<4>(algorithm_, fwd, iind, oind, seed, sens, w, nw); break;
+    case 8: spPropagateWide<8>(algorithm_, fwd, iind, oind, seed, sens, w, nw); break;
+    default: spPropagateWide<0>(algorithm_, fwd, iind, oind, seed, sens, w, nw);
+    }
+  }
+
   Function SXFunctionInternal::getFullJacobian() {
     SX J = casadi::jacobian(veccat(outputv_), veccat(inputv_));
     return SXFunction(inputv_, J);
@@ -94,6 +94,21 @@ class CASADI_EXPORT SXFunctionInternal :
   /** \brief  Evaluate numerically, work vectors given */
   virtual void evalD(const cpv_double& arg, const pv_double& res, int* itmp, double* rtmp);
 
+  /** \brief  Evaluate numerically, the permuted outputs written directly to their place */
+  virtual void evalDPermuted(const cpv_double& arg, const pv_double& res,
+                             const std::vector<const std::vector<int>*>& perm,
+                             int* itmp, double* rtmp);
+
+  /** \brief  Can evalD be called concurrently, given separate work vectors? */
+  virtual bool isReentrant() const { return !just_in_time_opencl_;}
+
+  /** \brief  Evaluate numerically for \a n input sets at once, work vector given
+   * The inputs and outputs are stored as a structure of arrays: the value of nonzero
+   * \a k for input set \a j is found at position k*n + j. The work vector must have
+   * length rtmp_.size()*n.
+   */
+  void evalDBatch(const cpv_double& arg, const pv_double& res, int n, double* rtmp);
+
   /** \brief  evaluate symbolically while also propagating directional derivatives */
   virtual void evalSX(const std::vector<SX>& arg, std::vector<SX>& res);
 
@@ -162,6 +177,21 @@ class CASADI_EXPORT SXFunctionInternal :
   virtual void generateBody(std::ostream &stream, const std::string& type,
                             CodeGenerator& gen) const;
 
+  /** \brief Generate code for the algorithm elements in [begin, end)
+   * Values whose definition is marked in \a in_work are kept in the work vector rather
+   * than in local variables. \a def holds the position of the current definition of
+   * each work vector element and is updated.
+   */
+  void generateSegment(std::ostream &stream, const std::string& type, CodeGenerator& gen,
+                       int begin, int end, const std::vector<bool>& in_work,
+                       std::vector<int>& def) const;
+
+  /** \brief Mark the definitions that are used in a later part of a split function */
+  void liveAcrossParts(std::vector<bool>& in_work) const;
+
+  /// Maximum number of algorithm elements in each part of the generated code, 0 for no limit
+  int codegen_split_;
+
   /** \brief Clear the function from its symbolic representation, to free up memory,
    * no symbolic evaluations are possible after this */
   void clearSymbolic();
@@ -175,6 +205,13 @@ class CASADI_EXPORT SXFunctionInternal :
   /// Reset the sparsity propagation
   virtual void spInit(bool fwd);
 
+  /// Propagate several words per nonzero in a single pass over the algorithm
+  virtual void spEvaluateWide(bool fwd, int iind, int oind, const bvec_t* seed, bvec_t* sens,
+                              int nw, bvec_t* w);
+
+  /// Is the class able to propagate several words per nonzero in a single pass?
+  virtual bool spCanEvaluateWide();
+
   /** \brief Return Jacobian of all input elements with respect to all output elements */
   virtual Function getFullJacobian();
 
@@ -0,0 +1,170 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "thread_pool.hpp"
+#include "../casadi_exception.hpp"
+#ifdef USE_CXX11
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#endif // USE_CXX11
+
+using namespace std;
+
+namespace casadi {
+
+#ifdef USE_CXX11
+  ThreadPool::ThreadPool(int n) : queues_(n), queue_mtx_(n), stop_(false), generation_(0),
+      busy_(0) {
+    for (int w=0; w<n; ++w) workers_.push_back(thread(&ThreadPool::work, this, w));
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      lock_guard<mutex> lock(mtx_);
+      stop_ = true;
+    }
+    cv_start_.notify_all();
+    for (int w=0; w<workers_.size(); ++w) workers_[w].join();
+  }
+
+  void ThreadPool::run(Job& job, vector<double>& task_cost, vector<int>& task_allocation,
+                       int& n_stolen) {
+    int ntask = task_cost.size();
+    task_allocation.resize(ntask);
+    if (workers_.empty()) {
+      casadi_assert_message(ntask==0, "ThreadPool::run: No workers");
+      n_stolen = 0;
+      return;
+    }
+
+    // Initial distribution: the most expensive tasks first, each to the least loaded worker
+    vector<int> order(ntask);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(),
+                [&task_cost](int i, int j){ return task_cost[i]>task_cost[j];});
+    vector<double> load(workers_.size(), 0);
+    {
+      lock_guard<mutex> lock(mtx_);
+      for (int w=0; w<queues_.size(); ++w) queues_[w].clear();
+      for (vector<int>::const_iterator it=order.begin(); it!=order.end(); ++it) {
+        int w = min_element(load.begin(), load.end()) - load.begin();
+        queues_[w].push_back(*it);
+        load[w] += task_cost[*it];
+      }
+      job_ = &job;
+      cputime_ = &task_cost;
+      allocation_ = &task_allocation;
+      stolen_ = 0;
+      error_.clear();
+      busy_ = workers_.size();
+      generation_++;
+    }
+    cv_start_.notify_all();
+
+    // Wait for all workers to finish
+    unique_lock<mutex> lock(mtx_);
+    cv_done_.wait(lock, [this]{ return busy_==0;});
+    n_stolen = stolen_;
+    casadi_assert_message(error_.empty(), "ThreadPool: task failed: " << error_);
+  }
+
+  bool ThreadPool::pop(int w, int& task, bool& stolen) {
+    {
+      lock_guard<mutex> lock(queue_mtx_[w]);
+      if (!queues_[w].empty()) {
+        task = queues_[w].front();
+        queues_[w].pop_front();
+        stolen = false;
+        return true;
+      }
+    }
+    for (int k=1; k<queues_.size(); ++k) {
+      int v = (w+k) % queues_.size();
+      lock_guard<mutex> lock(queue_mtx_[v]);
+      if (!queues_[v].empty()) {
+        task = queues_[v].back();
+        queues_[v].pop_back();
+        stolen = true;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void ThreadPool::work(int w) {
+    unsigned long seen = 0;
+    while (true) {
+      {
+        unique_lock<mutex> lock(mtx_);
+        cv_start_.wait(lock, [this, seen]{ return stop_ || generation_!=seen;});
+        if (stop_) return;
+        seen = generation_;
+      }
+
+      // Process tasks until all queues are empty
+      int task, n_stolen = 0;
+      bool stolen;
+      string error;
+      while (pop(w, task, stolen)) {
+        if (stolen) n_stolen++;
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        try {
+          job_->evaluateTask(task, w);
+        } catch(exception& e) {
+          if (error.empty()) error = e.what();
+        }
+        (*cputime_)[task] = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+        (*allocation_)[task] = w;
+      }
+
+      // Report back
+      lock_guard<mutex> lock(mtx_);
+      stolen_ += n_stolen;
+      if (error_.empty()) error_ = error;
+      if (--busy_==0) cv_done_.notify_one();
+    }
+  }
+#endif // USE_CXX11
+
+  OwnedThreadPool::OwnedThreadPool(const OwnedThreadPool& other) : pool_(0) {
+    *this = other;
+  }
+
+  OwnedThreadPool& OwnedThreadPool::operator=(const OwnedThreadPool& other) {
+#ifdef USE_CXX11
+    if (this!=&other) reset(other.pool_==0 ? 0 : other.pool_->size());
+#endif // USE_CXX11
+    return *this;
+  }
+
+  void OwnedThreadPool::reset(int n) {
+#ifdef USE_CXX11
+    delete pool_;
+    pool_ = n>0 ? new ThreadPool(n) : 0;
+#endif // USE_CXX11
+  }
+
+} // namespace casadi
@@ -0,0 +1,141 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_THREAD_POOL_HPP
+#define CASADI_THREAD_POOL_HPP
+
+#include "../casadi_common.hpp"
+#include <vector>
+#include <string>
+#ifdef USE_CXX11
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#endif // USE_CXX11
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+#ifdef USE_CXX11
+  /** \brief Persistent pool of worker threads
+
+      Every worker has a queue of tasks. A worker that runs out of tasks steals
+      from the back of the queues of the other workers.
+  */
+  class CASADI_EXPORT ThreadPool {
+  public:
+    /// Work to be distributed over the pool
+    class Job {
+    public:
+      virtual ~Job() {}
+
+      /// Perform a task on a given worker
+      virtual void evaluateTask(int task, int worker) = 0;
+    };
+
+    /// Constructor, starts the workers
+    explicit ThreadPool(int n);
+
+    /// Destructor, stops the workers
+    ~ThreadPool();
+
+    /// Number of workers
+    int size() const { return workers_.size();}
+
+    /** \brief Perform all tasks of a job, blocking
+     *
+     * The tasks are initially distributed by their estimated cost \a task_cost,
+     * the most expensive first, each to the least loaded worker. On return, \a task_cost
+     * contains the measured times.
+     */
+    void run(Job& job, std::vector<double>& task_cost, std::vector<int>& task_allocation,
+             int& n_stolen);
+
+  private:
+    /// Get the next task for a worker, stealing if its own queue is empty
+    bool pop(int w, int& task, bool& stolen);
+
+    /// Main loop of a worker
+    void work(int w);
+
+    // Workers and their task queues
+    std::vector<std::thread> workers_;
+    std::vector<std::deque<int> > queues_;
+    std::vector<std::mutex> queue_mtx_;
+
+    // Synchronization of the calls
+    std::mutex mtx_;
+    std::condition_variable cv_start_, cv_done_;
+    bool stop_;
+    unsigned long generation_;
+    int busy_;
+
+    // Job, statistics and errors of the current call
+    Job* job_;
+    std::vector<double>* cputime_;
+    std::vector<int>* allocation_;
+    int stolen_;
+    std::string error_;
+  };
+#else // USE_CXX11
+  class ThreadPool {};
+#endif // USE_CXX11
+
+  /** \brief Thread pool owned by a function
+
+      Copying starts a new pool with the same number of workers, so the copy constructor
+      of the owner, and hence clone(), gives the copy its own workers. Without C++11,
+      the pool is never started.
+  */
+  class CASADI_EXPORT OwnedThreadPool {
+  public:
+    /// Default constructor, no pool
+    OwnedThreadPool() : pool_(0) {}
+
+    /// Copy constructor, starts a new pool of the same size
+    OwnedThreadPool(const OwnedThreadPool& other);
+
+    /// Assignment, starts a new pool of the same size
+    OwnedThreadPool& operator=(const OwnedThreadPool& other);
+
+    /// Destructor, stops the pool
+    ~OwnedThreadPool() { reset(0);}
+
+    /// (Re)start the pool with n workers, or stop it if n is zero
+    void reset(int n);
+
+    /// Access the pool
+    ThreadPool* operator->() const { return pool_;}
+
+  private:
+    ThreadPool* pool_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_THREAD_POOL_HPP
@@ -24,10 +24,362 @@
 
 
 #include "matrix.hpp"
+#include "sparsity_internal.hpp"
+#include <cmath>
 using namespace std;
 
 namespace casadi {
 
+  namespace {
+    /* Numerical LU factorization with partial pivoting, used for the determinant and
+     * inverse of DMatrix. Small or dense matrices are factorized as dense matrices,
+     * others with a left-looking sparse LU (cf. cs_lu in CSparse) with the columns
+     * ordered by approximate minimum degree. The sparse factorization stops at the first
+     * zero pivot, the dense one leaves the zero on the diagonal of U.
+     */
+    class NumericLU {
+    public:
+      explicit NumericLU(const DMatrix& A, bool dense=false);
+
+      /// Is the matrix (numerically) singular?
+      bool singular() const { return singular_;}
+
+      /// Dense factorization?
+      bool dense() const { return dense_;}
+
+      /// Determinant
+      double det() const;
+
+      /// Inverse, sparse if the matrix is reducible. Inf and nan entries if singular (dense only)
+      DMatrix inv();
+
+    private:
+      // Factorize as a dense matrix
+      void factorizeDense(const DMatrix& A);
+
+      // Factorize as a sparse matrix
+      void factorizeSparse(const DMatrix& A);
+
+      // Nonzeros reachable from the nonzeros of b in the graph of the triangular matrix G
+      int reach(const vector<int>& Gp, const vector<int>& Gi, const int* bi, int nb,
+                const int* pinv, vector<int>& xi);
+
+      // Sparse triangular solve, the pattern of x is returned in xi[top:n]
+      int spsolve(const vector<int>& Gp, const vector<int>& Gi, const vector<double>& Gx,
+                  const int* bi, const double* bx, int nb, vector<int>& xi,
+                  vector<double>& x, const int* pinv, bool lo);
+
+      // Parity of a permutation
+      static int parity(const vector<int>& p);
+
+      // Dimension
+      int n_;
+
+      // Dense or sparse factorization
+      bool dense_;
+
+      // Singular matrix
+      bool singular_;
+
+      // Dense factors, column major, L unit lower triangular and U upper triangular
+      vector<double> lu_;
+
+      // Row permutation: row i of A is row pinv_[i] of L*U, and column permutation
+      vector<int> pinv_, q_;
+
+      // Sparse factors, compressed column, row indices in pivot order,
+      // unit diagonal first in each column of L, diagonal last in each column of U
+      vector<int> Lp_, Li_, Up_, Ui_;
+      vector<double> Lx_, Ux_;
+
+      // Work vectors for the depth first search
+      vector<int> stack_, pstack_;
+      vector<bool> marked_;
+    };
+
+    NumericLU::NumericLU(const DMatrix& A, bool dense) : n_(A.size2()), singular_(false) {
+      casadi_assert_message(A.size1()==n_, "matrix must be square");
+      pinv_.resize(n_);
+      q_.resize(n_);
+      dense_ = dense || n_<=16 || 4*A.nnz()>=n_*n_;
+      if (dense_) {
+        factorizeDense(A);
+      } else {
+        factorizeSparse(A);
+      }
+    }
+
+    void NumericLU::factorizeDense(const DMatrix& A) {
+      // Dense copy, column major
+      lu_.assign(n_*n_, 0);
+      const int* colind = A.colind();
+      const int* row = A.row();
+      for (int c=0; c<n_; ++c) {
+        for (int k=colind[c]; k<colind[c+1]; ++k) lu_[row[k] + c*n_] = A.at(k);
+      }
+
+      // Gaussian elimination with partial pivoting
+      vector<int> perm(n_);
+      for (int i=0; i<n_; ++i) perm[i] = i;
+      for (int c=0; c<n_; ++c) q_[c] = c;
+      for (int k=0; k<n_; ++k) {
+        double* col_k = &lu_[k*n_];
+
+        // Find the pivot
+        int ipiv = k;
+        for (int i=k+1; i<n_; ++i) {
+          if (fabs(col_k[i])>fabs(col_k[ipiv])) ipiv = i;
+        }
+        if (col_k[ipiv]==0) {
+          // Nothing to eliminate, keep the zero pivot
+          singular_ = true;
+          continue;
+        }
+
+        // Swap rows
+        if (ipiv!=k) {
+          swap(perm[k], perm[ipiv]);
+          for (int c=0; c<n_; ++c) swap(lu_[k + c*n_], lu_[ipiv + c*n_]);
+        }
+
+        // Eliminate below the pivot
+        for (int i=k+1; i<n_; ++i) col_k[i] /= col_k[k];
+        for (int c=k+1; c<n_; ++c) {
+          double* col_c = &lu_[c*n_];
+          if (col_c[k]==0) continue;
+          for (int i=k+1; i<n_; ++i) col_c[i] -= col_k[i]*col_c[k];
+        }
+      }
+      for (int k=0; k<n_; ++k) pinv_[perm[k]] = k;
+    }
+
+    void NumericLU::factorizeSparse(const DMatrix& A) {
+      const int* colind = A.colind();
+      const int* row = A.row();
+
+      // Fill-reducing column ordering
+      q_ = A.sparsity()->approximateMinimumDegree(2);
+      q_.resize(n_);
+
+      // Factors, grown column by column
+      fill(pinv_.begin(), pinv_.end(), -1);
+      Lp_.assign(1, 0);
+      Up_.assign(1, 0);
+      Li_.clear();
+      Lx_.clear();
+      Ui_.clear();
+      Ux_.clear();
+
+      // Work vectors
+      vector<int> xi(n_);
+      vector<double> x(n_, 0);
+      for (int k=0; k<n_; ++k) {
+        // Solve for column k: x = L \ A(:, q(k))
+        int col = q_[k];
+        int top = spsolve(Lp_, Li_, Lx_, row+colind[col], getPtr(A.data())+colind[col],
+                          colind[col+1]-colind[col], xi, x, &pinv_.front(), true);
+
+        // Off-diagonal entries of U and the largest candidate for a pivot
+        int ipiv = -1;
+        double a = -1;
+        for (int p=top; p<n_; ++p) {
+          int i = xi[p];
+          if (pinv_[i]<0) {
+            if (fabs(x[i])>a) {
+              a = fabs(x[i]);
+              ipiv = i;
+            }
+          } else {
+            Ui_.push_back(pinv_[i]);
+            Ux_.push_back(x[i]);
+          }
+        }
+        if (ipiv<0 || a<=0) {
+          singular_ = true;
+          return;
+        }
+
+        // Prefer the diagonal if it is large enough
+        if (pinv_[col]<0 && fabs(x[col])>=a*0.1) ipiv = col;
+
+        // Diagonal entry of U, last in the column
+        double pivot = x[ipiv];
+        Ui_.push_back(k);
+        Ux_.push_back(pivot);
+        Up_.push_back(Ui_.size());
+
+        // Column of L, unit diagonal first
+        pinv_[ipiv] = k;
+        Li_.push_back(ipiv);
+        Lx_.push_back(1);
+        for (int p=top; p<n_; ++p) {
+          int i = xi[p];
+          if (pinv_[i]<0) {
+            Li_.push_back(i);
+            Lx_.push_back(x[i]/pivot);
+          }
+          x[i] = 0;
+        }
+        Lp_.push_back(Li_.size());
+      }
+
+      // Row indices of L in pivot order
+      for (int p=0; p<Li_.size(); ++p) Li_[p] = pinv_[Li_[p]];
+    }
+
+    int NumericLU::reach(const vector<int>& Gp, const vector<int>& Gi, const int* bi, int nb,
+                         const int* pinv, vector<int>& xi) {
+      stack_.resize(n_);
+      pstack_.resize(n_);
+      marked_.resize(n_, false);
+      int top = n_;
+      for (int p=0; p<nb; ++p) {
+        if (marked_[bi[p]]) continue;
+
+        // Depth first search starting at bi[p], cf. cs_dfs
+        int head = 0;
+        stack_[0] = bi[p];
+        while (head>=0) {
+          int j = stack_[head];
+          int jnew = pinv ? pinv[j] : j;
+          if (!marked_[j]) {
+            marked_[j] = true;
+            pstack_[head] = jnew<0 ? 0 : Gp[jnew];
+          }
+          bool done = true;
+          int p2 = jnew<0 ? 0 : Gp[jnew+1];
+          for (int q=pstack_[head]; q<p2; ++q) {
+            int i = Gi[q];
+            if (marked_[i]) continue;
+            pstack_[head] = q;
+            stack_[++head] = i;
+            done = false;
+            break;
+          }
+          if (done) {
+            head--;
+            xi[--top] = j;
+          }
+        }
+      }
+      for (int p=top; p<n_; ++p) marked_[xi[p]] = false;
+      return top;
+    }
+
+    int NumericLU::spsolve(const vector<int>& Gp, const vector<int>& Gi, const vector<double>& Gx,
+                           const int* bi, const double* bx, int nb, vector<int>& xi,
+                           vector<double>& x, const int* pinv, bool lo) {
+      int top = reach(Gp, Gi, bi, nb, pinv, xi);
+      for (int p=top; p<n_; ++p) x[xi[p]] = 0;
+      for (int p=0; p<nb; ++p) x[bi[p]] = bx[p];
+      for (int px=top; px<n_; ++px) {
+        int j = xi[px];
+        int J = pinv ? pinv[j] : j;
+        if (J<0) continue;
+        x[j] /= Gx[lo ? Gp[J] : Gp[J+1]-1];
+        int p = lo ? Gp[J]+1 : Gp[J];
+        int q = lo ? Gp[J+1] : Gp[J+1]-1;
+        for (; p<q; ++p) x[Gi[p]] -= Gx[p]*x[j];
+      }
+      return top;
+    }
+
+    int NumericLU::parity(const vector<int>& p) {
+      // Count the transpositions, cycle by cycle
+      int sign = 1;
+      vector<bool> visited(p.size(), false);
+      for (int i=0; i<p.size(); ++i) {
+        if (visited[i]) continue;
+        for (int j=p[i]; j!=i; j=p[j]) {
+          visited[j] = true;
+          sign = -sign;
+        }
+        visited[i] = true;
+      }
+      return sign;
+    }
+
+    double NumericLU::det() const {
+      if (singular_) return 0;
+      double ret = parity(pinv_)*parity(q_);
+      if (dense_) {
+        for (int k=0; k<n_; ++k) ret *= lu_[k + k*n_];
+      } else {
+        for (int k=0; k<n_; ++k) ret *= Ux_[Up_[k+1]-1];
+      }
+      return ret;
+    }
+
+    DMatrix NumericLU::inv() {
+      if (dense_) {
+        // Solve for the columns of the identity matrix
+        DMatrix ret = DMatrix::zeros(n_, n_);
+        vector<double>& r = ret.data();
+        for (int j=0; j<n_; ++j) {
+          double* x = &r[j*n_];
+          x[pinv_[j]] = 1;
+          for (int k=0; k<n_; ++k) {
+            for (int i=k+1; i<n_; ++i) x[i] -= lu_[i + k*n_]*x[k];
+          }
+          for (int k=n_-1; k>=0; --k) {
+            x[k] /= lu_[k + k*n_];
+            for (int i=0; i<k; ++i) x[i] -= lu_[i + k*n_]*x[k];
+          }
+        }
+        return ret;
+      }
+
+      // Sparse triangular solves, the pattern follows the block triangular structure
+      casadi_assert_message(!singular_, "inv: matrix is singular");
+      vector<int> colind(1, 0), row;
+      vector<double> data;
+      vector<int> xi(n_), yi;
+      vector<double> x(n_, 0), y(n_, 0), yx;
+      vector<pair<int, double> > col;
+      for (int j=0; j<n_; ++j) {
+        // L y = P e_j
+        int b = pinv_[j];
+        double one = 1;
+        int top = spsolve(Lp_, Li_, Lx_, &b, &one, 1, xi, y, 0, true);
+        yi.assign(xi.begin()+top, xi.end());
+        yx.resize(yi.size());
+        for (int p=0; p<yi.size(); ++p) yx[p] = y[yi[p]];
+
+        // U z = y, then undo the column permutation
+        top = spsolve(Up_, Ui_, Ux_, getPtr(yi), getPtr(yx), yi.size(), xi, x, 0, false);
+        col.clear();
+        for (int p=top; p<n_; ++p) col.push_back(make_pair(q_[xi[p]], x[xi[p]]));
+        sort(col.begin(), col.end());
+        for (int p=0; p<col.size(); ++p) {
+          row.push_back(col[p].first);
+          data.push_back(col[p].second);
+        }
+        colind.push_back(row.size());
+      }
+      return DMatrix(Sparsity(n_, n_, colind, row), data);
+    }
+  } // namespace
+
+  template<>
+  Matrix<double> Matrix<double>::zz_det() const {
+    // LU factorization instead of cofactor expansion
+    casadi_assert_message(size2() == size1(), "matrix must be square");
+    if (isScalar()) return toScalar();
+    return NumericLU(*this).det();
+  }
+
+  template<>
+  Matrix<double> Matrix<double>::zz_inv() const {
+    // LU factorization instead of the Laplace formula
+    casadi_assert_message(size2() == size1(), "matrix must be square");
+    NumericLU lu(*this);
+
+    // Singular matrices give inf and nan entries, as with the Laplace formula, rather than
+    // an error. Only the dense factorization runs to completion for those
+    if (lu.singular() && !lu.dense()) lu = NumericLU(*this, true);
+    return lu.inv();
+  }
+
   template<>
   bool Matrix<int>::isSlice(bool ind1) const {
     return isScalar() || (isVector() && isDense() && Slice::isSlice(data(), ind1));
@@ -865,6 +865,8 @@ namespace casadi {
   // Template specialization declarations
   template<> bool Matrix<int>::isSlice(bool ind1) const;
   template<> Slice Matrix<int>::toSlice(bool ind1) const;
+  template<> Matrix<double> Matrix<double>::zz_det() const;
+  template<> Matrix<double> Matrix<double>::zz_inv() const;
 
   // Typedefs initializations
   typedef Matrix<int> IMatrix;
@@ -538,6 +538,10 @@ namespace casadi {
     return (*this)->eliminationTree(ata);
   }
 
+  std::vector<int> Sparsity::nestedDissection(int leaf_size) const {
+    return (*this)->nestedDissection(leaf_size);
+  }
+
   int Sparsity::depthFirstSearch(int j, int top, std::vector<int>& xi,
                                  std::vector<int>& pstack, const std::vector<int>& pinv,
                                  std::vector<bool>& marked) const {
@@ -578,11 +582,12 @@ namespace casadi {
     (*this)->getNZ(indices);
   }
 
-  Sparsity Sparsity::unidirectionalColoring(const Sparsity& AT, int cutoff) const {
+  Sparsity Sparsity::unidirectionalColoring(const Sparsity& AT, int cutoff, int ordering,
+                                            int recolor) const {
     if (AT.isNull()) {
-      return (*this)->unidirectionalColoring(T(), cutoff);
+      return (*this)->unidirectionalColoring(T(), cutoff, ordering, recolor);
     } else {
-      return (*this)->unidirectionalColoring(AT, cutoff);
+      return (*this)->unidirectionalColoring(AT, cutoff, ordering, recolor);
     }
   }
 
@@ -594,10 +599,22 @@ namespace casadi {
     return (*this)->starColoring2(ordering, cutoff);
   }
 
+  Sparsity Sparsity::acyclicColoring(int ordering, int cutoff) const {
+    return (*this)->acyclicColoring(ordering, cutoff);
+  }
+
   std::vector<int> Sparsity::largestFirstOrdering() const {
     return (*this)->largestFirstOrdering();
   }
 
+  std::vector<int> Sparsity::smallestLastOrdering(const Sparsity& AT) const {
+    return (*this)->smallestLastOrdering(AT.isNull() ? T() : AT);
+  }
+
+  std::vector<int> Sparsity::incidenceDegreeOrdering(const Sparsity& AT) const {
+    return (*this)->incidenceDegreeOrdering(AT.isNull() ? T() : AT);
+  }
+
   Sparsity Sparsity::pmult(const std::vector<int>& p, bool permute_rows, bool permute_cols,
                            bool invert_permutation) const {
     return (*this)->pmult(p, permute_rows, permute_cols, invert_permutation);
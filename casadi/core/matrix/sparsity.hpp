@@ -644,6 +644,14 @@ namespace casadi {
     */
     std::vector<int> eliminationTree(bool ata=false) const;
 
+    /** \brief Nested dissection ordering of a square, structurally symmetric pattern
+        Fill-reducing ordering for Cholesky factorization based on recursive multilevel
+        bisection of the adjacency graph of A+A'. Subgraphs with at most leaf_size
+        vertices are ordered by approximate minimum degree. Returns a permutation p such
+        that A(p, p) has less fill.
+    */
+    std::vector<int> nestedDissection(int leaf_size=64) const;
+
     /** \brief Depth-first search on the adjacency graph of the sparsity
         See Direct Methods for Sparse Linear Systems by Davis (2006).
     */
@@ -708,27 +716,50 @@ namespace casadi {
 #endif // SWIG
 
     /** \brief Perform a unidirectional coloring: A greedy distance-2 coloring algorithm
-        (Algorithm 3.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN) */
+        (Algorithm 3.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN)
+        Ordering options: None (0), largest first (1), smallest last (2), incidence degree (3).
+        \a recolor passes of iterated greedy recoloring follow, which never increase the
+        number of colors.
+    */
     Sparsity unidirectionalColoring(const Sparsity& AT=Sparsity(),
-                                    int cutoff = std::numeric_limits<int>::max()) const;
+                                    int cutoff = std::numeric_limits<int>::max(),
+                                    int ordering = 0, int recolor = 0) const;
 
     /** \brief Perform a star coloring of a symmetric matrix:
         A greedy distance-2 coloring algorithm
         (Algorithm 4.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN)
-        Ordering options: None (0), largest first (1)
+        Ordering options: None (0), largest first (1), smallest last (2), incidence degree (3)
     */
     Sparsity starColoring(int ordering = 1, int cutoff = std::numeric_limits<int>::max()) const;
 
     /** \brief Perform a star coloring of a symmetric matrix:
         A new greedy distance-2 coloring algorithm
         (Algorithm 4.1 in A. H. GEBREMEDHIN, A. TARAFDAR, F. MANNE, A. POTHEN)
-        Ordering options: None (0), largest first (1)
+        Ordering options: None (0), largest first (1), smallest last (2), incidence degree (3)
     */
     Sparsity starColoring2(int ordering = 1, int cutoff = std::numeric_limits<int>::max()) const;
 
+    /** \brief Perform an acyclic coloring of a symmetric matrix:
+        A greedy distance-1 coloring in which every cycle uses at least three colors
+        (cf. Algorithm 3.1 in A. H. GEBREMEDHIN, A. TARAFDAR, F. MANNE, A. POTHEN).
+        Uses fewer colors than a star coloring, but the compressed Hessian must be
+        decompressed by substitution.
+        Ordering options: None (0), largest first (1), smallest last (2), incidence degree (3)
+    */
+    Sparsity acyclicColoring(int ordering = 1,
+                             int cutoff = std::numeric_limits<int>::max()) const;
+
     /** \brief Order the cols by decreasing degree */
     std::vector<int> largestFirstOrdering() const;
 
+    /** \brief Smallest-last ordering of the cols: repeatedly removes a col of minimum
+        degree in the column intersection graph (cols sharing a row) and places it last */
+    std::vector<int> smallestLastOrdering(const Sparsity& AT=Sparsity()) const;
+
+    /** \brief Incidence-degree ordering of the cols: repeatedly picks the col sharing a row
+        with the largest number of already ordered cols */
+    std::vector<int> incidenceDegreeOrdering(const Sparsity& AT=Sparsity()) const;
+
     /** \brief Permute rows and/or columns
         Multiply the sparsity with a permutation matrix from the left and/or from the right
         P * A * trans(P), A * trans(P) or A * trans(P) with P defined by an index vector
@@ -28,6 +28,7 @@
 #include <climits>
 #include <cstdlib>
 #include <cmath>
+#include <queue>
 #include "matrix.hpp"
 
 using namespace std;
@@ -1724,6 +1725,371 @@ namespace casadi {
     return P;
   }
 
+  namespace {
+    /// Undirected graph with vertex and edge weights (compressed adjacency lists)
+    struct NdGraph {
+      std::vector<int> xadj, adj, vwgt, ewgt;
+      int size() const { return xadj.size()-1;}
+    };
+
+    /// Coarsen a graph by heavy-edge matching, returns false if there was little progress
+    bool ndCoarsen(const NdGraph& g, NdGraph& cg, std::vector<int>& cmap) {
+      int n = g.size();
+
+      // Visit the vertices in order of increasing degree
+      std::vector<int> order(n), cnt(n+1, 0);
+      for (int v=0; v<n; ++v) cnt[g.xadj[v+1]-g.xadj[v]]++;
+      for (int d=0, s=0; d<=n; ++d) {
+        int c = cnt[d];
+        cnt[d] = s;
+        s += c;
+      }
+      for (int v=0; v<n; ++v) order[cnt[g.xadj[v+1]-g.xadj[v]]++] = v;
+
+      // Match each vertex with the unmatched neighbor with the heaviest edge
+      std::vector<int> match(n, -1);
+      for (int k=0; k<n; ++k) {
+        int v = order[k];
+        if (match[v]>=0) continue;
+        int best = v, best_w = -1;
+        for (int el=g.xadj[v]; el<g.xadj[v+1]; ++el) {
+          int u = g.adj[el];
+          if (match[u]<0 && u!=v && g.ewgt[el]>best_w) {
+            best = u;
+            best_w = g.ewgt[el];
+          }
+        }
+        match[v] = best;
+        match[best] = v;
+      }
+
+      // Number the coarse vertices
+      cmap.assign(n, -1);
+      std::vector<int> rep;
+      for (int v=0; v<n; ++v) {
+        if (cmap[v]>=0) continue;
+        cmap[v] = cmap[match[v]] = rep.size();
+        rep.push_back(v);
+      }
+      int cn = rep.size();
+      if (cn > 0.95*n) return false;
+
+      // Assemble the coarse graph, merging parallel edges
+      cg.xadj.resize(cn+1);
+      cg.xadj[0] = 0;
+      cg.vwgt.resize(cn);
+      cg.adj.clear();
+      cg.ewgt.clear();
+      std::vector<int> pos(cn, -1);
+      for (int cv=0; cv<cn; ++cv) {
+        int v = rep[cv];
+        cg.vwgt[cv] = g.vwgt[v] + (match[v]!=v ? g.vwgt[match[v]] : 0);
+        for (int i=0; i<2; ++i) {
+          if (i==1 && match[v]==v) break;
+          int w = i==0 ? v : match[v];
+          for (int el=g.xadj[w]; el<g.xadj[w+1]; ++el) {
+            int cu = cmap[g.adj[el]];
+            if (cu==cv) continue;
+            if (pos[cu]<0) {
+              pos[cu] = cg.adj.size();
+              cg.adj.push_back(cu);
+              cg.ewgt.push_back(g.ewgt[el]);
+            } else {
+              cg.ewgt[pos[cu]] += g.ewgt[el];
+            }
+          }
+        }
+        cg.xadj[cv+1] = cg.adj.size();
+        for (int el=cg.xadj[cv]; el<cg.xadj[cv+1]; ++el) pos[cg.adj[el]] = -1;
+      }
+      return true;
+    }
+
+    /// Weight of the edges cut by a bisection
+    int ndCut(const NdGraph& g, const std::vector<int>& part) {
+      int cut = 0;
+      for (int v=0; v<g.size(); ++v) {
+        for (int el=g.xadj[v]; el<g.xadj[v+1]; ++el) {
+          if (part[g.adj[el]]!=part[v]) cut += g.ewgt[el];
+        }
+      }
+      return cut/2;
+    }
+
+    /// Boundary Fiduccia-Mattheyses refinement of a bisection, sides at most maxw heavy
+    void ndRefine(const NdGraph& g, std::vector<int>& part, int maxw) {
+      int n = g.size();
+      int pw[2] = {0, 0};
+      for (int v=0; v<n; ++v) pw[part[v]] += g.vwgt[v];
+      std::vector<int> gain(n);
+      std::vector<bool> moved(n);
+      std::vector<int> moves;
+      for (int pass=0; pass<8; ++pass) {
+        // Gain of moving a vertex: external minus internal edge weight
+        std::priority_queue<std::pair<int, int> > queue;
+        for (int v=0; v<n; ++v) {
+          int ext = 0, in = 0;
+          for (int el=g.xadj[v]; el<g.xadj[v+1]; ++el) {
+            (part[g.adj[el]]!=part[v] ? ext : in) += g.ewgt[el];
+          }
+          gain[v] = ext-in;
+          if (ext>0) queue.push(std::make_pair(gain[v], v));
+        }
+        int cut = ndCut(g, part);
+        int best_cut = cut, best_imb = std::abs(pw[0]-pw[1]);
+        fill(moved.begin(), moved.end(), false);
+        moves.clear();
+        int n_best = 0;
+
+        // Move vertices greedily, allowing uphill moves
+        while (!queue.empty() && moves.size()-n_best < 100) {
+          int v = queue.top().second, gv = queue.top().first;
+          queue.pop();
+          if (moved[v] || gv!=gain[v]) continue;
+          int from = part[v], to = 1-from;
+          if (pw[to]+g.vwgt[v] > maxw) continue;
+          part[v] = to;
+          pw[from] -= g.vwgt[v];
+          pw[to] += g.vwgt[v];
+          cut -= gain[v];
+          gain[v] = -gain[v];
+          moved[v] = true;
+          moves.push_back(v);
+          for (int el=g.xadj[v]; el<g.xadj[v+1]; ++el) {
+            int u = g.adj[el];
+            gain[u] += part[u]==to ? -2*g.ewgt[el] : 2*g.ewgt[el];
+            if (!moved[u]) queue.push(std::make_pair(gain[u], u));
+          }
+          int imb = std::abs(pw[0]-pw[1]);
+          if (cut<best_cut || (cut==best_cut && imb<best_imb)) {
+            best_cut = cut;
+            best_imb = imb;
+            n_best = moves.size();
+          }
+        }
+
+        // Undo the moves after the best bisection
+        for (int k=moves.size()-1; k>=n_best; --k) {
+          int v = moves[k];
+          pw[part[v]] -= g.vwgt[v];
+          part[v] = 1-part[v];
+          pw[part[v]] += g.vwgt[v];
+        }
+        if (n_best==0) break;
+      }
+    }
+
+    /// Bisection by greedy graph growing from a few start vertices
+    void ndInitial(const NdGraph& g, std::vector<int>& part, int maxw) {
+      int n = g.size();
+      int total = 0;
+      for (int v=0; v<n; ++v) total += g.vwgt[v];
+      std::vector<int> trial(n), queue;
+      int best_cut = -1;
+      for (int t=0; t<4 && t<n; ++t) {
+        // Grow part 0 breadth first until it holds half of the weight
+        fill(trial.begin(), trial.end(), 1);
+        int w0 = 0, next = 0;
+        queue.clear();
+        queue.push_back((t*n)/4);
+        trial[queue[0]] = 0;
+        w0 += g.vwgt[queue[0]];
+        for (int k=0; 2*w0<total; ++k) {
+          if (k==queue.size()) {
+            // Disconnected graph: continue with the next vertex not yet in part 0
+            while (trial[next]==0) next++;
+            queue.push_back(next);
+            trial[next] = 0;
+            w0 += g.vwgt[next];
+            continue;
+          }
+          int v = queue[k];
+          for (int el=g.xadj[v]; el<g.xadj[v+1] && 2*w0<total; ++el) {
+            int u = g.adj[el];
+            if (trial[u]==0) continue;
+            trial[u] = 0;
+            w0 += g.vwgt[u];
+            queue.push_back(u);
+          }
+        }
+        ndRefine(g, trial, maxw);
+        int cut = ndCut(g, trial);
+        if (best_cut<0 || cut<best_cut) {
+          best_cut = cut;
+          part = trial;
+        }
+      }
+    }
+
+    /// Multilevel bisection
+    void ndBisect(const NdGraph& g, std::vector<int>& part, int maxw) {
+      NdGraph cg;
+      std::vector<int> cmap;
+      if (g.size()<=80 || !ndCoarsen(g, cg, cmap)) {
+        ndInitial(g, part, maxw);
+        return;
+      }
+      std::vector<int> cpart;
+      ndBisect(cg, cpart, maxw);
+      part.resize(g.size());
+      for (int v=0; v<g.size(); ++v) part[v] = cpart[cmap[v]];
+      ndRefine(g, part, maxw);
+    }
+
+    /// Augmenting path search for ndSeparator, from vertex v in part 0
+    bool ndAugment(const NdGraph& g, const std::vector<int>& part, int v,
+                   std::vector<int>& mate, std::vector<int>& visited, int stamp) {
+      for (int el=g.xadj[v]; el<g.xadj[v+1]; ++el) {
+        int u = g.adj[el];
+        if (part[u]==0 || visited[u]==stamp) continue;
+        visited[u] = stamp;
+        if (mate[u]<0 || ndAugment(g, part, mate[u], mate, visited, stamp)) {
+          mate[u] = v;
+          mate[v] = u;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /** Vertex separator from a bisection: a minimum vertex cover of the bipartite graph
+     * formed by the cut edges, obtained from a maximum matching (Koenig's theorem) */
+    void ndSeparator(const NdGraph& g, const std::vector<int>& part, std::vector<bool>& sep) {
+      int n = g.size();
+
+      // Maximum matching
+      std::vector<int> mate(n, -1), visited(n, -1);
+      for (int v=0; v<n; ++v) {
+        if (part[v]==0) ndAugment(g, part, v, mate, visited, v);
+      }
+
+      // Vertices reachable by alternating paths from unmatched vertices in part 0
+      std::vector<bool> reached(n, false);
+      std::vector<int> queue;
+      for (int v=0; v<n; ++v) {
+        if (part[v]==0 && mate[v]<0) {
+          reached[v] = true;
+          queue.push_back(v);
+        }
+      }
+      for (int k=0; k<queue.size(); ++k) {
+        int v = queue[k];
+        for (int el=g.xadj[v]; el<g.xadj[v+1]; ++el) {
+          int u = g.adj[el];
+          if (part[u]==0 || reached[u] || mate[v]==u) continue;
+          reached[u] = true;
+          if (mate[u]>=0 && !reached[mate[u]]) {
+            reached[mate[u]] = true;
+            queue.push_back(mate[u]);
+          }
+        }
+      }
+
+      // Cover: unreached matched vertices in part 0, reached vertices in part 1
+      sep.assign(n, false);
+      for (int v=0; v<n; ++v) {
+        if (part[v]==0 ? mate[v]>=0 && !reached[v] : reached[v]) sep[v] = true;
+      }
+    }
+
+    /// Subgraph induced by a set of vertices
+    void ndSubgraph(const NdGraph& g, const std::vector<int>& vert, std::vector<int>& loc,
+                    NdGraph& sg) {
+      for (int k=0; k<vert.size(); ++k) loc[vert[k]] = k;
+      sg.xadj.resize(vert.size()+1);
+      sg.xadj[0] = 0;
+      sg.adj.clear();
+      for (int k=0; k<vert.size(); ++k) {
+        int v = vert[k];
+        for (int el=g.xadj[v]; el<g.xadj[v+1]; ++el) {
+          if (loc[g.adj[el]]>=0) sg.adj.push_back(loc[g.adj[el]]);
+        }
+        sg.xadj[k+1] = sg.adj.size();
+      }
+      for (int k=0; k<vert.size(); ++k) loc[vert[k]] = -1;
+      sg.vwgt.assign(vert.size(), 1);
+      sg.ewgt.assign(sg.adj.size(), 1);
+    }
+
+    /// Order a subgraph, whose vertex k is label[k], by nested dissection
+    void ndOrder(const NdGraph& g, const std::vector<int>& label, int leaf_size,
+                 std::vector<int>& loc, std::vector<int>& order) {
+      int n = g.size();
+      std::vector<int> part, sub[3];
+      if (n>leaf_size && n>2) {
+        // Bisect
+        int maxw = n/2 + std::max(1, n/20);
+        ndBisect(g, part, maxw);
+
+        // Vertex separator
+        std::vector<bool> sep;
+        ndSeparator(g, part, sep);
+        for (int v=0; v<n; ++v) sub[sep[v] ? 2 : part[v]].push_back(v);
+      }
+
+      // Order small or inseparable subgraphs by minimum degree
+      if (part.empty() || sub[0].size()==n || sub[1].size()==n) {
+        std::vector<int> row, col;
+        for (int v=0; v<n; ++v) {
+          row.push_back(v);
+          col.push_back(v);
+          for (int el=g.xadj[v]; el<g.xadj[v+1]; ++el) {
+            row.push_back(g.adj[el]);
+            col.push_back(v);
+          }
+        }
+        std::vector<int> p;
+        if (n>2) {
+          p = Sparsity::triplet(n, n, row, col)->approximateMinimumDegree(1);
+          p.resize(n);
+        } else {
+          p = range(n);
+        }
+        for (int k=0; k<n; ++k) order.push_back(label[p[k]]);
+        return;
+      }
+
+      // Order the two parts recursively, followed by the separator
+      for (int i=0; i<2; ++i) {
+        if (sub[i].empty()) continue;
+        NdGraph sg;
+        ndSubgraph(g, sub[i], loc, sg);
+        std::vector<int> slabel(sub[i].size());
+        for (int k=0; k<sub[i].size(); ++k) slabel[k] = label[sub[i][k]];
+        ndOrder(sg, slabel, leaf_size, loc, order);
+      }
+      for (int k=0; k<sub[2].size(); ++k) order.push_back(label[sub[2][k]]);
+    }
+  } // namespace
+
+  std::vector<int> SparsityInternal::nestedDissection(int leaf_size) const {
+    casadi_assert_message(size1()==size2(), "nestedDissection: matrix must be square, got "
+                          << dimString() << ".");
+    int n = size2();
+
+    // Adjacency graph of A+A', without the diagonal
+    Sparsity C = patternCombine(T(), false, false);
+    const int* C_colind = C.colind();
+    const int* C_row = C.row();
+    NdGraph g;
+    g.xadj.resize(n+1);
+    g.xadj[0] = 0;
+    for (int cc=0; cc<n; ++cc) {
+      for (int el=C_colind[cc]; el<C_colind[cc+1]; ++el) {
+        if (C_row[el]!=cc) g.adj.push_back(C_row[el]);
+      }
+      g.xadj[cc+1] = g.adj.size();
+    }
+    g.vwgt.assign(n, 1);
+    g.ewgt.assign(g.adj.size(), 1);
+
+    // Order recursively
+    std::vector<int> order, loc(n, -1);
+    order.reserve(n);
+    ndOrder(g, range(n), std::max(leaf_size, 1), loc, order);
+    return order;
+  }
+
   int SparsityInternal::scatter(int j, std::vector<int>& w, int mark, int* Ci, int nz) const {
     int i, p;
     const int *Ap = colind();
@@ -1760,7 +2126,7 @@ namespace casadi {
     // allocate result
     vector<int> C_colind(n+1, 0), C_row;
 
-    C_colind.resize(anz + bnz);
+    C_row.resize(anz + bnz);
 
     int* Cp = &C_colind.front();
     for (int j=0; j<n; ++j) {
@@ -3134,26 +3500,120 @@ namespace casadi {
 ;
   }
 
+  Sparsity SparsityInternal::unidirectionalColoring(const Sparsity& AT, int cutoff,
+                                                    int ordering, int recolor) const {
+    casadi_assert_message(recolor>=0, "Number of recoloring passes must be nonnegative");
+
+    // Quick return if natural ordering without recoloring
+    if (ordering==0 && recolor==0) return unidirectionalColoring(AT, cutoff);
+
+    // Access the sparsity of the transpose
+    const int* AT_colind = AT.colind();
+    const int* AT_row = AT.row();
+    const int* colind = this->colind();
+    const int* row = this->row();
+
+    // Order in which the columns are colored
+    vector<int> ord = coloringOrdering(AT, ordering);
+
+    // Allocate temporary vectors
+    vector<int> forbiddenColors;
+    forbiddenColors.reserve(size2());
+    vector<int> color(size2());
+    vector<int> class_size, class_pos, class_offset;
+
+    // Greedy coloring, then the recoloring passes
+    for (int pass=0; pass<=recolor; ++pass) {
+
+      // Iterated greedy: visit the color classes of the previous pass one after the other,
+      // which cannot increase the number of colors
+      if (pass>0) {
+        int num_colors = forbiddenColors.size();
+        class_size.resize(num_colors);
+        fill(class_size.begin(), class_size.end(), 0);
+        for (int i=0; i<size2(); ++i) class_size[color[i]]++;
+
+        // Position of each color class
+        class_pos.resize(num_colors);
+        if (pass%2==1) {
+          // Reverse order of the classes
+          for (int c=0; c<num_colors; ++c) class_pos[c] = num_colors-1-c;
+        } else {
+          // Largest classes first (bucket sort)
+          class_offset.resize(size2()+2);
+          fill(class_offset.begin(), class_offset.end(), 0);
+          for (int c=0; c<num_colors; ++c) class_offset[size2()-class_size[c]+1]++;
+          for (int s=0; s<=size2(); ++s) class_offset[s+1] += class_offset[s];
+          for (int c=num_colors-1; c>=0; --c) {
+            class_pos[c] = class_offset[size2()-class_size[c]]++;
+          }
+        }
+
+        // New ordering
+        class_offset.resize(num_colors+1);
+        fill(class_offset.begin(), class_offset.end(), 0);
+        for (int c=0; c<num_colors; ++c) class_offset[class_pos[c]+1] = class_size[c];
+        for (int c=0; c<num_colors; ++c) class_offset[c+1] += class_offset[c];
+        for (int i=0; i<size2(); ++i) ord[class_offset[class_pos[color[i]]]++] = i;
+      }
+
+      // Greedy coloring in the order given by ord
+      fill(color.begin(), color.end(), -1);
+      forbiddenColors.clear();
+      for (int k=0; k<ord.size(); ++k) {
+        int i = ord[k];
+
+        // Forbid the colors of the columns sharing a row with column i
+        for (int el=colind[i]; el<colind[i+1]; ++el) {
+          int c = row[el];
+          for (int el_prev=AT_colind[c]; el_prev<AT_colind[c+1]; ++el_prev) {
+            int color_prev = color[AT_row[el_prev]];
+            if (color_prev>=0) forbiddenColors[color_prev] = i;
+          }
+        }
+
+        // Get the first nonforbidden color
+        int color_i;
+        for (color_i=0; color_i<forbiddenColors.size(); ++color_i) {
+          // Break if color is ok
+          if (forbiddenColors[color_i]!=i) break;
+        }
+        color[i] = color_i;
+
+        // Add color if reached end
+        if (color_i==forbiddenColors.size()) {
+          forbiddenColors.push_back(-1);
+
+          // Cutoff if too many colors
+          if (forbiddenColors.size()>cutoff) {
+            return Sparsity();
+          }
+        }
+      }
+    }
+
+    // Return sparsity in sparse triplet format
+    return Sparsity::triplet(size2(), forbiddenColors.size(), range(color.size()), color);
+  }
+
   Sparsity SparsityInternal::starColoring2(int ordering, int cutoff) const {
     casadi_assert_warning(size2()==size1(),
                           "StarColoring requires a square matrix, but got "
                           << dimString() << ".");
 
-    // TODO(Joel): What we need here, is a distance-2 smallest last ordering
     // Reorder, if necessary
     const int* colind = this->colind();
     const int* row = this->row();
     if (ordering!=0) {
-      casadi_assert(ordering==1);
-
       // Ordering
-      vector<int> ord = largestFirstOrdering();
+      vector<int> ord = coloringOrdering(shared_from_this<Sparsity>(), ordering);
 
       // Create a new sparsity pattern
       Sparsity sp_permuted = pmult(ord, true, true, true);
 
       // Star coloring for the permuted matrix
-      Sparsity ret_permuted = sp_permuted.starColoring2(0);
+      Sparsity ret_permuted = sp_permuted.starColoring2(0, cutoff);
+      if (ret_permuted.isNull()) return Sparsity();
 
       // Permute result back
       return ret_permuted.pmult(ord, true, false, false);
@@ -3391,16 +3851,15 @@ namespace casadi {
                           << dimString() << ".");
     // Reorder, if necessary
     if (ordering!=0) {
-      casadi_assert(ordering==1);
-
       // Ordering
-      vector<int> ord = largestFirstOrdering();
+      vector<int> ord = coloringOrdering(shared_from_this<Sparsity>(), ordering);
 
       // Create a new sparsity pattern
       Sparsity sp_permuted = pmult(ord, true, true, true);
 
       // Star coloring for the permuted matrix
-      Sparsity ret_permuted = sp_permuted.starColoring(0);
+      Sparsity ret_permuted = sp_permuted.starColoring(0, cutoff);
+      if (ret_permuted.isNull()) return Sparsity();
 
       // Permute result back
       return ret_permuted.pmult(ord, true, false, false);
@@ -3496,6 +3955,133 @@ namespace casadi {
     return Sparsity::triplet(size2(), num_colors, range(color.size()), color);
   }
 
+  Sparsity SparsityInternal::acyclicColoring(int ordering, int cutoff) const {
+    casadi_assert_message(isSymmetric(), "AcyclicColoring requires a symmetric pattern, but got "
+                          << dimString() << ".");
+    // Reorder, if necessary
+    if (ordering!=0) {
+      // Ordering
+      vector<int> ord = coloringOrdering(shared_from_this<Sparsity>(), ordering);
+
+      // Create a new sparsity pattern
+      Sparsity sp_permuted = pmult(ord, true, true, true);
+
+      // Acyclic coloring for the permuted matrix
+      Sparsity ret_permuted = sp_permuted.acyclicColoring(0, cutoff);
+      if (ret_permuted.isNull()) return Sparsity();
+
+      // Permute result back
+      return ret_permuted.pmult(ord, true, false, false);
+    }
+
+    // An edge is identified by the first of its two nonzeros
+    const int* colind = this->colind();
+    const int* row = this->row();
+    vector<int> Tmapping;
+    transpose(Tmapping);
+    for (int el=0; el<Tmapping.size(); ++el) Tmapping[el] = min(el, Tmapping[el]);
+
+    // Disjoint sets of the edges between colored vertices: the two-colored trees
+    vector<int> parent(nnz(), -1);
+
+    // First visit to a two-colored tree, by vertex and neighbor
+    vector<int> firstVisitV(nnz(), -1), firstVisitW(nnz(), -1);
+
+    // Allocate temporary vectors
+    vector<int> forbiddenColors;
+    forbiddenColors.reserve(size2());
+    vector<int> color(size2(), -1);
+
+    // For each color, the last edge of the current vertex to a neighbor of that color
+    vector<int> lastEdge, lastEdgeOwner;
+
+    for (int v=0; v<size2(); ++v) {
+
+      // Forbid the colors of the neighbors
+      for (int w_el=colind[v]; w_el<colind[v+1]; ++w_el) {
+        int w = row[w_el];
+        if (w!=v && color[w]!=-1) forbiddenColors[color[w]] = v;
+      }
+
+      // A color is forbidden if v would connect a two-colored tree through two neighbors
+      for (int w_el=colind[v]; w_el<colind[v+1]; ++w_el) {
+        int w = row[w_el];
+        if (w==v || color[w]==-1) continue;
+        for (int x_el=colind[w]; x_el<colind[w+1]; ++x_el) {
+          int x = row[x_el];
+          if (x==w || x==v || color[x]==-1 || forbiddenColors[color[x]]==v) continue;
+
+          // Root of the tree containing the edge wx
+          int t = Tmapping[x_el];
+          while (parent[t]!=t) t = parent[t] = parent[parent[t]];
+
+          if (firstVisitV[t]!=v) {
+            firstVisitV[t] = v;
+            firstVisitW[t] = w;
+          } else if (firstVisitW[t]!=w) {
+            forbiddenColors[color[x]] = v;
+          }
+        }
+      }
+
+      // color[v] <- min {c > 0 : forbiddenColors[c] != v}
+      bool new_color = true;
+      for (int color_i=0; color_i<forbiddenColors.size(); ++color_i) {
+        // Break if color is ok
+        if (forbiddenColors[color_i]!=v) {
+          color[v] = color_i;
+          new_color = false;
+          break;
+        }
+      }
+
+      // New color if reached end
+      if (new_color) {
+        color[v] = forbiddenColors.size();
+        forbiddenColors.push_back(-1);
+        lastEdge.push_back(-1);
+        lastEdgeOwner.push_back(-1);
+
+        // Cutoff if too many colors
+        if (forbiddenColors.size()>cutoff) {
+          return Sparsity();
+        }
+      }
+
+      // Add the edges of v to the two-colored trees
+      for (int w_el=colind[v]; w_el<colind[v+1]; ++w_el) {
+        int w = row[w_el];
+        if (w==v || color[w]==-1) continue;
+        int e = Tmapping[w_el];
+        parent[e] = e;
+
+        // Join the tree of w in the subgraph of colors color[v] and color[w]
+        for (int x_el=colind[w]; x_el<colind[w+1]; ++x_el) {
+          int x = row[x_el];
+          if (x==w || x==v || color[x]!=color[v]) continue;
+          int t = Tmapping[x_el];
+          while (parent[t]!=t) t = parent[t] = parent[parent[t]];
+          parent[t] = e;
+          break;
+        }
+
+        // Join the edges to the other neighbors with the same color
+        int cw = color[w];
+        if (lastEdgeOwner[cw]==v) {
+          int t = lastEdge[cw];
+          while (parent[t]!=t) t = parent[t] = parent[parent[t]];
+          if (t!=e) parent[t] = e;
+        } else {
+          lastEdgeOwner[cw] = v;
+        }
+        lastEdge[cw] = e;
+      }
+    }
+
+    // Return sparsity in sparse triplet format
+    return Sparsity::triplet(size2(), forbiddenColors.size(), range(color.size()), color);
+  }
+
   std::vector<int> SparsityInternal::largestFirstOrdering() const {
     vector<int> degree = getColind();
     int max_degree = 0;
@@ -3531,6 +4117,151 @@ namespace casadi {
     return reverse_ordering;
   }
 
+  std::vector<int> SparsityInternal::smallestLastOrdering(const Sparsity& AT) const {
+    const int* AT_colind = AT.colind();
+    const int* AT_row = AT.row();
+    const int* colind = this->colind();
+    const int* row = this->row();
+    int n = size2();
+
+    // Degree of each column in the column intersection graph
+    vector<int> mark(n, -1), degree(n, 0);
+    int max_degree = 0;
+    for (int i=0; i<n; ++i) {
+      mark[i] = i;
+      for (int el=colind[i]; el<colind[i+1]; ++el) {
+        int r = row[el];
+        for (int el2=AT_colind[r]; el2<AT_colind[r+1]; ++el2) {
+          int j = AT_row[el2];
+          if (mark[j]!=i) {
+            mark[j] = i;
+            degree[i]++;
+          }
+        }
+      }
+      max_degree = max(max_degree, degree[i]);
+    }
+
+    // Doubly linked lists of the columns with a given degree
+    vector<int> head(max_degree+1, -1), next(n), prev(n);
+    for (int i=n-1; i>=0; --i) {
+      prev[i] = -1;
+      next[i] = head[degree[i]];
+      if (next[i]>=0) prev[next[i]] = i;
+      head[degree[i]] = i;
+    }
+
+    // Remove a column of smallest degree and place it last among the remaining ones
+    vector<int> ordering(n);
+    vector<bool> removed(n, false);
+    fill(mark.begin(), mark.end(), -1);
+    int min_degree = 0;
+    for (int k=n-1; k>=0; --k) {
+      while (head[min_degree]<0) min_degree++;
+      int v = head[min_degree];
+      head[min_degree] = next[v];
+      if (next[v]>=0) prev[next[v]] = -1;
+      removed[v] = true;
+      ordering[k] = v;
+
+      // The remaining neighbors lose one degree
+      for (int el=colind[v]; el<colind[v+1]; ++el) {
+        int r = row[el];
+        for (int el2=AT_colind[r]; el2<AT_colind[r+1]; ++el2) {
+          int w = AT_row[el2];
+          if (removed[w] || mark[w]==v) continue;
+          mark[w] = v;
+
+          // Move to the list of degree one less
+          if (prev[w]>=0) {
+            next[prev[w]] = next[w];
+          } else {
+            head[degree[w]] = next[w];
+          }
+          if (next[w]>=0) prev[next[w]] = prev[w];
+          degree[w]--;
+          prev[w] = -1;
+          next[w] = head[degree[w]];
+          if (next[w]>=0) prev[next[w]] = w;
+          head[degree[w]] = w;
+        }
+      }
+
+      // The smallest degree decreases by at most one
+      if (min_degree>0) min_degree--;
+    }
+
+    return ordering;
+  }
+
+  std::vector<int> SparsityInternal::incidenceDegreeOrdering(const Sparsity& AT) const {
+    const int* AT_colind = AT.colind();
+    const int* AT_row = AT.row();
+    const int* colind = this->colind();
+    const int* row = this->row();
+    int n = size2();
+
+    // Doubly linked lists of the columns with a given number of ordered neighbors
+    vector<int> incidence(n, 0), head(n+1, -1), next(n), prev(n);
+    for (int i=n-1; i>=0; --i) {
+      prev[i] = -1;
+      next[i] = head[0];
+      if (next[i]>=0) prev[next[i]] = i;
+      head[0] = i;
+    }
+
+    // Pick a column with the largest number of ordered neighbors
+    vector<int> ordering(n), mark(n, -1);
+    vector<bool> ordered(n, false);
+    int max_incidence = 0;
+    for (int k=0; k<n; ++k) {
+      while (head[max_incidence]<0) max_incidence--;
+      int v = head[max_incidence];
+      head[max_incidence] = next[v];
+      if (next[v]>=0) prev[next[v]] = -1;
+      ordered[v] = true;
+      ordering[k] = v;
+
+      // The unordered neighbors gain one ordered neighbor
+      for (int el=colind[v]; el<colind[v+1]; ++el) {
+        int r = row[el];
+        for (int el2=AT_colind[r]; el2<AT_colind[r+1]; ++el2) {
+          int w = AT_row[el2];
+          if (ordered[w] || mark[w]==v) continue;
+          mark[w] = v;
+
+          // Move to the list of incidence one more
+          if (prev[w]>=0) {
+            next[prev[w]] = next[w];
+          } else {
+            head[incidence[w]] = next[w];
+          }
+          if (next[w]>=0) prev[next[w]] = prev[w];
+          incidence[w]++;
+          prev[w] = -1;
+          next[w] = head[incidence[w]];
+          if (next[w]>=0) prev[next[w]] = w;
+          head[incidence[w]] = w;
+          max_incidence = max(max_incidence, incidence[w]);
+        }
+      }
+    }
+
+    return ordering;
+  }
+
+  std::vector<int> SparsityInternal::coloringOrdering(const Sparsity& AT, int ordering) const {
+    switch (ordering) {
+    case 0: return range(size2());
+    case 1: return largestFirstOrdering();
+    case 2: return smallestLastOrdering(AT);
+    case 3: return incidenceDegreeOrdering(AT);
+    default: casadi_error("Unknown coloring ordering " << ordering << ", expected none (0), "
+                          "largest first (1), smallest last (2) or incidence degree (3).");
+    }
+    return vector<int>();
+  }
+
   Sparsity SparsityInternal::pmult(const std::vector<int>& p, bool permute_rows,
                                    bool permute_columns, bool invert_permutation) const {
     // Invert p, possibly
@@ -201,6 +201,16 @@ namespace casadi {
      */
     std::vector<int> approximateMinimumDegree(int order) const;
 
+    /** \brief Nested dissection ordering of A+A'
+     *
+     * Multilevel recursive bisection of the adjacency graph: the graph is coarsened by
+     * heavy-edge matching, bisected by greedy graph growing and the bisection is refined
+     * by boundary Fiduccia-Mattheyses passes while uncoarsening. A minimum vertex cover of the
+     * cut edges forms a separator, which is ordered after the two parts. Subgraphs
+     * with at most \a leaf_size vertices are ordered by approximateMinimumDegree.
+     */
+    std::vector<int> nestedDissection(int leaf_size) const;
+
     /// symbolic ordering and analysis for QR or LU: See cs_sqr in CSparse
     void prefactorize(int order, int qr, std::vector<int>& pinv, std::vector<int>& q,
                       std::vector<int>& parent, std::vector<int>& cp, std::vector<int>& leftmost,
@@ -410,6 +420,16 @@ namespace casadi {
      */
     Sparsity unidirectionalColoring(const Sparsity& AT, int cutoff) const;
 
+    /** \brief Perform a unidirectional coloring with a vertex ordering
+     *
+     * Greedy distance-2 coloring visiting the columns in the order given by \a ordering
+     * (cf. coloringOrdering), followed by \a recolor passes of iterated greedy recoloring
+     * (J. C. CULBERSON, Iterated greedy graph coloring and the difficulty landscape).
+     * A recoloring pass never increases the number of colors.
+     */
+    Sparsity unidirectionalColoring(const Sparsity& AT, int cutoff, int ordering,
+                                    int recolor) const;
+
     /** \brief Perform a star coloring of a symmetric matrix
      *
      * A greedy distance-2 coloring algorithm
@@ -424,9 +444,40 @@ namespace casadi {
      */
     Sparsity starColoring2(int ordering, int cutoff) const;
 
+    /** \brief Perform an acyclic coloring of a symmetric matrix
+     *
+     * A greedy distance-1 coloring in which every cycle uses at least three colors, tracking
+     * the two-colored trees with disjoint sets
+     * (cf. Algorithm 3.1 in A. H. GEBREMEDHIN, A. TARAFDAR, F. MANNE, A. POTHEN).
+     * Needs fewer colors than a star coloring, but the Hessian must be recovered by
+     * substitution rather than directly.
+     */
+    Sparsity acyclicColoring(int ordering, int cutoff) const;
+
     /// Order the columns by decreasing degree
     std::vector<int> largestFirstOrdering() const;
 
+    /** \brief Smallest-last ordering of the column intersection graph
+     *
+     * Repeatedly removes a column of minimum degree, which is placed last among the
+     * remaining ones (D. W. MATULA, L. L. BECK). Two columns are adjacent if they share a row,
+     * \a AT is the transpose of the pattern.
+     */
+    std::vector<int> smallestLastOrdering(const Sparsity& AT) const;
+
+    /** \brief Incidence-degree ordering of the column intersection graph
+     *
+     * Repeatedly picks the column adjacent to the largest number of already ordered columns.
+     * \a AT is the transpose of the pattern.
+     */
+    std::vector<int> incidenceDegreeOrdering(const Sparsity& AT) const;
+
+    /** \brief Column ordering for graph coloring
+     *
+     * None (0), largest first (1), smallest last (2), incidence degree (3)
+     */
+    std::vector<int> coloringOrdering(const Sparsity& AT, int ordering) const;
+
     /// Permute rows and/or columns
     Sparsity pmult(const std::vector<int>& p, bool permute_rows=true, bool permute_cols=true,
                    bool invert_permutation=false) const;
@@ -104,6 +104,9 @@ namespace casadi {
     /// Get number of temporary variables needed
     virtual void nTmp(size_t& ni, size_t& nr);
 
+    /// Can evalD be called concurrently, given separate work vectors?
+    virtual bool isReentrant() const { return fcn_.isReentrant();}
+
     // Function to be evaluated
     Function fcn_;
   };
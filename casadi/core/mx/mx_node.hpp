@@ -224,6 +224,9 @@ namespace casadi {
     /// Get number of temporary variables needed
     virtual void nTmp(size_t& ni, size_t& nr) { ni=0; nr=0;}
 
+    /// Can evalD be called concurrently, given separate work vectors?
+    virtual bool isReentrant() const { return true;}
+
     /// Set unary dependency
     void setDependencies(const MX& dep);
 
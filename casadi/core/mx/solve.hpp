@@ -65,6 +65,9 @@ namespace casadi {
     /// Evaluate the function numerically
     virtual void evalD(const cpv_double& arg, const pv_double& res, int* itmp, double* rtmp);
 
+    /// The linear solver keeps its factorization between calls
+    virtual bool isReentrant() const { return false;}
+
     /// Evaluate the function symbolically (SX)
     virtual void evalSX(const cpv_SXElement& arg, const pv_SXElement& res,
                         int* itmp, SXElement* rtmp);
@@ -326,6 +326,12 @@ namespace casadi {
   template<typename T>
   bool isRegular(const std::vector<T> &v);
 
+#ifndef SWIG
+  /// Checks if the \a n entries starting at \a v do not contain NaN or Inf
+  template<typename T>
+  bool isRegular(const T* v, int n);
+#endif // SWIG
+
 } // namespace casadi
 
 // Implementations
@@ -732,7 +738,12 @@ namespace casadi {
 
   template<typename T>
   bool isRegular(const std::vector<T> &v) {
-    for (int k=0;k<v.size();++k) {
+    return isRegular(getPtr(v), v.size());
+  }
+
+  template<typename T>
+  bool isRegular(const T* v, int n) {
+    for (int k=0;k<n;++k) {
       if (v[k]!=v[k] || v[k]==std::numeric_limits<T>::infinity() ||
           v[k]==-std::numeric_limits<T>::infinity()) return false;
     }
@@ -785,6 +785,19 @@ namespace casadi {
     (*this)->temp = t;
   }
 
+  Dictionary SXElement::getNodeStats() {
+    long live_nodes, peak_nodes;
+    size_t live_bytes, peak_bytes, reserved_bytes;
+    SXNode::getPoolStats(live_nodes, peak_nodes, live_bytes, peak_bytes, reserved_bytes);
+    Dictionary ret;
+    ret["live_nodes"] = static_cast<double>(live_nodes);
+    ret["peak_nodes"] = static_cast<double>(peak_nodes);
+    ret["live_bytes"] = static_cast<double>(live_bytes);
+    ret["peak_bytes"] = static_cast<double>(peak_bytes);
+    ret["reserved_bytes"] = static_cast<double>(reserved_bytes);
+    return ret;
+  }
+
   bool SXElement::marked() const {
     return (*this)->marked();
   }
@@ -30,6 +30,7 @@
 #include "../printable_object.hpp"
 #include "../casadi_exception.hpp"
 #include "../casadi_limits.hpp"
+#include "../generic_type.hpp"
 #include "../matrix/matrix.hpp"
 #include "../matrix/generic_expression.hpp"
 
@@ -264,6 +265,13 @@ namespace casadi {
     /** \brief Assign the node to something, without invoking the deletion of the node,
      * if the count reaches 0 */
     SXNode* assignNoDelete(const SXElement& scalar);
+
+    /** \brief Memory footprint of all expression nodes
+     * Number of live nodes and their peak ("live_nodes", "peak_nodes"), bytes used by
+     * live nodes and their peak ("live_bytes", "peak_bytes") and bytes reserved by the
+     * node pool ("reserved_bytes"). Reported as floating point numbers, so that large
+     * counts do not overflow */
+    static Dictionary getNodeStats();
     /// \endcond
 
     /** \brief SXElement nodes are not allowed to be null */
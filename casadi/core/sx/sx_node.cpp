@@ -26,6 +26,11 @@
 #include "sx_node.hpp"
 #include <limits>
 #include <typeinfo>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif // _WIN32
 
 using namespace std;
 namespace casadi {
@@ -132,4 +137,159 @@ namespace casadi {
   long SXNode::max_num_calls_in_print_ = 10000;
   int SXNode::eq_depth_ = 1;
 
+  namespace {
+    // Granularity of the size classes and size of the largest pooled node
+    const size_t pool_align = 8;
+    const size_t pool_max_size = 128;
+    const size_t pool_num_classes = pool_max_size/pool_align;
+
+    // Size of a slab. Slabs are aligned to their size, so that the slab of a block
+    // is found by masking the address of the block
+    const size_t pool_slab_size = 64*1024;
+
+    // Header at the start of every slab, followed by the blocks
+    struct PoolSlab {
+      // Neighbours in the list of slabs of the size class that have blocks available
+      PoolSlab* prev;
+      PoolSlab* next;
+      // Freed blocks, the first word of a block holds the next freed block
+      void* free;
+      // Unused part of the slab
+      char* unused;
+      // Number of blocks in use
+      long live;
+      // Size class
+      size_t c;
+    };
+    const size_t pool_header_size = (sizeof(PoolSlab) + pool_align - 1)/pool_align*pool_align;
+
+    // Per size class: the slabs with blocks available. A plain array with static
+    // initialization, so that nodes can be created during the dynamic initialization
+    // of other translation units
+    PoolSlab* pool_avail[pool_num_classes];
+
+    // Statistics of the pool
+    long pool_live_nodes = 0;
+    long pool_peak_nodes = 0;
+    size_t pool_live_bytes = 0;
+    size_t pool_peak_bytes = 0;
+    size_t pool_reserved_bytes = 0;
+
+    inline size_t pool_class(size_t size) {
+      return (size + pool_align - 1)/pool_align - 1;
+    }
+
+    inline size_t pool_block(size_t c) {
+      return (c+1)*pool_align;
+    }
+
+    // Does a slab have blocks available?
+    inline bool pool_available(const PoolSlab* s) {
+      return s->free!=0 ||
+        s->unused + pool_block(s->c) <= reinterpret_cast<const char*>(s) + pool_slab_size;
+    }
+
+    inline void pool_link(PoolSlab* s) {
+      s->prev = 0;
+      s->next = pool_avail[s->c];
+      if (s->next) s->next->prev = s;
+      pool_avail[s->c] = s;
+    }
+
+    inline void pool_unlink(PoolSlab* s) {
+      if (s->prev) {
+        s->prev->next = s->next;
+      } else {
+        pool_avail[s->c] = s->next;
+      }
+      if (s->next) s->next->prev = s->prev;
+    }
+
+    PoolSlab* pool_new_slab(size_t c) {
+      void* mem;
+#ifdef _WIN32
+      mem = _aligned_malloc(pool_slab_size, pool_slab_size);
+      if (mem==0) throw bad_alloc();
+#else // _WIN32
+      if (posix_memalign(&mem, pool_slab_size, pool_slab_size)!=0) throw bad_alloc();
+#endif // _WIN32
+      PoolSlab* s = static_cast<PoolSlab*>(mem);
+      s->free = 0;
+      s->unused = static_cast<char*>(mem) + pool_header_size;
+      s->live = 0;
+      s->c = c;
+      pool_link(s);
+      return s;
+    }
+
+    void pool_delete_slab(PoolSlab* s) {
+      pool_unlink(s);
+#ifdef _WIN32
+      _aligned_free(s);
+#else // _WIN32
+      free(s);
+#endif // _WIN32
+    }
+  } // namespace
+
+  void* SXNode::operator new(size_t size) {
+    void* ret;
+    if (size>pool_max_size) {
+      ret = ::operator new(size);
+    } else {
+      size_t c = pool_class(size);
+      PoolSlab* s = pool_avail[c];
+      if (s==0) {
+        s = pool_new_slab(c);
+        pool_reserved_bytes += pool_slab_size;
+      }
+      if (s->free) {
+        // Recycle a freed block
+        ret = s->free;
+        s->free = *static_cast<void**>(ret);
+      } else {
+        ret = s->unused;
+        s->unused += pool_block(c);
+      }
+      s->live++;
+      if (!pool_available(s)) pool_unlink(s);
+    }
+
+    // Update statistics
+    pool_live_bytes += size;
+    if (pool_live_bytes>pool_peak_bytes) pool_peak_bytes = pool_live_bytes;
+    if (++pool_live_nodes>pool_peak_nodes) pool_peak_nodes = pool_live_nodes;
+    return ret;
+  }
+
+  void SXNode::getPoolStats(long& live_nodes, long& peak_nodes, size_t& live_bytes,
+                            size_t& peak_bytes, size_t& reserved_bytes) {
+    live_nodes = pool_live_nodes;
+    peak_nodes = pool_peak_nodes;
+    live_bytes = pool_live_bytes;
+    peak_bytes = pool_peak_bytes;
+    reserved_bytes = pool_reserved_bytes;
+  }
+
+  void SXNode::operator delete(void* ptr, size_t size) {
+    if (ptr==0) return;
+    pool_live_bytes -= size;
+    pool_live_nodes--;
+    if (size>pool_max_size) {
+      ::operator delete(ptr);
+    } else {
+      PoolSlab* s = reinterpret_cast<PoolSlab*>(reinterpret_cast<size_t>(ptr)
+                                                & ~(pool_slab_size-1));
+      if (!pool_available(s)) pool_link(s);
+      *static_cast<void**>(ptr) = s->free;
+      s->free = ptr;
+
+      // Return an empty slab to the system, unless it is the last one of its size class
+      if (--s->live==0 && (s->prev!=0 || s->next!=0)) {
+        pool_delete_slab(s);
+        pool_reserved_bytes -= pool_slab_size;
+      }
+    }
+  }
+
 } // namespace casadi
@@ -29,6 +29,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <cstddef>
 #include <math.h>
 
 /** \brief  Scalar expression (which also works as a smart pointer class to this class) */
@@ -42,7 +43,7 @@ namespace casadi {
       \author Joel Andersson
       \date 2010
   */
-  class SXNode {
+  class CASADI_EXPORT SXNode {
     friend class SXElement;
     friend class Matrix<SXElement>;
 
@@ -54,6 +55,21 @@ namespace casadi {
     /** \brief  destructor  */
     virtual ~SXNode();
 
+    ///@{
+    /** \brief  Allocate nodes from a pool of slabs, one size class per 8 bytes
+        Nodes created close together in time end up close together in memory.
+        Freed nodes are recycled for the same size class, and a slab without live nodes
+        is returned to the system unless it is the last one of its class. Like the
+        reference counting of SXElement, the pool is not thread-safe.
+    */
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size);
+    ///@}
+
+    /** \brief  Statistics of the node pool */
+    static void getPoolStats(long& live_nodes, long& peak_nodes, std::size_t& live_bytes,
+                             std::size_t& peak_bytes, std::size_t& reserved_bytes);
+
     ///@{
     /** \brief  check properties of a node */
     virtual bool isConstant() const; // check if constant
@@ -80,8 +80,8 @@ namespace casadi {
     AT_.x = &input().front(); // col indices, size nzmax
     AT_.nz = -1; // of entries in triplet matrix, -1 for compressed-row
 
-    // Temporary
-    temp_.resize(AT_.n);
+    // Temporary, a panel of right-hand-sides
+    temp_.resize(AT_.n*rhs_block_);
 
     if (verbose()) {
       cout << "CSparseCholeskyInternal::prepare: symbolic factorization" << endl;
@@ -200,19 +200,24 @@ namespace casadi {
     casadi_assert(L_!=0);
 
     double *t = &temp_.front();
-    for (int k=0; k<nrhs; ++k) {
+    int n = AT_.n;
+    const cs *L = L_->L;
+
+    // Solve for panels of right-hand-sides, stored interleaved in t
+    for (int r0=0; r0<nrhs; r0+=rhs_block_) {
+      int nb = std::min(rhs_block_, nrhs-r0);
       if (transpose) {
-        cs_pvec(S_->q, x, t, AT_.n) ;   // t = P1\b
-        cs_ltsolve(L_->L, t) ;               // t = L\t
-        cs_lsolve(L_->L, t) ;              // t = U\t
-        cs_pvec(L_->pinv, t, x, AT_.n) ;      // x = P2\t
+        gatherPanel(n, nb, S_->q, false, x, t);       // t = P1\b
+        ltsolvePanel(n, L->p, L->i, L->x, t, nb);     // t = L\t
+        lsolvePanel(n, L->p, L->i, L->x, t, nb);      // t = U\t
+        scatterPanel(n, nb, L_->pinv, false, t, x);   // x = P2\t
       } else {
-        cs_ipvec(L_->pinv, x, t, AT_.n) ;   // t = P1\b
-        cs_lsolve(L_->L, t) ;               // t = L\t
-        cs_ltsolve(L_->L, t) ;              // t = U\t
-        cs_ipvec(S_->q, t, x, AT_.n) ;      // x = P2\t
+        gatherPanel(n, nb, L_->pinv, true, x, t);     // t = P1\b
+        lsolvePanel(n, L->p, L->i, L->x, t, nb);      // t = L\t
+        ltsolvePanel(n, L->p, L->i, L->x, t, nb);     // t = U\t
+        scatterPanel(n, nb, S_->q, true, t, x);       // x = P2\t
       }
-      x += ncol();
+      x += nb*ncol();
     }
   }
 
@@ -50,6 +50,16 @@ namespace casadi {
       : LinearSolverInternal(sparsity, nrhs) {
     N_ = 0;
     S_ = 0;
+
+    addOption("refactorize", OT_BOOLEAN, true,
+              "Only recompute the numerical values of the factors when the pivot sequence of "
+              "the previous factorization is still acceptable");
+    addOption("pivot_tol", OT_REAL, 1e-8,
+              "Relative threshold for partial pivoting. A pivot is accepted if its magnitude is "
+              "at least pivot_tol times the largest candidate in its column");
+    addOption("refactorize_tol", OT_REAL, 1e-3,
+              "Relative pivot threshold below which the pivot sequence of the previous "
+              "factorization is discarded and a full factorization is performed");
   }
 
   CsparseInterface::CsparseInterface(const CsparseInterface& linsol)
@@ -77,12 +87,22 @@ namespace casadi {
     A_.x = &input().front(); // numerical values, size nzmax
     A_.nz = -1; // of entries in triplet matrix, -1 for compressed-col
 
-    // Temporary
-    temp_.resize(A_.n);
+    // Temporary, a panel of right-hand-sides
+    temp_.resize(A_.n*rhs_block_);
 
     // Has the routine been called once
     called_once_ = false;
 
+    // Read options
+    refactorize_ = getOption("refactorize");
+    pivot_tol_ = getOption("pivot_tol");
+    refactorize_tol_ = getOption("refactorize_tol");
+
+    // Reset counters
+    n_factorize_ = n_refactorize_ = 0;
+    stats_["n_factorize"] = n_factorize_;
+    stats_["n_refactorize"] = n_refactorize_;
+
     if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
       profileWriteName(CasadiOptions::profilingLog, this, "CSparse",
                        ProfilingData_FunctionType_Other, 2);
@@ -127,37 +147,41 @@ namespace casadi {
       input(0).printSparse();
     }
 
-    double tol = 1e-8;
-
-    if (N_) cs_nfree(N_);
-    N_ = cs_lu(&A_, S_, tol) ;                 // numeric LU factorization
-    if (N_==0) {
-      DMatrix temp = input();
-      temp.makeSparse();
-      if (temp.sparsity().isSingular()) {
-        stringstream ss;
-        ss << "CsparseInterface::prepare: factorization failed due to matrix"
-          " being singular. Matrix contains numerical zeros which are "
-            "structurally non-zero. Promoting these zeros to be structural "
-            "zeros, the matrix was found to be structurally rank deficient."
-            " sprank: " << sprank(temp.sparsity()) << " <-> " << temp.size2() << endl;
-        if (verbose()) {
-          ss << "Sparsity of the linear system: " << endl;
-          input(LINSOL_A).sparsity().print(ss); // print detailed
+    // Try to reuse the previous factorization
+    if (refactorize_ && N_ && refactorize()) {
+      stats_["n_refactorize"] = ++n_refactorize_;
+    } else {
+      if (N_) cs_nfree(N_);
+      N_ = cs_lu(&A_, S_, pivot_tol_) ;          // numeric LU factorization
+      stats_["n_factorize"] = ++n_factorize_;
+      if (N_==0) {
+        DMatrix temp = input();
+        temp.makeSparse();
+        if (temp.sparsity().isSingular()) {
+          stringstream ss;
+          ss << "CsparseInterface::prepare: factorization failed due to matrix"
+            " being singular. Matrix contains numerical zeros which are "
+              "structurally non-zero. Promoting these zeros to be structural "
+              "zeros, the matrix was found to be structurally rank deficient."
+              " sprank: " << sprank(temp.sparsity()) << " <-> " << temp.size2() << endl;
+          if (verbose()) {
+            ss << "Sparsity of the linear system: " << endl;
+            input(LINSOL_A).sparsity().print(ss); // print detailed
+          }
+          throw CasadiException(ss.str());
+        } else {
+          stringstream ss;
+          ss << "CsparseInterface::prepare: factorization failed, check if Jacobian is singular"
+             << endl;
+          if (verbose()) {
+            ss << "Sparsity of the linear system: " << endl;
+            input(LINSOL_A).sparsity().print(ss); // print detailed
+          }
+          throw CasadiException(ss.str());
         }
-        throw CasadiException(ss.str());
-      } else {
-        stringstream ss;
-        ss << "CsparseInterface::prepare: factorization failed, check if Jacobian is singular"
-           << endl;
-        if (verbose()) {
-          ss << "Sparsity of the linear system: " << endl;
-          input(LINSOL_A).sparsity().print(ss); // print detailed
-        }
-        throw CasadiException(ss.str());
       }
+      casadi_assert(N_!=0);
     }
-    casadi_assert(N_!=0);
 
     prepared_ = true;
 
@@ -170,6 +194,53 @@ namespace casadi {
     }
   }
 
+  bool CsparseInterface::refactorize() {
+    // The factorization is L*U = P*A*Q with the rows of L in pivoted order
+    int n = A_.n;
+    const int *Ap = A_.p, *Ai = A_.i, *q = S_->q, *pinv = N_->pinv;
+    const double *Ax = A_.x;
+    const int *Lp = N_->L->p, *Li = N_->L->i, *Up = N_->U->p, *Ui = N_->U->i;
+    double *Lx = N_->L->x, *Ux = N_->U->x;
+
+    // Dense work vector, in pivoted row order
+    double *y = getPtr(temp_);
+    fill(y, y+n, 0);
+
+    for (int k=0; k<n; ++k) {
+      // Scatter A(:, q[k])
+      int col = q ? q[k] : k;
+      for (int p=Ap[col]; p<Ap[col+1]; ++p) y[pinv[Ai[p]]] = Ax[p];
+
+      // Triangular solve with the columns of L that U(:, k) depends on. The entries of U(:, k)
+      // are stored in the topological order of the original factorization, diagonal last.
+      for (int p=Up[k]; p<Up[k+1]-1; ++p) {
+        int j = Ui[p];
+        double yj = Ux[p] = y[j];
+        for (int r=Lp[j]+1; r<Lp[j+1]; ++r) y[Li[r]] -= Lx[r]*yj;
+        y[j] = 0;
+      }
+
+      // Check that the pivot is still acceptable
+      double pivot = y[k], a = fabs(pivot);
+      for (int r=Lp[k]+1; r<Lp[k+1]; ++r) a = std::max(a, fabs(y[Li[r]]));
+      if (pivot==0 || fabs(pivot) < a*refactorize_tol_) {
+        if (verbose()) {
+          cout << "CsparseInterface::refactorize: pivot " << k << " degraded" << endl;
+        }
+        return false;
+      }
+
+      // Store the pivot and scale the column of L
+      Ux[Up[k+1]-1] = pivot;
+      y[k] = 0;
+      for (int r=Lp[k]+1; r<Lp[k+1]; ++r) {
+        Lx[r] = y[Li[r]] / pivot;
+        y[Li[r]] = 0;
+      }
+    }
+    return true;
+  }
+
   void CsparseInterface::solve(double* x, int nrhs, bool transpose) {
     double time_start=0;
     if (CasadiOptions::profiling&& CasadiOptions::profilingBinary) {
@@ -182,21 +253,25 @@ namespace casadi {
     casadi_assert(N_!=0);
 
     double *t = &temp_.front();
+    int n = A_.n;
+    const cs *L = N_->L, *U = N_->U;
+    casadi_assert(U!=0);
 
-    for (int k=0; k<nrhs; ++k) {
+    // Solve for panels of right-hand-sides, stored interleaved in t
+    for (int r0=0; r0<nrhs; r0+=rhs_block_) {
+      int nb = std::min(rhs_block_, nrhs-r0);
       if (transpose) {
-        cs_pvec(S_->q, x, t, A_.n) ;       // t = P2*b
-        casadi_assert(N_->U!=0);
-        cs_utsolve(N_->U, t) ;              // t = U'\t
-        cs_ltsolve(N_->L, t) ;              // t = L'\t
-        cs_pvec(N_->pinv, t, x, A_.n) ;    // x = P1*t
+        gatherPanel(n, nb, S_->q, false, x, t);              // t = P2*b
+        utsolvePanel(n, U->p, U->i, U->x, t, nb);            // t = U'\t
+        ltsolvePanel(n, L->p, L->i, L->x, t, nb);            // t = L'\t
+        scatterPanel(n, nb, N_->pinv, false, t, x);          // x = P1*t
       } else {
-        cs_ipvec(N_->pinv, x, t, A_.n) ;   // t = P1\b
-        cs_lsolve(N_->L, t) ;               // t = L\t
-        cs_usolve(N_->U, t) ;               // t = U\t
-        cs_ipvec(S_->q, t, x, A_.n) ;      // x = P2\t
+        gatherPanel(n, nb, N_->pinv, true, x, t);            // t = P1\b
+        lsolvePanel(n, L->p, L->i, L->x, t, nb);             // t = L\t
+        usolvePanel(n, U->p, U->i, U->x, t, nb);             // t = U\t
+        scatterPanel(n, nb, S_->q, true, t, x);              // x = P2\t
       }
-      x += ncol();
+      x += nb*ncol();
     }
 
     if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
@@ -65,6 +65,11 @@ namespace casadi {
     // Factorize the matrix
     virtual void prepare();
 
+    /** \brief Recompute the values of L and U, keeping the pattern and pivot sequence
+     * Returns false if a pivot has degraded, in which case a full factorization is needed.
+     */
+    bool refactorize();
+
     // Solve the system of equations
     virtual void solve(double* x, int nrhs, bool transpose);
 
@@ -86,6 +91,18 @@ namespace casadi {
     // Temporary
     std::vector<double> temp_;
 
+    // Reuse the last pivot sequence if possible
+    bool refactorize_;
+
+    // Threshold for partial pivoting
+    double pivot_tol_;
+
+    // Threshold for accepting a reused pivot
+    double refactorize_tol_;
+
+    // Number of full and numeric-only factorizations
+    int n_factorize_, n_refactorize_;
+
     /// A documentation string
     static const std::string meta_doc;
 
@@ -66,6 +66,10 @@ namespace casadi {
     addOption("pass_nonlinear_variables", OT_BOOLEAN, false);
     addOption("print_time",               OT_BOOLEAN, true,
               "print information about execution time");
+    addOption("triangular_hessian",       OT_BOOLEAN, false,
+              "Exact Hessian: calculate only the entries on and above the diagonal by "
+              "compressed directional derivatives instead of generating the symbolic "
+              "Hessian of the Lagrangian and passing its upper triangular part to IPOPT");
 
     // Monitors
     addOption("monitor",                  OT_STRINGVECTOR, GenericType(),  "",
@@ -210,9 +214,23 @@ namespace casadi {
     gradF();
     jacG();
     if (exact_hessian_) {
+      // Only the upper triangular part is passed to Ipopt
+      hess_lag_triu_ = getOption("triangular_hessian");
       hessLag();
+      size_t ni, nr;
+      hessLag_.nTmp(ni, nr);
+      h_itmp_.resize(ni);
+      h_rtmp_.resize(nr);
+      h_arg_.resize(hessLag_.getNumInputs());
+      h_res_.resize(hessLag_.getNumOutputs());
     }
 
+    // Evaluation cache
+    g_cache_.resize(ng_);
+    grad_f_cache_.resize(nx_);
+    grad_f_has_fg_ = gradF_.output(GRADF_F).sparsity()==nlp_.output(NL_F).sparsity() &&
+        gradF_.output(GRADF_G).sparsity()==nlp_.output(NL_G).sparsity();
+
     // Start an IPOPT application
     Ipopt::SmartPtr<Ipopt::IpoptApplication> *app = new Ipopt::SmartPtr<Ipopt::IpoptApplication>();
     app_ = static_cast<void*>(app);
@@ -338,6 +356,10 @@ namespace casadi {
         t_callback_prepare_ = t_mainloop_ = 0;
 
     n_eval_f_ = n_eval_grad_f_ = n_eval_g_ = n_eval_jac_g_ = n_eval_h_ = n_iter_ = 0;
+    n_eval_f_cached_ = n_eval_g_cached_ = 0;
+
+    // Parameters may have changed since the last solve
+    reset_cache();
 
     // Get back the smart pointers
     Ipopt::SmartPtr<Ipopt::TNLP> *userclass =
@@ -386,7 +408,8 @@ namespace casadi {
       // Write timings
       cout << "time spent in eval_f: " << t_eval_f_ << " s.";
       if (n_eval_f_>0)
-        cout << " (" << n_eval_f_ << " calls, " << (t_eval_f_/n_eval_f_)*1000 << " ms. average)";
+        cout << " (" << n_eval_f_ << " calls, " << n_eval_f_cached_ << " from cache, "
+             << (t_eval_f_/n_eval_f_)*1000 << " ms. average)";
       cout << endl;
       cout << "time spent in eval_grad_f: " << t_eval_grad_f_ << " s.";
       if (n_eval_grad_f_>0)
@@ -395,7 +418,8 @@ namespace casadi {
       cout << endl;
       cout << "time spent in eval_g: " << t_eval_g_ << " s.";
       if (n_eval_g_>0)
-        cout << " (" << n_eval_g_ << " calls, " << (t_eval_g_/n_eval_g_)*1000 << " ms. average)";
+        cout << " (" << n_eval_g_ << " calls, " << n_eval_g_cached_ << " from cache, "
+             << (t_eval_g_/n_eval_g_)*1000 << " ms. average)";
       cout << endl;
       cout << "time spent in eval_jac_g: " << t_eval_jac_g_ << " s.";
       if (n_eval_jac_g_>0)
@@ -457,6 +481,8 @@ namespace casadi {
     stats_["n_eval_g"] = n_eval_g_;
     stats_["n_eval_jac_g"] = n_eval_jac_g_;
     stats_["n_eval_h"] = n_eval_h_;
+    stats_["n_eval_f_cached"] = n_eval_f_cached_;
+    stats_["n_eval_g_cached"] = n_eval_g_cached_;
 
     stats_["iter_count"] = n_iter_-1;
 
@@ -573,6 +599,7 @@ namespace casadi {
                              int* iRow, int* jCol, double* values) {
     try {
       log("eval_h started");
+      if (new_x) reset_cache();
       double time1 = clock();
       if (values == NULL) {
         int nz=0;
@@ -585,6 +612,27 @@ namespace casadi {
             jCol[nz] = cc;
             nz++;
           }
+      } else if (hessLag_.output().sparsity().isTriu()) {
+        // Only the upper triangular part is calculated, evaluate directly into values
+        fill(h_arg_.begin(), h_arg_.end(), static_cast<const double*>(0));
+        h_arg_[NL_X] = x;
+        h_arg_[NL_P] = input(NLP_SOLVER_P).ptr();
+        h_arg_[NL_NUM_IN+NL_F] = &obj_factor;
+        h_arg_[NL_NUM_IN+NL_G] = lambda;
+        fill(h_res_.begin(), h_res_.end(), static_cast<double*>(0));
+        h_res_[0] = values;
+        hessLag_.evalD(h_arg_, h_res_, getPtr(h_itmp_), getPtr(h_rtmp_));
+
+        if (monitored("eval_h")) {
+          cout << "x = " << vector<double>(x, x+nx_) << endl;
+          cout << "H = " << endl;
+          copy(values, values+nele_hess, hessLag_.output().begin());
+          hessLag_.output().printSparse();
+        }
+
+        if (regularity_check_ && !isRegular(values, nele_hess))
+            casadi_error("IpoptInterface::h: NaN or Inf detected.");
+
       } else {
         // Pass the argument to the function
         hessLag_.setInput(x, NL_X);
@@ -627,6 +675,7 @@ namespace casadi {
                                   int* iRow, int *jCol, double* values) {
     try {
       log("eval_jac_g started");
+      if (new_x) reset_cache();
 
       // Quich finish if no constraints
       if (m==0) {
@@ -655,18 +704,18 @@ namespace casadi {
         jacG.setInput(x, NL_X);
         jacG.setInput(input(NLP_SOLVER_P), NL_P);
 
-        // Evaluate the function
-        jacG.evaluate();
-
-        // Get the output
-        jacG.getOutput(values);
+        // Evaluate the function, the Jacobian lands directly in values
+        vector<double*> res(jacG.getNumOutputs(), 0);
+        res[0] = values;
+        jacG.evaluateInto(res);
 
         if (monitored("eval_jac_g")) {
           cout << "x = " << jacG.input(NL_X).data() << endl;
           cout << "J = " << endl;
+          copy(values, values+nele_jac, jacG.output().begin());
           jacG.output().printSparse();
         }
-        if (regularity_check_ && !isRegular(jacG.output().data()))
+        if (regularity_check_ && !isRegular(values, nele_jac))
             casadi_error("IpoptInterface::jac_g: NaN or Inf detected.");
       }
 
@@ -685,33 +734,73 @@ namespace casadi {
     }
   }
 
+  void IpoptInterface::eval_fg_cache(const double* x) {
+    // Pass the argument to the function
+    nlp_.setInput(x, NL_X);
+    nlp_.setInput(input(NLP_SOLVER_P), NL_P);
+
+    // Evaluate the objective and the constraints in one pass
+    nlp_.evaluate();
+
+    // Get the result
+    nlp_.getOutput(f_cache_, NL_F);
+    nlp_.getOutput(getPtr(g_cache_), NL_G);
+    if (regularity_check_ && !isRegular(nlp_.output(NL_F).data()))
+        casadi_error("IpoptInterface::f: NaN or Inf detected.");
+    if (regularity_check_ && !isRegular(nlp_.output(NL_G).data()))
+        casadi_error("IpoptInterface::g: NaN or Inf detected.");
+    fg_cached_ = true;
+  }
+
+  void IpoptInterface::eval_grad_f_cache(const double* x) {
+    // Pass the argument to the function
+    gradF_.setInput(x, NL_X);
+    gradF_.setInput(input(NLP_SOLVER_P), NL_P);
+
+    // Evaluate, adjoint mode
+    gradF_.evaluate();
+
+    // Get the result
+    gradF_.output(GRADF_GRAD).get(getPtr(grad_f_cache_));
+    if (regularity_check_ && !isRegular(gradF_.output(GRADF_GRAD).data()))
+        casadi_error("IpoptInterface::grad_f: NaN or Inf detected.");
+    grad_f_cached_ = true;
+
+    // The objective and constraints come for free with the gradient
+    if (grad_f_has_fg_ && !fg_cached_) {
+      gradF_.getOutput(f_cache_, GRADF_F);
+      gradF_.getOutput(getPtr(g_cache_), GRADF_G);
+      if (isRegular(gradF_.output(GRADF_F).data()) && isRegular(gradF_.output(GRADF_G).data())) {
+        fg_cached_ = true;
+      }
+    }
+  }
+
   bool IpoptInterface::eval_f(int n, const double* x, bool new_x, double& obj_value) {
     try {
       log("eval_f started");
+      if (new_x) reset_cache();
 
       // Log time
       double time1 = clock();
       casadi_assert(n == nx_);
 
-      // Pass the argument to the function
-      nlp_.setInput(x, NL_X);
-      nlp_.setInput(input(NLP_SOLVER_P), NL_P);
-
-      // Evaluate the function
-      nlp_.evaluate();
+      // Evaluate the function, unless already done for this x
+      if (fg_cached_) {
+        n_eval_f_cached_ += 1;
+      } else {
+        eval_fg_cache(x);
+      }
 
       // Get the result
-      nlp_.getOutput(obj_value, NL_F);
+      obj_value = f_cache_;
 
       // Printing
       if (monitored("eval_f")) {
-        cout << "x = " << nlp_.input(NL_X) << endl;
+        cout << "x = " << vector<double>(x, x+n) << endl;
         cout << "obj_value = " << obj_value << endl;
       }
 
-      if (regularity_check_ && !isRegular(nlp_.output(NL_F).data()))
-          casadi_error("IpoptInterface::f: NaN or Inf detected.");
-
       double delta = (clock()-time1)/CLOCKS_PER_SEC;
       t_eval_f_ += delta;
       n_eval_f_ += 1;
@@ -731,29 +820,27 @@ namespace casadi {
   bool IpoptInterface::eval_g(int n, const double* x, bool new_x, int m, double* g) {
     try {
       log("eval_g started");
+      if (new_x) reset_cache();
       double time1 = clock();
 
       if (m>0) {
-        // Pass the argument to the function
-        nlp_.setInput(x, NL_X);
-        nlp_.setInput(input(NLP_SOLVER_P), NL_P);
-
-        // Evaluate the function and tape
-        nlp_.evaluate();
+        // Evaluate the function, unless already done for this x
+        if (fg_cached_) {
+          n_eval_g_cached_ += 1;
+        } else {
+          eval_fg_cache(x);
+        }
 
-        // Ge the result
-        nlp_.getOutput(g, NL_G);
+        // Get the result
+        copy(g_cache_.begin(), g_cache_.end(), g);
 
         // Printing
         if (monitored("eval_g")) {
-          cout << "x = " << nlp_.input(NL_X) << endl;
-          cout << "g = " << nlp_.output(NL_G) << endl;
+          cout << "x = " << vector<double>(x, x+n) << endl;
+          cout << "g = " << g_cache_ << endl;
         }
       }
 
-      if (regularity_check_ && !isRegular(nlp_.output(NL_G).data()))
-          casadi_error("IpoptInterface::g: NaN or Inf detected.");
-
       double delta = (clock()-time1)/CLOCKS_PER_SEC;
       t_eval_g_ += delta;
       if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
@@ -772,28 +859,22 @@ namespace casadi {
   bool IpoptInterface::eval_grad_f(int n, const double* x, bool new_x, double* grad_f) {
     try {
       log("eval_grad_f started");
+      if (new_x) reset_cache();
       double time1 = clock();
       casadi_assert(n == nx_);
 
-      // Pass the argument to the function
-      gradF_.setInput(x, NL_X);
-      gradF_.setInput(input(NLP_SOLVER_P), NL_P);
-
-      // Evaluate, adjoint mode
-      gradF_.evaluate();
+      // Evaluate the gradient, unless already done for this x
+      if (!grad_f_cached_) eval_grad_f_cache(x);
 
       // Get the result
-      gradF_.output().get(grad_f);
+      copy(grad_f_cache_.begin(), grad_f_cache_.end(), grad_f);
 
       // Printing
       if (monitored("eval_grad_f")) {
-        cout << "x = " << gradF_.input(NL_X) << endl;
-        cout << "grad_f = " << gradF_.output() << endl;
+        cout << "x = " << vector<double>(x, x+n) << endl;
+        cout << "grad_f = " << grad_f_cache_ << endl;
       }
 
-      if (regularity_check_ && !isRegular(gradF_.output().data()))
-          casadi_error("IpoptInterface::grad_f: NaN or Inf detected.");
-
       double delta = (clock()-time1)/CLOCKS_PER_SEC;
       t_eval_grad_f_ += delta;
       if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
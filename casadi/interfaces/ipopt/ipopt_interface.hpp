@@ -147,6 +147,30 @@ public:
                           const std::map<std::string, std::vector<int> >& con_integer_md,
                           const std::map<std::string, std::vector<double> >& con_numeric_md);
 
+  /** \brief Evaluate f and g at x, storing the result in the evaluation cache */
+  void eval_fg_cache(const double* x);
+
+  /** \brief Evaluate grad f at x, storing the result (and f and g, if available) in the cache */
+  void eval_grad_f_cache(const double* x);
+
+  /** \brief Invalidate the evaluation cache, called whenever Ipopt passes new_x=true */
+  void reset_cache() { fg_cached_ = grad_f_cached_ = false;}
+
+  // Evaluation cache, f and g and grad f at the last x passed by Ipopt
+  bool fg_cached_, grad_f_cached_;
+  double f_cache_;
+  std::vector<double> g_cache_, grad_f_cache_;
+
+  // Does the gradient function also return f and g
+  bool grad_f_has_fg_;
+
+  // Work vectors and arguments of the Hessian of the Lagrangian, evaluated directly into
+  // Ipopt's array
+  std::vector<int> h_itmp_;
+  std::vector<double> h_rtmp_;
+  std::vector<const double*> h_arg_;
+  std::vector<double*> h_res_;
+
   // Accumulated time since last reset:
   double t_eval_f_; // time spent in eval_f
   double t_eval_grad_f_; // time spent in eval_grad_f
@@ -163,6 +187,8 @@ public:
   int n_eval_g_; // number of calls to eval_g
   int n_eval_jac_g_; // number of calls to eval_jac_g
   int n_eval_h_; // number of calls to eval_h
+  int n_eval_f_cached_; // number of calls to eval_f served from the cache
+  int n_eval_g_cached_; // number of calls to eval_g served from the cache
   int n_iter_; // number of iterations
 
   // For parametric sensitivities with sIPOPT
@@ -160,25 +160,31 @@ namespace casadi {
       profileWriteEntry(CasadiOptions::profilingLog, this);
     }
 
-    // Scale the right hand side
-    if (transpose) {
-      rowScaling(x, nrhs);
-    } else {
-      colScaling(x, nrhs);
-    }
+    // Solve for panels of right-hand-sides, which stay in cache during scaling and solve
+    for (int r0=0; r0<nrhs; r0+=rhs_block_) {
+      int nb = std::min(rhs_block_, nrhs-r0);
+      double* xb = x + r0*ncol_;
+
+      // Scale the right hand side
+      if (transpose) {
+        rowScaling(xb, nb);
+      } else {
+        colScaling(xb, nb);
+      }
 
-    // Solve the system of equations
-    int info = 100;
-    char trans = transpose ? 'T' : 'N';
-    dgetrs_(&trans, &ncol_, &nrhs, getPtr(mat_), &ncol_, getPtr(ipiv_), x, &ncol_, &info);
-    if (info != 0) throw CasadiException("LapackLuDense::solve: "
-                                        "failed to solve the linear system");
-
-    // Scale the solution
-    if (transpose) {
-      colScaling(x, nrhs);
-    } else {
-      rowScaling(x, nrhs);
+      // Solve the system of equations
+      int info = 100;
+      char trans = transpose ? 'T' : 'N';
+      dgetrs_(&trans, &ncol_, &nb, getPtr(mat_), &ncol_, getPtr(ipiv_), xb, &ncol_, &info);
+      if (info != 0) throw CasadiException("LapackLuDense::solve: "
+                                          "failed to solve the linear system");
+
+      // Scale the solution
+      if (transpose) {
+        colScaling(xb, nb);
+      } else {
+        rowScaling(xb, nb);
+      }
     }
 
     if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
@@ -66,7 +66,7 @@ namespace casadi {
     // Allocate matrix
     mat_.resize(ncol_*ncol_);
     tau_.resize(ncol_);
-    work_.resize(10*ncol_);
+    work_.resize(std::max(10*ncol_, 64*rhs_block_));
   }
 
   void LapackQrDense::prepare() {
@@ -100,31 +100,37 @@ namespace casadi {
     int k = tau_.size(); // minimum of ncol_ and nrow_
     int lwork = work_.size();
 
-    if (transpose) {
-
-      // Solve for transpose(R)
-      dtrsm_(&sideR, &uploR, &transR, &diagR, &ncol_, &nrhs, &alphaR,
-             getPtr(mat_), &ncol_, x, &ncol_);
-
-      // Multiply by Q
-      int info = 100;
-      dormqr_(&sideQ, &transQ, &ncol_, &nrhs, &k, getPtr(mat_), &ncol_, getPtr(tau_), x,
-              &ncol_, getPtr(work_), &lwork, &info);
-      if (info != 0) throw CasadiException("LapackQrDense::solve: dormqr_ failed "
-                                          "to solve the linear system");
-
-    } else {
-
-      // Multiply by transpose(Q)
-      int info = 100;
-      dormqr_(&sideQ, &transQ, &ncol_, &nrhs, &k, getPtr(mat_), &ncol_, getPtr(tau_), x,
-              &ncol_, getPtr(work_), &lwork, &info);
-      if (info != 0) throw CasadiException("LapackQrDense::solve: dormqr_ failed to "
-                                          "solve the linear system");
-
-      // Solve for R
-      dtrsm_(&sideR, &uploR, &transR, &diagR, &ncol_, &nrhs, &alphaR,
-             getPtr(mat_), &ncol_, x, &ncol_);
+    // Solve for panels of right-hand-sides, the workspace of dormqr is sized for a panel
+    for (int r0=0; r0<nrhs; r0+=rhs_block_) {
+      int nb = std::min(rhs_block_, nrhs-r0);
+      double* xb = x + r0*ncol_;
+
+      if (transpose) {
+
+        // Solve for transpose(R)
+        dtrsm_(&sideR, &uploR, &transR, &diagR, &ncol_, &nb, &alphaR,
+               getPtr(mat_), &ncol_, xb, &ncol_);
+
+        // Multiply by Q
+        int info = 100;
+        dormqr_(&sideQ, &transQ, &ncol_, &nb, &k, getPtr(mat_), &ncol_, getPtr(tau_), xb,
+                &ncol_, getPtr(work_), &lwork, &info);
+        if (info != 0) throw CasadiException("LapackQrDense::solve: dormqr_ failed "
+                                            "to solve the linear system");
+
+      } else {
+
+        // Multiply by transpose(Q)
+        int info = 100;
+        dormqr_(&sideQ, &transQ, &ncol_, &nb, &k, getPtr(mat_), &ncol_, getPtr(tau_), xb,
+                &ncol_, getPtr(work_), &lwork, &info);
+        if (info != 0) throw CasadiException("LapackQrDense::solve: dormqr_ failed to "
+                                            "solve the linear system");
+
+        // Solve for R
+        dtrsm_(&sideR, &uploR, &transR, &diagR, &ncol_, &nb, &alphaR,
+               getPtr(mat_), &ncol_, xb, &ncol_);
+      }
     }
   }
 
@@ -1184,30 +1184,12 @@ namespace casadi {
     }
 
     // Evaluate
-    jac_.evaluate();
+    evaluateDense(jac_, Jac->data, Jac->ldim, jac_dense_);
 
     if (monitored("djac")) {
       cout << "jac = " << jac_.output() << endl;
     }
 
-    // Get sparsity and non-zero elements
-    const int* colind = jac_.output().colind();
-    int ncol = jac_.output().size2();
-    const int* row = jac_.output().row();
-    const vector<double>& val = jac_.output().data();
-
-    // Loop over columns
-    for (int cc=0; cc<ncol; ++cc) {
-      // Loop over non-zero entries
-      for (int el=colind[cc]; el<colind[cc+1]; ++el) {
-        // Get row
-        int rr = row[el];
-
-        // Set the element
-        DENSE_ELEM(Jac, rr, cc) = val[el];
-      }
-    }
-
     // Log time duration
     time2 = clock();
     t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
@@ -1242,30 +1224,12 @@ namespace casadi {
     }
 
     // Evaluate
-    jacB_.evaluate();
+    evaluateDense(jacB_, JacB->data, JacB->ldim, jacB_dense_);
 
     if (monitored("djacB")) {
       cout << "jacB = " << jacB_.output() << endl;
     }
 
-    // Get sparsity and non-zero elements
-    const int* colind = jacB_.output().colind();
-    int ncol = jacB_.output().size2();
-    const int* row = jacB_.output().row();
-    const vector<double>& val = jacB_.output().data();
-
-    // Loop over columns
-    for (int cc=0; cc<ncol; ++cc) {
-      // Loop over non-zero entries
-      for (int el=colind[cc]; el<colind[cc+1]; ++el) {
-        // Get row
-        int rr = row[el];
-
-        // Set the element
-        DENSE_ELEM(JacB, rr, cc) = val[el];
-      }
-    }
-
     // Log time duration
     time2 = clock();
     t_jac += static_cast<double>(time2-time1)/CLOCKS_PER_SEC;
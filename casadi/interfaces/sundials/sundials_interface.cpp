@@ -309,6 +309,32 @@ void SundialsInterface::reset() {
   IntegratorInternal::reset();
 }
 
+  void SundialsInterface::evaluateDense(Function& jac, double* data, int ldim,
+                                        DenseScatter& scatter) {
+    // Position of each nonzero in the column-major matrix, recalculated if the layout changes
+    const Sparsity& sp = jac.output().sparsity();
+    std::vector<int>& pos = scatter.pos;
+    if (scatter.sp.isNull() || scatter.sp!=sp || scatter.ldim!=ldim) {
+      scatter.sp = sp;
+      scatter.ldim = ldim;
+      pos.resize(sp.nnz());
+      const int* colind = sp.colind();
+      const int* row = sp.row();
+      for (int cc=0; cc<sp.size2(); ++cc) {
+        for (int el=colind[cc]; el<colind[cc+1]; ++el) {
+          pos[el] = row[el] + cc*ldim;
+        }
+      }
+    }
+
+    // Scatter the Jacobian directly into the matrix, the other outputs go to the output members
+    std::vector<double*> res(jac.getNumOutputs(), 0);
+    std::vector<const std::vector<int>*> perm(jac.getNumOutputs(), 0);
+    res[0] = data;
+    perm[0] = &pos;
+    jac.evaluateInto(res, perm);
+  }
+
   std::pair<int, int> SundialsInterface::getBandwidth() const {
     std::pair<int, int> bw;
 
@@ -104,6 +104,19 @@ public:
   // Jacobian times vector functions
   Function f_fwd_, g_fwd_;
 
+  /// Positions of the nonzeros of a sparsity pattern in a dense, column-major matrix
+  struct DenseScatter {
+    Sparsity sp;
+    int ldim;
+    std::vector<int> pos;
+  };
+
+  // Positions of the Jacobian nonzeros in the dense Sundials matrices
+  DenseScatter jac_dense_, jacB_dense_;
+
+  /** \brief  Evaluate a Jacobian function directly into a dense, column-major matrix */
+  static void evaluateDense(Function& jac, double* data, int ldim, DenseScatter& scatter);
+
   /** \brief  Get the integrator Jacobian for the forward problem */
   virtual Function getJac()=0;
 
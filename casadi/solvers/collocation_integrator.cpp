@@ -30,10 +30,51 @@
 #include "casadi/core/sx/sx_tools.hpp"
 #include "casadi/core/function/sx_function.hpp"
 #include "casadi/core/mx/mx_tools.hpp"
+#include <complex>
 
 using namespace std;
 namespace casadi {
 
+  namespace {
+    typedef complex<long double> Complex;
+
+    /// Gaussian elimination with partial pivoting, returns det(A) and overwrites b with A\b
+    Complex gaussSolve(vector<vector<Complex> > A, vector<Complex>* b) {
+      int n = A.size();
+      Complex det = 1;
+      for (int k=0; k<n; ++k) {
+        // Pivoting
+        int piv = k;
+        for (int i=k+1; i<n; ++i) if (abs(A[i][k]) > abs(A[piv][k])) piv = i;
+        if (piv!=k) {
+          swap(A[k], A[piv]);
+          if (b) swap((*b)[k], (*b)[piv]);
+          det = -det;
+        }
+
+        // A singular pivot is perturbed, which is what inverse iteration needs
+        if (A[k][k]==Complex(0)) A[k][k] = numeric_limits<long double>::epsilon();
+        det *= A[k][k];
+
+        // Eliminate
+        for (int i=k+1; i<n; ++i) {
+          Complex r = A[i][k]/A[k][k];
+          for (int j=k; j<n; ++j) A[i][j] -= r*A[k][j];
+          if (b) (*b)[i] -= r*(*b)[k];
+        }
+      }
+
+      // Back substitution
+      if (b) {
+        for (int k=n-1; k>=0; --k) {
+          for (int j=k+1; j<n; ++j) (*b)[k] -= A[k][j]*(*b)[j];
+          (*b)[k] /= A[k][k];
+        }
+      }
+      return det;
+    }
+  } // namespace
+
   extern "C"
   int CASADI_INTEGRATOR_COLLOCATION_EXPORT
       casadi_register_integrator_collocation(IntegratorInternal::Plugin* plugin) {
@@ -56,12 +97,33 @@ namespace casadi {
               "Order of the interpolating polynomials");
     addOption("collocation_scheme",            OT_STRING,  "radau",
               "Collocation scheme", "radau|legendre");
+    addOption("structured_newton",             OT_BOOLEAN,  false,
+              "Solve the collocation equations with a simplified Newton method that decouples "
+              "the Newton matrix using the eigenvalues of the collocation scheme, instead of "
+              "passing them to implicit_solver");
+    addOption("newton_abstol",                 OT_REAL,     1e-12,
+              "Stopping criterion tolerance on max(|F|) and on the step size for the "
+              "structured Newton method");
+    addOption("newton_max_iter",               OT_INTEGER,  50,
+              "Maximum number of structured Newton iterations in a step");
+    addOption("newton_contraction_max",        OT_REAL,     0.1,
+              "Refactorize at the current iterate when the ratio between consecutive Newton "
+              "step sizes exceeds this value, otherwise the factorization is kept for the "
+              "following steps");
+    addOption("linear_solver",                 OT_STRING,   "csparse",
+              "Linear solver for the structured Newton method");
+    addOption("linear_solver_options",         OT_DICTIONARY, GenericType(),
+              "Options to be passed to the linear solver");
     setOption("name", "unnamed_collocation_integrator");
   }
 
   void CollocationIntegrator::deepCopyMembers(
       std::map<SharedObjectNode*, SharedObject>& already_copied) {
     ImplicitFixedStepIntegrator::deepCopyMembers(already_copied);
+    jac_ = deepcopy(jac_, already_copied);
+    for (int b=0; b<linsol_.size(); ++b) {
+      linsol_[b] = deepcopy(linsol_[b], already_copied);
+    }
   }
 
   CollocationIntegrator::~CollocationIntegrator() {
@@ -69,9 +131,332 @@ namespace casadi {
 
   void CollocationIntegrator::init() {
 
+    // Read options
+    structured_newton_ = getOption("structured_newton");
+    newton_abstol_ = getOption("newton_abstol");
+    newton_max_iter_ = getOption("newton_max_iter");
+    newton_contraction_max_ = getOption("newton_contraction_max");
+
     // Call the base class init
     ImplicitFixedStepIntegrator::init();
 
+    // Solver for the forward problem
+    if (structured_newton_) {
+      setupStructuredNewton();
+    } else {
+      casadi_assert_message(!implicit_solver_.isNull(), "Option \"implicit_solver\" is required "
+                            "unless \"structured_newton\" is set");
+    }
+  }
+
+  void CollocationIntegrator::setupStructuredNewton() {
+    int n = nx_+nz_;
+
+    // Differentiation matrix, excluding the contribution of the initial state
+    vector<vector<Complex> > A(deg_, vector<Complex>(deg_));
+    long double scale = 0;
+    for (int j=0; j<deg_; ++j) {
+      long double row_sum = 0;
+      for (int r=0; r<deg_; ++r) {
+        A[j][r] = C_[r+1][j+1];
+        row_sum += abs(A[j][r]);
+      }
+      scale = std::max(scale, row_sum);
+    }
+
+    // Eigenvalues from Durand-Kerner iterations on the characteristic polynomial
+    vector<Complex> lambda(deg_);
+    for (int i=0; i<deg_; ++i) lambda[i] = scale*pow(Complex(0.4L, 0.9L), i);
+    for (int iter=0; iter<1000; ++iter) {
+      long double max_step = 0;
+      for (int i=0; i<deg_; ++i) {
+        vector<vector<Complex> > M = A;
+        for (int j=0; j<deg_; ++j) M[j][j] -= lambda[i];
+        Complex den = 1;
+        for (int j=0; j<deg_; ++j) if (j!=i) den *= lambda[i]-lambda[j];
+        Complex step = (deg_ % 2 == 0 ? 1.0L : -1.0L) * gaussSolve(M, 0)/den;
+        lambda[i] -= step;
+        max_step = std::max(max_step, abs(step));
+      }
+      if (max_step <= 10*numeric_limits<long double>::epsilon()*scale) break;
+    }
+
+    // Real block diagonalization: one column per real eigenvalue, the real and imaginary part
+    // of the eigenvector for each complex conjugate pair
+    vector<vector<double> > T_col;
+    block_re_.clear();
+    block_im_.clear();
+    block_col_.clear();
+    for (int i=0; i<deg_; ++i) {
+      bool is_real = abs(lambda[i].imag()) <= 1e-10*scale;
+      if (!is_real && lambda[i].imag()<0) continue;
+      if (is_real) lambda[i] = lambda[i].real();
+
+      // Eigenvector by inverse iteration
+      vector<vector<Complex> > M = A;
+      for (int j=0; j<deg_; ++j) M[j][j] -= lambda[i];
+      vector<Complex> t(deg_);
+      for (int j=0; j<deg_; ++j) t[j] = 1 + 0.1L*j;
+      for (int iter=0; iter<3; ++iter) {
+        gaussSolve(M, &t);
+        long double t_max = 0;
+        for (int j=0; j<deg_; ++j) t_max = std::max(t_max, abs(t[j]));
+        for (int j=0; j<deg_; ++j) t[j] /= t_max;
+      }
+
+      // Add block
+      block_col_.push_back(T_col.size());
+      block_re_.push_back(lambda[i].real());
+      block_im_.push_back(is_real ? 0 : lambda[i].imag());
+      T_col.push_back(vector<double>(deg_));
+      for (int j=0; j<deg_; ++j) T_col.back()[j] = t[j].real();
+      if (!is_real) {
+        T_col.push_back(vector<double>(deg_));
+        for (int j=0; j<deg_; ++j) T_col.back()[j] = t[j].imag();
+      }
+    }
+    casadi_assert_message(T_col.size()==deg_, "CollocationIntegrator: Could not block diagonalize "
+                          "the differentiation matrix");
+
+    // Transformation matrix and its inverse
+    DMatrix T = DMatrix::zeros(deg_, deg_);
+    for (int j=0; j<deg_; ++j) {
+      for (int k=0; k<deg_; ++k) {
+        T.elem(j, k) = T_col[k][j];
+      }
+    }
+    DMatrix Tinv = inv(T);
+    T_.resize(deg_*deg_);
+    Tinv_.resize(deg_*deg_);
+    for (int j=0; j<deg_; ++j) {
+      for (int k=0; k<deg_; ++k) {
+        T_[j*deg_+k] = T.elem(j, k);
+        Tinv_[j*deg_+k] = Tinv.elem(j, k);
+      }
+    }
+
+    // Mass matrix
+    vector<int> ind = range(nx_);
+    DMatrix mass = DMatrix::triplet(ind, ind, vector<double>(nx_, 1.), n, n);
+
+    // DAE Jacobian, with respect to the stacked state and algebraic variable
+    MX t = MX::sym("t", f_.input(DAE_T).sparsity());
+    MX p = MX::sym("p", f_.input(DAE_P).sparsity());
+    MX xz = MX::sym("xz", n);
+    vector<int> xz_offset(1, 0);
+    xz_offset.push_back(nx_);
+    xz_offset.push_back(n);
+    vector<MX> xzv = vertsplit(xz, xz_offset);
+    vector<MX> f_arg(DAE_NUM_IN);
+    f_arg[DAE_T] = t;
+    f_arg[DAE_X] = reshape(xzv[0], this->x0().shape());
+    f_arg[DAE_Z] = reshape(xzv[1], this->z0().shape());
+    f_arg[DAE_P] = p;
+    vector<MX> f_res = f_(f_arg);
+    MX e = vertcat(vec(h_*f_res[DAE_ODE]), vec(f_res[DAE_ALG]));
+    vector<MX> jac_in;
+    jac_in.push_back(t);
+    jac_in.push_back(xz);
+    jac_in.push_back(p);
+    jac_ = MXFunction(jac_in, casadi::jacobian(e, xz));
+    jac_.init();
+
+    // Sparsity of the real and complex blocks
+    DMatrix K = DMatrix(jac_.output().sparsity(), 1) + mass;
+    Sparsity sp_real = K.sparsity();
+    Sparsity sp_complex = blockcat(K, mass, mass, K).sparsity();
+
+    // Nonzero positions of J and M in the blocks, J at (0, 0) and (1, 1) of the complex blocks
+    const Sparsity& sp_jac = jac_.output().sparsity();
+    vector<int> jac_col = sp_jac.getCol();
+    jac_nz_real_.resize(sp_jac.nnz());
+    jac_nz_complex_.resize(2*sp_jac.nnz());
+    for (int k=0; k<sp_jac.nnz(); ++k) {
+      int rr = sp_jac.row(k), cc = jac_col[k];
+      jac_nz_real_[k] = sp_real.getNZ(rr, cc);
+      jac_nz_complex_[2*k] = sp_complex.getNZ(rr, cc);
+      jac_nz_complex_[2*k+1] = sp_complex.getNZ(rr+n, cc+n);
+    }
+
+    // M at (0, 0), (1, 1), (0, 1) and (1, 0) of the complex blocks
+    mass_nz_real_.resize(nx_);
+    mass_nz_complex_.resize(4*nx_);
+    for (int i=0; i<nx_; ++i) {
+      mass_nz_real_[i] = sp_real.getNZ(i, i);
+      mass_nz_complex_[4*i] = sp_complex.getNZ(i, i);
+      mass_nz_complex_[4*i+1] = sp_complex.getNZ(i+n, i+n);
+      mass_nz_complex_[4*i+2] = sp_complex.getNZ(i, i+n);
+      mass_nz_complex_[4*i+3] = sp_complex.getNZ(i+n, i);
+    }
+
+    // Allocate a linear solver for each block
+    std::string linear_solver_name = getOption("linear_solver");
+    linsol_.resize(block_col_.size());
+    for (int b=0; b<linsol_.size(); ++b) {
+      linsol_[b] = LinearSolver(linear_solver_name,
+                                block_im_[b]==0 ? sp_real : sp_complex, 1);
+      if (hasSetOption("linear_solver_options")) {
+        linsol_[b].setOption(getOption("linear_solver_options"));
+      }
+      linsol_[b].init();
+    }
+
+    // Work vectors
+    res_.resize(deg_*n);
+    res_t_.resize(deg_*n);
+    v0_.resize(deg_*n);
+    has_fact_ = false;
+    n_newton_iter_ = n_jac_ = 0;
+  }
+
+  void CollocationIntegrator::factorize() {
+    n_jac_++;
+
+    // DAE Jacobian at the last collocation point of the current guess
+    int n = nx_+nz_;
+    jac_.input(0).set(t_ + h_*tau_end_);
+    jac_.input(1).set(getPtr(Z_.data())+(deg_-1)*n);
+    jac_.input(2).set(input(INTEGRATOR_P));
+    jac_.evaluate();
+    const vector<double>& J = jac_.output().data();
+
+    // Factorize the blocks J - lambda*M
+    for (int b=0; b<linsol_.size(); ++b) {
+      vector<double>& K = linsol_[b].input(LINSOL_A).data();
+      fill(K.begin(), K.end(), 0);
+      double re = block_re_[b], im = block_im_[b];
+      if (im==0) {
+        for (int k=0; k<J.size(); ++k) K[jac_nz_real_[k]] += J[k];
+        for (int i=0; i<nx_; ++i) K[mass_nz_real_[i]] -= re;
+      } else {
+        // [J - re*M, -im*M; im*M, J - re*M]
+        for (int k=0; k<J.size(); ++k) {
+          K[jac_nz_complex_[2*k]] += J[k];
+          K[jac_nz_complex_[2*k+1]] += J[k];
+        }
+        for (int i=0; i<nx_; ++i) {
+          K[mass_nz_complex_[4*i]] -= re;
+          K[mass_nz_complex_[4*i+1]] -= re;
+          K[mass_nz_complex_[4*i+2]] -= im;
+          K[mass_nz_complex_[4*i+3]] += im;
+        }
+      }
+      linsol_[b].prepare();
+    }
+    has_fact_ = true;
+  }
+
+  void CollocationIntegrator::takeStep() {
+    // Solve the collocation equations with the generic implicit function solver
+    if (!structured_newton_) {
+      ImplicitFixedStepIntegrator::takeStep();
+      return;
+    }
+
+    int n = nx_+nz_;
+
+    // Residual function, state at the beginning of the step
+    F_.input(DAE_T).set(t_);
+    F_.input(DAE_X).set(output(INTEGRATOR_XF));
+    F_.input(DAE_P).set(input(INTEGRATOR_P));
+
+    // Keep the initial guess in case the iterations need to be restarted
+    copy(Z_.begin(), Z_.end(), v0_.begin());
+
+    // Is the factorization from a previous step?
+    bool reused = has_fact_;
+
+    int iter = 0;
+    double nrm_step_prev = -1;
+    bool small_step = false;
+    while (true) {
+      // Factorize, unless a previous factorization is still good enough
+      if (!has_fact_) {
+        factorize();
+        nrm_step_prev = -1;
+      }
+
+      // Evaluate the residual
+      F_.input(DAE_Z).set(Z_);
+      F_.evaluate();
+      F_.output(DAE_ALG).get(res_);
+      if (small_step || norm_inf(res_) <= newton_abstol_) break;
+      casadi_assert_message(iter<newton_max_iter_, "CollocationIntegrator: Structured Newton "
+                            "method did not converge at t = " << t_);
+
+      // Transform the residual
+      fill(res_t_.begin(), res_t_.end(), 0);
+      for (int k=0; k<deg_; ++k) {
+        for (int j=0; j<deg_; ++j) {
+          double Tinv_kj = Tinv_[k*deg_+j];
+          if (Tinv_kj==0) continue;
+          for (int i=0; i<n; ++i) res_t_[k*n+i] += Tinv_kj*res_[j*n+i];
+        }
+      }
+
+      // Solve the decoupled systems
+      for (int b=0; b<linsol_.size(); ++b) {
+        linsol_[b].solve(getPtr(res_t_)+block_col_[b]*n, 1, false);
+      }
+
+      // Transform back and take the step
+      double nrm_step = 0;
+      for (int j=0; j<deg_; ++j) {
+        for (int i=0; i<n; ++i) {
+          double d = 0;
+          for (int k=0; k<deg_; ++k) d += T_[j*deg_+k]*res_t_[k*n+i];
+          Z_.at(j*n+i) -= d;
+          nrm_step = std::max(nrm_step, fabs(d));
+        }
+      }
+      iter++;
+      n_newton_iter_++;
+      small_step = nrm_step <= newton_abstol_;
+
+      // Refactorize at the current iterate if the convergence is slow
+      if (nrm_step_prev>0) {
+        double contraction = nrm_step/nrm_step_prev;
+
+        // Estimate the remaining error from the contraction rate, as in RADAU5
+        if (contraction<1) {
+          small_step = small_step || contraction/(1-contraction)*nrm_step <= newton_abstol_;
+        }
+        if (!(contraction <= newton_contraction_max_)) {
+          // Start over if a factorization from a previous step caused divergence
+          if (reused && !(contraction<1)) {
+            copy(v0_.begin(), v0_.end(), Z_.begin());
+            small_step = false;
+          }
+          reused = false;
+          has_fact_ = false;
+        }
+      }
+      nrm_step_prev = nrm_step;
+    }
+
+    // Update the state and quadratures
+    F_.output(DAE_ODE).get(output(INTEGRATOR_XF));
+    transform(F_.output(DAE_QUAD).begin(),
+              F_.output(DAE_QUAD).end(),
+              output(INTEGRATOR_QF).begin(),
+              output(INTEGRATOR_QF).begin(),
+              std::plus<double>());
+
+    if (gather_stats_) {
+      stats_["n_newton_iter"] = n_newton_iter_;
+      stats_["n_jac"] = n_jac_;
+    }
+  }
+
+  void CollocationIntegrator::reset() {
+    // Reset the base classes
+    ImplicitFixedStepIntegrator::reset();
+
+    // The factorization is not reused between calls
+    if (structured_newton_) {
+      has_fact_ = false;
+      n_newton_iter_ = n_jac_ = 0;
+    }
   }
 
   void CollocationIntegrator::setupFG() {
@@ -118,6 +503,10 @@ namespace casadi {
       B[j] = zeroIfSmall(ip(1.0L));
     }
 
+    // Save the differentiation matrix for the structured Newton method
+    C_ = C;
+    tau_end_ = tau_root[deg_];
+
     // Symbolic inputs
     MX x0 = MX::sym("x0", f_.input(DAE_X).sparsity());
     MX p = MX::sym("p", f_.input(DAE_P).sparsity());
@@ -29,6 +29,7 @@
 #include "implicit_fixed_step_integrator.hpp"
 #include "casadi/core/function/mx_function.hpp"
 #include "casadi/core/function/implicit_function.hpp"
+#include "casadi/core/function/linear_solver.hpp"
 #include "casadi/core/misc/integration_tools.hpp"
 #include <casadi/solvers/casadi_integrator_collocation_export.h>
 
@@ -89,15 +90,72 @@ namespace casadi {
     // Return zero if smaller than machine epsilon
     static double zeroIfSmall(double x);
 
+    /// Take a single step forward in time, starting at t_
+    virtual void takeStep();
+
+    /// Reset the forward problem and bring the time back to t0
+    virtual void reset();
+
     /// Get initial guess for the algebraic variable
     virtual void calculateInitialConditions();
 
     /// Get initial guess for the algebraic variable (backward problem)
     virtual void calculateInitialConditionsB();
 
+    /** \brief Prepare the structured Newton method
+     * The Newton matrix of the collocation equations is I (x) J - C (x) M, with J the
+     * (scaled) DAE Jacobian, M = diag(I, 0) and C the differentiation matrix at the collocation
+     * points. Block diagonalizing C = T*L*inv(T) decouples it into one system of the size of the
+     * DAE for each real eigenvalue of C and one system of twice that size for each complex pair.
+     */
+    void setupStructuredNewton();
+
+    /// Evaluate the DAE Jacobian at the last collocation point and factorize all blocks
+    void factorize();
+
     // Interpolation order
     int deg_;
 
+    // Differentiation matrix: derivative of Lagrange polynomial j at collocation point r
+    std::vector<std::vector<double> > C_;
+
+    // Last collocation point, relative to the start of the step
+    double tau_end_;
+
+    /// Exploit the Kronecker structure of the Newton matrix
+    bool structured_newton_;
+
+    /// Stopping criterion and contraction rate limit for the structured Newton method
+    double newton_abstol_, newton_contraction_max_;
+
+    /// Maximum number of structured Newton iterations
+    int newton_max_iter_;
+
+    /// Block diagonalization of the differentiation matrix, dense and row-major
+    std::vector<double> T_, Tinv_;
+
+    /// Real and imaginary part of the eigenvalue for each block, first column of the block
+    std::vector<double> block_re_, block_im_;
+    std::vector<int> block_col_;
+
+    /// DAE Jacobian, with the ODE rows scaled by the step size
+    Function jac_;
+
+    /// Nonzero indices of the DAE Jacobian and the mass matrix in the real and complex blocks
+    std::vector<int> jac_nz_real_, jac_nz_complex_, mass_nz_real_, mass_nz_complex_;
+
+    /// Linear solver for each block
+    std::vector<LinearSolver> linsol_;
+
+    /// Is there a factorization which can be reused?
+    bool has_fact_;
+
+    /// Work vectors: residual, transformed residual, initial guess
+    std::vector<double> res_, res_t_, v0_;
+
+    /// Counters for the structured Newton method
+    int n_newton_iter_, n_jac_;
+
     /// A documentation string
     static const std::string meta_doc;
 
@@ -39,6 +39,26 @@
 "+-----------------+-----------------+-----------------+-----------------+\n"
 "|       Id        |      Type       |     Default     |   Description   |\n"
 "+=================+=================+=================+=================+\n"
+"| checkpoints     | OT_INTEGER      | 0               | Number of       |\n"
+"|                 |                 |                 | forward         |\n"
+"|                 |                 |                 | solutions kept  |\n"
+"|                 |                 |                 | for the         |\n"
+"|                 |                 |                 | backward        |\n"
+"|                 |                 |                 | problem. With   |\n"
+"|                 |                 |                 | 0, the full     |\n"
+"|                 |                 |                 | forward         |\n"
+"|                 |                 |                 | trajectory is   |\n"
+"|                 |                 |                 | stored.         |\n"
+"|                 |                 |                 | Otherwise,      |\n"
+"|                 |                 |                 | forward steps   |\n"
+"|                 |                 |                 | are recomputed  |\n"
+"|                 |                 |                 | from            |\n"
+"|                 |                 |                 | checkpoints     |\n"
+"|                 |                 |                 | placed in a     |\n"
+"|                 |                 |                 | binomial        |\n"
+"|                 |                 |                 | (revolve)       |\n"
+"|                 |                 |                 | schedule        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| collocation_sch | OT_STRING       | \"radau\"         | Collocation     |\n"
 "| eme             |                 |                 | scheme (radau|l |\n"
 "|                 |                 |                 | egendre)        |\n"
@@ -54,9 +74,78 @@
 "| rder            |                 |                 | interpolating   |\n"
 "|                 |                 |                 | polynomials     |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| linear_solver   | OT_STRING       | \"csparse\"       | Linear solver   |\n"
+"|                 |                 |                 | for the         |\n"
+"|                 |                 |                 | structured      |\n"
+"|                 |                 |                 | Newton method   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| linear_solver_o | OT_DICTIONARY   | GenericType()   | Options to be   |\n"
+"| ptions          |                 |                 | passed to the   |\n"
+"|                 |                 |                 | linear solver   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| newton_abstol   | OT_REAL         | 1e-12           | Stopping        |\n"
+"|                 |                 |                 | criterion       |\n"
+"|                 |                 |                 | tolerance on    |\n"
+"|                 |                 |                 | max(|F|) and on |\n"
+"|                 |                 |                 | the step size   |\n"
+"|                 |                 |                 | for the         |\n"
+"|                 |                 |                 | structured      |\n"
+"|                 |                 |                 | Newton method   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| newton_contract | OT_REAL         | 0.1             | Refactorize at  |\n"
+"| ion_max         |                 |                 | the current     |\n"
+"|                 |                 |                 | iterate when    |\n"
+"|                 |                 |                 | the ratio       |\n"
+"|                 |                 |                 | between         |\n"
+"|                 |                 |                 | consecutive     |\n"
+"|                 |                 |                 | Newton step     |\n"
+"|                 |                 |                 | sizes exceeds   |\n"
+"|                 |                 |                 | this value,     |\n"
+"|                 |                 |                 | otherwise the   |\n"
+"|                 |                 |                 | factorization   |\n"
+"|                 |                 |                 | is kept for the |\n"
+"|                 |                 |                 | following steps |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| newton_max_iter | OT_INTEGER      | 50              | Maximum number  |\n"
+"|                 |                 |                 | of structured   |\n"
+"|                 |                 |                 | Newton          |\n"
+"|                 |                 |                 | iterations in a |\n"
+"|                 |                 |                 | step            |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| number_of_finit | OT_INTEGER      | 20              | Number of       |\n"
 "| e_elements      |                 |                 | finite elements |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| structured_newt | OT_BOOLEAN      | false           | Solve the       |\n"
+"| on              |                 |                 | collocation     |\n"
+"|                 |                 |                 | equations with  |\n"
+"|                 |                 |                 | a simplified    |\n"
+"|                 |                 |                 | Newton method   |\n"
+"|                 |                 |                 | that decouples  |\n"
+"|                 |                 |                 | the Newton      |\n"
+"|                 |                 |                 | matrix using    |\n"
+"|                 |                 |                 | the eigenvalues |\n"
+"|                 |                 |                 | of the          |\n"
+"|                 |                 |                 | collocation     |\n"
+"|                 |                 |                 | scheme, instead |\n"
+"|                 |                 |                 | of passing them |\n"
+"|                 |                 |                 | to              |\n"
+"|                 |                 |                 | implicit_solver |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+------------------+\n"
+"|        Id        |\n"
+"+==================+\n"
+"| n_jac            |\n"
+"+------------------+\n"
+"| n_newton_iter    |\n"
+"+------------------+\n"
+"| n_recompute      |\n"
+"+------------------+\n"
+"| peak_tape_memory |\n"
+"+------------------+\n"
 "\n"
 "\n"
 "\n"
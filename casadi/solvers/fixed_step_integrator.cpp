@@ -37,6 +37,10 @@ namespace casadi {
                                                            const Function& g)
       : IntegratorInternal(f, g) {
     addOption("number_of_finite_elements",     OT_INTEGER,  20, "Number of finite elements");
+    addOption("checkpoints",                   OT_INTEGER,  0,
+              "Number of forward solutions kept for the backward problem. With 0, the full "
+              "forward trajectory is stored. Otherwise, forward steps are recomputed from "
+              "checkpoints placed in a binomial (revolve) schedule");
   }
 
   void FixedStepIntegrator::deepCopyMembers(
@@ -56,6 +60,8 @@ namespace casadi {
     // Number of finite elements and time steps
     nk_ = getOption("number_of_finite_elements");
     casadi_assert(nk_>0);
+    checkpoints_ = getOption("checkpoints");
+    casadi_assert_message(checkpoints_>=0, "Option \"checkpoints\" must be nonnegative");
     h_ = (tf_ - t0_)/nk_;
 
     // Setup discrete time dynamics
@@ -67,10 +73,21 @@ namespace casadi {
     RZ_ = G_.isNull() ? DMatrix() : G_.input(RDAE_RZ);
     nRZ_ =  RZ_.nnz();
 
-    // Allocate tape if backward states are present
+    // Allocate tape or checkpoints if backward states are present
     if (nrx_>0) {
-      x_tape_.resize(nk_+1, vector<double>(nx_));
-      Z_tape_.resize(nk_, vector<double>(nZ_));
+      if (checkpoints_>0) {
+        ckp_x_.resize(checkpoints_, vector<double>(nx_));
+        ckp_Z_.resize(checkpoints_, vector<double>(nZ_));
+        ckp_k_.reserve(checkpoints_);
+        x_step_.resize(nx_);
+        Z_step_.resize(nZ_);
+        xf_save_.resize(nx_);
+        qf_save_.resize(nq_);
+        Z_save_.resize(nZ_);
+      } else {
+        x_tape_.resize(nk_+1, vector<double>(nx_));
+        Z_tape_.resize(nk_, vector<double>(nZ_));
+      }
     }
   }
 
@@ -80,27 +97,19 @@ namespace casadi {
     k_out = std::min(k_out, nk_); //  make sure that rounding errors does not result in k_out>nk_
     casadi_assert(k_out>=0);
 
-    // Explicit discrete time dynamics
-    Function& F = getExplicit();
-
     // Take time steps until end time has been reached
     while (k_<k_out) {
+      // Checkpoint
+      if (nrx_>0 && checkpoints_>0 && k_==next_checkpoint_) {
+        pushCheckpoint(k_);
+        next_checkpoint_ = nextCheckpoint(nk_);
+      }
+
       // Take step
-      F.input(DAE_T).set(t_);
-      F.input(DAE_X).set(output(INTEGRATOR_XF));
-      F.input(DAE_Z).set(Z_);
-      F.input(DAE_P).set(input(INTEGRATOR_P));
-      F.evaluate();
-      F.output(DAE_ODE).get(output(INTEGRATOR_XF));
-      F.output(DAE_ALG).get(Z_);
-      transform(F.output(DAE_QUAD).begin(),
-                F.output(DAE_QUAD).end(),
-                output(INTEGRATOR_QF).begin(),
-                output(INTEGRATOR_QF).begin(),
-                std::plus<double>());
+      takeStep();
 
       // Tape
-      if (nrx_>0) {
+      if (nrx_>0 && checkpoints_==0) {
         output(INTEGRATOR_XF).getNZ(x_tape_.at(k_+1));
         Z_.getNZ(Z_tape_.at(k_));
       }
@@ -111,6 +120,25 @@ namespace casadi {
     }
   }
 
+  void FixedStepIntegrator::takeStep() {
+    // Explicit discrete time dynamics
+    Function& F = getExplicit();
+
+    // Evaluate and update the state, algebraic variables and quadratures
+    F.input(DAE_T).set(t_);
+    F.input(DAE_X).set(output(INTEGRATOR_XF));
+    F.input(DAE_Z).set(Z_);
+    F.input(DAE_P).set(input(INTEGRATOR_P));
+    F.evaluate();
+    F.output(DAE_ODE).get(output(INTEGRATOR_XF));
+    F.output(DAE_ALG).get(Z_);
+    transform(F.output(DAE_QUAD).begin(),
+              F.output(DAE_QUAD).end(),
+              output(INTEGRATOR_QF).begin(),
+              output(INTEGRATOR_QF).begin(),
+              std::plus<double>());
+  }
+
   void FixedStepIntegrator::integrateB(double t_out) {
     // Get discrete time sought
     int k_out = std::floor((t_out-t0_)/h_);
@@ -126,10 +154,18 @@ namespace casadi {
       k_--;
       t_ = t0_ + k_*h_;
 
+      // Forward solution, recomputed from a checkpoint if not taped
+      if (checkpoints_>0) {
+        recompute(k_);
+        G.input(RDAE_X).setNZ(x_step_);
+        G.input(RDAE_Z).setNZ(Z_step_);
+      } else {
+        G.input(RDAE_X).setNZ(x_tape_.at(k_));
+        G.input(RDAE_Z).setNZ(Z_tape_.at(k_));
+      }
+
       // Take step
       G.input(RDAE_T).set(t_);
-      G.input(RDAE_X).setNZ(x_tape_.at(k_));
-      G.input(RDAE_Z).setNZ(Z_tape_.at(k_));
       G.input(RDAE_P).set(input(INTEGRATOR_P));
       G.input(RDAE_RX).set(output(INTEGRATOR_RXF));
       G.input(RDAE_RZ).set(RZ_);
@@ -143,6 +179,97 @@ namespace casadi {
                 output(INTEGRATOR_RQF).begin(),
                 std::plus<double>());
     }
+
+    if (gather_stats_) {
+      // Memory needed for the forward solution, in bytes (floating point, may exceed 2 GB)
+      double tape_size = checkpoints_>0 ? (ckp_peak_+1.)*(nx_+nZ_) : (nk_+1.)*nx_ + nk_*nZ_;
+      stats_["n_recompute"] = n_recompute_;
+      stats_["peak_tape_memory"] = tape_size*sizeof(double);
+    }
+  }
+
+  int FixedStepIntegrator::binomialAdvance(int steps, int snaps) {
+    // More checkpoints than steps do not help
+    snaps = std::min(snaps, steps);
+
+    // Smallest number of repetitions such that binomial(snaps+reps, snaps) >= steps
+    long long reps = 0, range = 1;
+    while (range<steps) {
+      reps++;
+      range = range*(reps+snaps)/reps;
+    }
+
+    // Optimal position of the next checkpoint, following revolve
+    long long bino1 = range*reps/(snaps+reps);
+    long long bino2 = snaps>1 ? bino1*snaps/(snaps+reps-1) : 1;
+    long long bino3 = snaps==1 ? 0 : snaps>2 ? bino2*(snaps-1)/(snaps+reps-2) : 1;
+    long long bino4 = bino2*(reps-1)/snaps;
+    long long bino5 = snaps<3 ? 0 : snaps>3 ? bino3*(snaps-2)/(reps+snaps-3) : 1;
+    long long advance;
+    if (steps<=bino1+bino3) {
+      advance = bino4;
+    } else if (steps>=range-bino5) {
+      advance = bino1;
+    } else {
+      advance = steps-bino2-bino3;
+    }
+    return std::max(static_cast<int>(advance), 1);
+  }
+
+  int FixedStepIntegrator::nextCheckpoint(int k_end) const {
+    int k = ckp_k_.back();
+    int n_free = checkpoints_ - ckp_k_.size();
+    if (n_free==0 || k_end-k<=1) return k_end;
+    return k + binomialAdvance(k_end-k, n_free+1);
+  }
+
+  void FixedStepIntegrator::pushCheckpoint(int k) {
+    int i = ckp_k_.size();
+    ckp_k_.push_back(k);
+    output(INTEGRATOR_XF).getNZ(ckp_x_.at(i));
+    Z_.getNZ(ckp_Z_.at(i));
+    ckp_peak_ = std::max(ckp_peak_, i+1);
+  }
+
+  void FixedStepIntegrator::recompute(int k) {
+    // Checkpoints beyond step k are no longer needed
+    while (ckp_k_.back()>k) ckp_k_.pop_back();
+
+    // Save the forward solution, which is overwritten when taking steps
+    double t = t_;
+    output(INTEGRATOR_XF).getNZ(xf_save_);
+    output(INTEGRATOR_QF).getNZ(qf_save_);
+    Z_.getNZ(Z_save_);
+
+    // Restart from the last checkpoint
+    int j = ckp_k_.back();
+    output(INTEGRATOR_XF).setNZ(ckp_x_.at(ckp_k_.size()-1));
+    Z_.setNZ(ckp_Z_.at(ckp_k_.size()-1));
+
+    // Advance to step k, placing new checkpoints on the way
+    while (j<k) {
+      int j_next = std::min(nextCheckpoint(k+1), k);
+      while (j<j_next) {
+        t_ = t0_ + j*h_;
+        takeStep();
+        j++;
+        n_recompute_++;
+      }
+      if (j<k) pushCheckpoint(j);
+    }
+
+    // Take step k to get the algebraic variables
+    output(INTEGRATOR_XF).getNZ(x_step_);
+    t_ = t0_ + k*h_;
+    takeStep();
+    n_recompute_++;
+    Z_.getNZ(Z_step_);
+
+    // Restore the forward solution
+    t_ = t;
+    output(INTEGRATOR_XF).setNZ(xf_save_);
+    output(INTEGRATOR_QF).setNZ(qf_save_);
+    Z_.setNZ(Z_save_);
   }
 
   void FixedStepIntegrator::reset() {
@@ -155,9 +282,17 @@ namespace casadi {
     // Get consistent initial conditions
     calculateInitialConditions();
 
-    // Add the first element in the tape
+    // Add the first element in the tape, or the first checkpoint
     if (nrx_>0) {
-      output(INTEGRATOR_XF).getNZ(x_tape_.at(0));
+      n_recompute_ = 0;
+      if (checkpoints_>0) {
+        ckp_k_.clear();
+        ckp_peak_ = 0;
+        pushCheckpoint(0);
+        next_checkpoint_ = nextCheckpoint(nk_);
+      } else {
+        output(INTEGRATOR_XF).getNZ(x_tape_.at(0));
+      }
     }
   }
 
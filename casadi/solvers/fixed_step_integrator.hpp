@@ -61,6 +61,9 @@ namespace casadi {
     ///  Integrate until a specified time point
     virtual void integrate(double t_out);
 
+    /// Take a single step forward in time, starting at t_
+    virtual void takeStep();
+
     /// Integrate backward in time until a specified time point
     virtual void integrateB(double t_out);
 
@@ -103,6 +106,40 @@ namespace casadi {
     // Tape
     std::vector<std::vector<double> > x_tape_, Z_tape_;
 
+    /** \brief Number of forward steps to take before the next checkpoint
+     * Binomial (revolve) schedule for reversing \a steps steps with \a snaps checkpoints,
+     * including the one at the current step.
+     */
+    static int binomialAdvance(int steps, int snaps);
+
+    /// Discrete time of the next checkpoint when reversing the steps up to k_end
+    int nextCheckpoint(int k_end) const;
+
+    /// Store the current forward solution as a checkpoint for discrete time k
+    void pushCheckpoint(int k);
+
+    /// Recompute the forward solution at discrete time k from the checkpoints
+    void recompute(int k);
+
+    /// Maximum number of checkpoints, 0 if the full forward solution is taped
+    int checkpoints_;
+
+    /// Checkpoints: discrete time, state and algebraic variables
+    std::vector<int> ckp_k_;
+    std::vector<std::vector<double> > ckp_x_, ckp_Z_;
+
+    /// Discrete time where the forward sweep places the next checkpoint
+    int next_checkpoint_;
+
+    /// Recomputed forward solution for a step
+    std::vector<double> x_step_, Z_step_;
+
+    /// Forward solution saved during recomputation
+    std::vector<double> xf_save_, qf_save_, Z_save_;
+
+    /// Statistics: recomputed forward steps, maximum number of checkpoints in use
+    int n_recompute_, ckp_peak_;
+
   };
 
 } // namespace casadi
@@ -56,26 +56,32 @@ namespace casadi {
     // Call the base class init
     FixedStepIntegrator::init();
 
-    // Get the NLP creator function
-    std::string implicit_function_name = getOption("implicit_solver");
-
-    // Allocate an NLP solver
-    implicit_solver_ = ImplicitFunction(implicit_function_name, F_, Function(), LinearSolver());
-    implicit_solver_.setOption("name", string(getOption("name")) + "_implicit_solver");
-    implicit_solver_.setOption("implicit_input", DAE_Z);
-    implicit_solver_.setOption("implicit_output", DAE_ALG);
-
-    // Pass options
-    if (hasSetOption("implicit_solver_options")) {
-      const Dictionary& implicit_solver_options = getOption("implicit_solver_options");
-      implicit_solver_.setOption(implicit_solver_options);
-    }
+    // The forward problem may be solved by the derived class instead
+    if (hasSetOption("implicit_solver")) {
+
+      // Get the NLP creator function
+      std::string implicit_function_name = getOption("implicit_solver");
 
-    // Initialize the solver
-    implicit_solver_.init();
+      // Allocate an NLP solver
+      implicit_solver_ = ImplicitFunction(implicit_function_name, F_, Function(), LinearSolver());
+      implicit_solver_.setOption("name", string(getOption("name")) + "_implicit_solver");
+      implicit_solver_.setOption("implicit_input", DAE_Z);
+      implicit_solver_.setOption("implicit_output", DAE_ALG);
+
+      // Pass options
+      if (hasSetOption("implicit_solver_options")) {
+        const Dictionary& implicit_solver_options = getOption("implicit_solver_options");
+        implicit_solver_.setOption(implicit_solver_options);
+      }
+
+      // Initialize the solver
+      implicit_solver_.init();
+    }
 
     // Allocate a root-finding solver for the backward problem
     if (nRZ_>0) {
+      casadi_assert_message(hasSetOption("implicit_solver"),
+                            "Option \"implicit_solver\" is required for the backward problem");
 
       // Get the NLP creator function
       std::string backward_implicit_function_name = getOption("implicit_solver");
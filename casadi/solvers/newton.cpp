@@ -63,6 +63,17 @@ namespace casadi {
 
     addOption("print_iteration", OT_BOOLEAN, false,
               "Print information about each iteration");
+    addOption("jacobian_reuse", OT_STRING, "none",
+              "Reuse the factorized Jacobian over iterations and calls: evaluate it every "
+              "iteration (none), keep it until convergence slows down (frozen) or keep it "
+              "and apply Broyden rank-1 updates (broyden)", "none|frozen|broyden");
+    addOption("contraction_max", OT_REAL, 0.5,
+              "Refresh a reused Jacobian when the ratio between consecutive step sizes "
+              "exceeds this value");
+    addOption("broyden_memory", OT_INTEGER, 20,
+              "Maximum number of Broyden updates before the Jacobian is refreshed");
+    addOption("warm_start", OT_BOOLEAN, false,
+              "Start from the solution of the previous call instead of the initial guess");
   }
 
   Newton::~Newton() {
@@ -80,18 +91,35 @@ namespace casadi {
       CasadiOptions::profilingLog  << "start " << this << ":" <<getOption("name") << std::endl;
     }
 
-    // Pass the inputs to J
+    // Aliases
+    DMatrix &u = output(iout_);
+    bool reuse = jacobian_reuse_!=JAC_NEWTON;
+
+    // Warm start from the previous solution
+    if (warm_start_ && !u_prev_.empty()) u.set(u_prev_);
+
+    // Pass the inputs to J and, if the Jacobian is reused, to f
     for (int i=0; i<getNumInputs(); ++i) {
-      if (i!=iin_) jac_.setInput(input(i), i);
+      if (i!=iin_) {
+        jac_.setInput(input(i), i);
+        if (reuse) f_.setInput(input(i), i);
+      }
     }
 
-    // Aliases
-    DMatrix &u = output(iout_);
-    DMatrix &J = jac_.output(0);
-    DMatrix &F = jac_.output(1+iout_);
+    // Refresh the Jacobian in the first iteration, unless a factorization can be reused
+    bool refresh = !reuse || !has_fact_;
+
+    // Size of the last step taken with the current Jacobian, -1 if none
+    double stepsize_prev = -1;
+
+    // Number of Broyden updates since the last factorization
+    int n_s = 0;
 
     // Perform the Newton iterations
-    int iter=0;
+    int iter=0, n_jac=0, n_fact=0;
+
+    // Function that was last evaluated, holding the auxiliary outputs
+    Function* fcn = &jac_;
 
     bool success = true;
 
@@ -116,16 +144,18 @@ namespace casadi {
         std::cout << "  u = " << u << std::endl;
       }
 
-      // Use u to evaluate J
-      jac_.setInput(u, iin_);
-      for (int i=0; i<getNumInputs(); ++i)
-        if (i!=iin_) jac_.setInput(input(i), i);
+      // Use u to evaluate J, or only the residual if the Jacobian is kept
+      if (!reuse) refresh = true;
+      bool refreshed = refresh;
+      fcn = refresh ? &jac_ : &f_;
+      fcn->setInput(u, iin_);
 
       if (CasadiOptions::profiling) {
         time_start = getRealTime(); // Start timer
       }
 
-      jac_.evaluate();
+      fcn->evaluate();
+      if (refresh) n_jac++;
 
       // Write out profiling information
       if (CasadiOptions::profiling && !CasadiOptions::profilingBinary) {
@@ -133,17 +163,21 @@ namespace casadi {
         CasadiOptions::profilingLog
             << (time_stop-time_start)*1e6 << " ns | "
             << (time_stop-time_zero)*1e3 << " ms | "
-            << this << ":" << getOption("name") << ":0|" << jac_.get() << ":"
-            << jac_.getOption("name") << "|evaluate jacobian" << std::endl;
+            << this << ":" << getOption("name") << ":0|" << fcn->get() << ":"
+            << fcn->getOption("name") << "|evaluate "
+            << (refresh ? "jacobian" : "residual") << std::endl;
       }
 
+      // Residual
+      const DMatrix &F = fcn->output(refresh ? 1+iout_ : iout_);
+
       if (monitored("F")) std::cout << "  F = " << F << std::endl;
       if (monitored("normF"))
         std::cout << "  F (min, max, 1-norm, 2-norm) = "
                   << (*std::min_element(F.data().begin(), F.data().end()))
                   << ", " << (*std::max_element(F.data().begin(), F.data().end()))
                   << ", " << sumAll(fabs(F)) << ", " << sqrt(sumAll(F*F)) << std::endl;
-      if (monitored("J")) std::cout << "  J = " << J << std::endl;
+      if (monitored("J") && refresh) std::cout << "  J = " << jac_.output(0) << std::endl;
 
       double abstol = 0;
       if (numeric_limits<double>::infinity() != abstol_) {
@@ -157,28 +191,38 @@ namespace casadi {
         }
       }
 
-      // Prepare the linear solver with J
-      linsol_.setInput(J, LINSOL_A);
+      if (refresh) {
+        // Prepare the linear solver with J
+        linsol_.setInput(jac_.output(0), LINSOL_A);
 
-      if (CasadiOptions::profiling) {
-        time_start = getRealTime(); // Start timer
-      }
-      linsol_.prepare();
-      // Write out profiling information
-      if (CasadiOptions::profiling && !CasadiOptions::profilingBinary) {
-        time_stop = getRealTime(); // Stop timer
-        CasadiOptions::profilingLog
-            << (time_stop-time_start)*1e6 << " ns | "
-            << (time_stop-time_zero)*1e3 << " ms | "
-            << this << ":" << getOption("name")
-            << ":1||prepare linear system" << std::endl;
+        if (CasadiOptions::profiling) {
+          time_start = getRealTime(); // Start timer
+        }
+        linsol_.prepare();
+        n_fact++;
+        // Write out profiling information
+        if (CasadiOptions::profiling && !CasadiOptions::profilingBinary) {
+          time_stop = getRealTime(); // Stop timer
+          CasadiOptions::profilingLog
+              << (time_stop-time_start)*1e6 << " ns | "
+              << (time_stop-time_zero)*1e3 << " ms | "
+              << this << ":" << getOption("name")
+              << ":1||prepare linear system" << std::endl;
+        }
+
+        // Start over with the new factorization
+        has_fact_ = true;
+        refresh = false;
+        stepsize_prev = -1;
+        n_s = 0;
       }
 
       if (CasadiOptions::profiling) {
         time_start = getRealTime(); // Start timer
       }
       // Solve against F
-      linsol_.solve(&F.front(), 1, false);
+      copy(F.begin(), F.end(), step_.begin());
+      linsol_.solve(getPtr(step_), 1, false);
       if (CasadiOptions::profiling && !CasadiOptions::profilingBinary) {
         time_stop = getRealTime(); // Stop timer
         CasadiOptions::profilingLog
@@ -187,16 +231,19 @@ namespace casadi {
             << this << ":" << getOption("name") << ":2||solve linear system" << std::endl;
       }
 
+      // Broyden update of the step, refresh the Jacobian on breakdown
+      if (jacobian_reuse_==JAC_BROYDEN && n_s>0 && !broydenStep(n_s)) {
+        refresh = true;
+        continue;
+      }
+
       if (monitored("step")) {
-        std::cout << "  step = " << F << std::endl;
+        std::cout << "  step = " << step_ << std::endl;
       }
 
-      double abstolStep=0;
+      double abstolStep = std::max((*std::max_element(step_.begin(), step_.end())),
+                                   -(*std::min_element(step_.begin(), step_.end())));
       if (numeric_limits<double>::infinity() != abstolStep_) {
-        abstolStep = std::max((*std::max_element(F.data().begin(),
-                                                  F.data().end())),
-                               -(*std::min_element(F.data().begin(),
-                                                   F.data().end())));
         if (monitored("stepsize")) {
           std::cout << "  stepsize = " << abstolStep << std::endl;
         }
@@ -216,27 +263,78 @@ namespace casadi {
         printIteration(std::cout, iter, abstol, abstolStep);
       }
 
-      // Update Xk+1 = Xk - J^(-1) F
-      std::transform(u.begin(), u.end(), F.begin(), u.begin(), std::minus<double>());
+      // Refresh a reused Jacobian if the iteration contracts too slowly, drop diverging steps
+      if (reuse && !refreshed && stepsize_prev>0) {
+        double theta = abstolStep/stepsize_prev;
+        if (theta > contraction_max_) {
+          refresh = true;
+          if (theta >= 1) continue;
+        }
+      }
 
+      // Update Xk+1 = Xk - J^(-1) F
+      std::transform(u.begin(), u.end(), step_.begin(), u.begin(), std::minus<double>());
+      stepsize_prev = abstolStep;
+
+      // Store the step for the Broyden updates, refresh when the memory is exhausted
+      if (jacobian_reuse_==JAC_BROYDEN) {
+        if (n_s==broyden_memory_) {
+          refresh = true;
+        } else {
+          std::vector<double>& s = broyden_s_[n_s];
+          double nrm2 = 0;
+          for (int k=0; k<n_; ++k) {
+            s[k] = -step_[k];
+            nrm2 += s[k]*s[k];
+          }
+          broyden_nrm2_[n_s++] = nrm2;
+        }
+      }
     }
 
     // Get auxiliary outputs
+    int offset = fcn==&jac_ ? 1 : 0;
     for (int i=0; i<getNumOutputs(); ++i) {
-      if (i!=iout_) jac_.getOutput(output(i), 1+i);
+      if (i!=iout_) fcn->getOutput(output(i), offset+i);
     }
 
-    // Store the iteration count
-    if (gather_stats_) stats_["iter"] = iter;
+    // Store the iteration count and the number of Jacobian evaluations and factorizations
+    if (gather_stats_) {
+      stats_["iter"] = iter;
+      stats_["n_jac"] = n_jac;
+      stats_["n_fact"] = n_fact;
+    }
 
     if (success) stats_["return_status"] = "success";
 
-    // Factorization up-to-date
-    fact_up_to_date_ = true;
+    // Remember the solution for a warm start
+    if (warm_start_) u_prev_ = u.data();
+
+    // Factorization up-to-date if the last Jacobian was evaluated at the solution
+    fact_up_to_date_ = fcn==&jac_;
 
     casadi_log("Newton::solveNonLinear():end after " << iter << " steps");
   }
 
+  bool Newton::broydenStep(int n_s) {
+    // z = -B0\F, available with the opposite sign in step_
+    for (int k=0; k<n_; ++k) step_[k] = -step_[k];
+
+    // Apply the updates of the previous steps
+    for (int j=0; j+1<n_s; ++j) {
+      const std::vector<double>& s = broyden_s_[j];
+      const std::vector<double>& s_next = broyden_s_[j+1];
+      double a = inner_prod(s, step_)/broyden_nrm2_[j];
+      for (int k=0; k<n_; ++k) step_[k] += a*s_next[k];
+    }
+
+    // New step, returned with the sign convention of the Newton step
+    double a = 1 - inner_prod(broyden_s_[n_s-1], step_)/broyden_nrm2_[n_s-1];
+    if (fabs(a) < 1e-12) return false;
+    for (int k=0; k<n_; ++k) step_[k] /= -a;
+    return true;
+  }
+
   void Newton::init() {
 
     // Call the base class initializer
@@ -258,6 +356,36 @@ namespace casadi {
 
     print_iteration_ = getOption("print_iteration");
 
+    // Jacobian reuse
+    std::string jacobian_reuse = getOption("jacobian_reuse");
+    if (jacobian_reuse=="none") {
+      jacobian_reuse_ = JAC_NEWTON;
+    } else if (jacobian_reuse=="frozen") {
+      jacobian_reuse_ = JAC_FROZEN;
+    } else if (jacobian_reuse=="broyden") {
+      jacobian_reuse_ = JAC_BROYDEN;
+    } else {
+      casadi_error("Newton::init: Unknown jacobian_reuse \"" << jacobian_reuse << "\"");
+    }
+    contraction_max_ = getOption("contraction_max");
+    broyden_memory_ = getOption("broyden_memory");
+    casadi_assert_message(broyden_memory_>0, "Newton::init: broyden_memory must be positive");
+    warm_start_ = getOption("warm_start");
+
+    // No factorization or solution to reuse yet
+    has_fact_ = false;
+    u_prev_.clear();
+
+    // Work vectors
+    step_.resize(n_);
+    if (jacobian_reuse_==JAC_BROYDEN) {
+      broyden_s_.resize(broyden_memory_, std::vector<double>(n_));
+      broyden_nrm2_.resize(broyden_memory_);
+    } else {
+      broyden_s_.clear();
+      broyden_nrm2_.clear();
+    }
+
   }
 
   void Newton::printIteration(std::ostream &stream) {
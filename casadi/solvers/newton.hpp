@@ -97,6 +97,37 @@ namespace casadi {
     /// Print iteration
     void printIteration(std::ostream &stream, int iter, double abstol, double abstolStep);
 
+    /** \brief Broyden update of the step in step_, returns false on breakdown
+     * Applies the inverse update of the factorized Jacobian (Kelley, Algorithm brsol)
+     * using the first \a n_s steps in broyden_s_.
+     */
+    bool broydenStep(int n_s);
+
+    /// Jacobian reuse strategies
+    enum JacobianReuse {JAC_NEWTON, JAC_FROZEN, JAC_BROYDEN};
+    JacobianReuse jacobian_reuse_;
+
+    /// Refresh the Jacobian when the step sizes contract slower than this rate
+    double contraction_max_;
+
+    /// Maximum number of Broyden updates before refreshing the Jacobian
+    int broyden_memory_;
+
+    /// Start from the solution of the previous call
+    bool warm_start_;
+
+    /// Is there a factorization from a previous call?
+    bool has_fact_;
+
+    /// Solution of the previous call, empty if none
+    std::vector<double> u_prev_;
+
+    /// Newton step
+    std::vector<double> step_;
+
+    /// Steps since the last factorization and their squared norms, for Broyden updates
+    std::vector<std::vector<double> > broyden_s_;
+    std::vector<double> broyden_nrm2_;
   };
 
 } // namespace casadi
@@ -46,6 +46,40 @@
 "|                 |                 |                 | tolerance on    |\n"
 "|                 |                 |                 | step size       |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| broyden_memory  | OT_INTEGER      | 20              | Maximum number  |\n"
+"|                 |                 |                 | of Broyden      |\n"
+"|                 |                 |                 | updates before  |\n"
+"|                 |                 |                 | the Jacobian is |\n"
+"|                 |                 |                 | refreshed       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| contraction_max | OT_REAL         | 0.500           | Refresh a       |\n"
+"|                 |                 |                 | reused Jacobian |\n"
+"|                 |                 |                 | when the ratio  |\n"
+"|                 |                 |                 | between         |\n"
+"|                 |                 |                 | consecutive     |\n"
+"|                 |                 |                 | step sizes      |\n"
+"|                 |                 |                 | exceeds this    |\n"
+"|                 |                 |                 | value           |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| jacobian_reuse  | OT_STRING       | \"none\"          | Reuse the       |\n"
+"|                 |                 |                 | factorized      |\n"
+"|                 |                 |                 | Jacobian over   |\n"
+"|                 |                 |                 | iterations and  |\n"
+"|                 |                 |                 | calls: evaluate |\n"
+"|                 |                 |                 | it every        |\n"
+"|                 |                 |                 | iteration       |\n"
+"|                 |                 |                 | (none), keep it |\n"
+"|                 |                 |                 | until           |\n"
+"|                 |                 |                 | convergence     |\n"
+"|                 |                 |                 | slows down      |\n"
+"|                 |                 |                 | (frozen) or     |\n"
+"|                 |                 |                 | keep it and     |\n"
+"|                 |                 |                 | apply Broyden   |\n"
+"|                 |                 |                 | rank-1 updates  |\n"
+"|                 |                 |                 | (broyden) (none |\n"
+"|                 |                 |                 | |frozen|broyden |\n"
+"|                 |                 |                 | )               |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| max_iter        | OT_INTEGER      | 1000            | Maximum number  |\n"
 "|                 |                 |                 | of Newton       |\n"
 "|                 |                 |                 | iterations to   |\n"
@@ -57,6 +91,12 @@
 "|                 |                 |                 | about each      |\n"
 "|                 |                 |                 | iteration       |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| warm_start      | OT_BOOLEAN      | false           | Start from the  |\n"
+"|                 |                 |                 | solution of the |\n"
+"|                 |                 |                 | previous call   |\n"
+"|                 |                 |                 | instead of the  |\n"
+"|                 |                 |                 | initial guess   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "\n"
 "\n"
 ">List of available monitors\n"
@@ -83,6 +123,10 @@
 "+===============+\n"
 "| iter          |\n"
 "+---------------+\n"
+"| n_fact        |\n"
+"+---------------+\n"
+"| n_jac         |\n"
+"+---------------+\n"
 "| return_status |\n"
 "+---------------+\n"
 "\n"
@@ -39,11 +39,42 @@
 "+-----------------+-----------------+-----------------+-----------------+\n"
 "|       Id        |      Type       |     Default     |   Description   |\n"
 "+=================+=================+=================+=================+\n"
+"| checkpoints     | OT_INTEGER      | 0               | Number of       |\n"
+"|                 |                 |                 | forward         |\n"
+"|                 |                 |                 | solutions kept  |\n"
+"|                 |                 |                 | for the         |\n"
+"|                 |                 |                 | backward        |\n"
+"|                 |                 |                 | problem. With   |\n"
+"|                 |                 |                 | 0, the full     |\n"
+"|                 |                 |                 | forward         |\n"
+"|                 |                 |                 | trajectory is   |\n"
+"|                 |                 |                 | stored.         |\n"
+"|                 |                 |                 | Otherwise,      |\n"
+"|                 |                 |                 | forward steps   |\n"
+"|                 |                 |                 | are recomputed  |\n"
+"|                 |                 |                 | from            |\n"
+"|                 |                 |                 | checkpoints     |\n"
+"|                 |                 |                 | placed in a     |\n"
+"|                 |                 |                 | binomial        |\n"
+"|                 |                 |                 | (revolve)       |\n"
+"|                 |                 |                 | schedule        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| number_of_finit | OT_INTEGER      | 20              | Number of       |\n"
 "| e_elements      |                 |                 | finite elements |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
 "\n"
 "\n"
+">List of available stats\n"
+"\n"
+"+------------------+\n"
+"|        Id        |\n"
+"+==================+\n"
+"| n_recompute      |\n"
+"+------------------+\n"
+"| peak_tape_memory |\n"
+"+------------------+\n"
+"\n"
+"\n"
 "\n"
 "\n"
 ;
@@ -0,0 +1,416 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "supernodal_cholesky.hpp"
+#include "casadi/core/matrix/sparsity_internal.hpp"
+#include "casadi/core/std_vector_tools.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_LINEARSOLVER_SUPERNODAL_EXPORT
+  casadi_register_linearsolver_supernodal(LinearSolverInternal::Plugin* plugin) {
+    plugin->creator = SupernodalCholesky::creator;
+    plugin->name = "supernodal";
+    plugin->doc = SupernodalCholesky::meta_doc.c_str();
+    plugin->version = 23;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_LINEARSOLVER_SUPERNODAL_EXPORT casadi_load_linearsolver_supernodal() {
+    LinearSolverInternal::registerPlugin(casadi_register_linearsolver_supernodal);
+  }
+
+  SupernodalCholesky::SupernodalCholesky(const Sparsity& sparsity, int nrhs) :
+      LinearSolverInternal(sparsity, nrhs) {
+    casadi_assert_message(sparsity.isSymmetric(),
+                          "SupernodalCholesky: supplied sparsity must be symmetric, got "
+                          << sparsity.dimString() << ".");
+
+    addOption("factorization",     OT_STRING,   "cholesky",
+              "Factorization to be calculated: LL' for positive definite matrices or LDL' "
+              "(without pivoting) for quasi-definite matrices", "cholesky|ldl");
+    addOption("ordering",          OT_STRING,   "amd",
+              "Fill-reducing ordering", "natural|amd|nested_dissection");
+    addOption("nd_leaf_size",      OT_INTEGER,  64,
+              "Size of the subgraphs ordered by minimum degree in nested dissection");
+  }
+
+  SupernodalCholesky::~SupernodalCholesky() {
+  }
+
+  /// Upper triangular part of the symmetrically permuted sparsity pattern P*A*P'
+  static Sparsity upperPermuted(const Sparsity& sp, const vector<int>& perm) {
+    int n = sp.size2();
+    vector<int> pinv(n);
+    for (int k=0; k<n; ++k) pinv[perm[k]] = k;
+    const int* colind = sp.colind();
+    const int* row = sp.row();
+    vector<int> r, c;
+    for (int cc=0; cc<n; ++cc) {
+      for (int el=colind[cc]; el<colind[cc+1]; ++el) {
+        int i = pinv[row[el]], j = pinv[cc];
+        if (i<=j) {
+          r.push_back(i);
+          c.push_back(j);
+        }
+      }
+    }
+    return Sparsity::triplet(n, n, r, c);
+  }
+
+  void SupernodalCholesky::init() {
+    // Call the init method of the base class
+    LinearSolverInternal::init();
+
+    // Read options
+    ldl_ = getOption("factorization")=="ldl";
+
+    const Sparsity& sp = input(LINSOL_A).sparsity();
+    int n = sp.size2();
+
+    // Fill-reducing ordering
+    if (getOption("ordering")=="amd") {
+      perm_ = sp->approximateMinimumDegree(1);
+      perm_.resize(n);
+    } else if (getOption("ordering")=="nested_dissection") {
+      perm_ = sp.nestedDissection(getOption("nd_leaf_size"));
+    } else {
+      perm_ = range(n);
+    }
+
+    // Postorder the elimination tree, so that the subtrees, and hence the supernodes,
+    // are formed by consecutive columns. This does not change the fill-in.
+    Sparsity C = upperPermuted(sp, perm_);
+    vector<int> post = SparsityInternal::postorder(C.eliminationTree(), n);
+    vector<int> perm(n);
+    for (int k=0; k<n; ++k) perm[k] = perm_[post[k]];
+    perm_.swap(perm);
+    C = upperPermuted(sp, perm_);
+    vector<int> parent = C.eliminationTree();
+    post = SparsityInternal::postorder(parent, n);
+    vector<int> count = C->counts(getPtr(parent), getPtr(post), 0);
+
+    // Number of children in the elimination tree
+    vector<int> nchild(n, 0);
+    for (int j=0; j<n; ++j) if (parent[j]>=0) nchild[parent[j]]++;
+
+    // Fundamental supernodes: column j continues the supernode of column j-1 if j is the
+    // only child of j-1 and the sparsity pattern below the diagonal is the same
+    snode_col_.clear();
+    col_snode_.resize(n);
+    for (int j=0; j<n; ++j) {
+      if (j==0 || parent[j-1]!=j || nchild[j]!=1 || count[j-1]!=count[j]+1) {
+        snode_col_.push_back(j);
+      }
+      col_snode_[j] = snode_col_.size()-1;
+    }
+    int nsnode = snode_col_.size();
+    snode_col_.push_back(n);
+
+    // Children of each supernode in the supernodal elimination tree
+    vector<int> head(nsnode, -1), next(nsnode, -1);
+    for (int s=nsnode-1; s>=0; --s) {
+      int p = parent[snode_col_[s+1]-1];
+      if (p>=0) {
+        next[s] = head[col_snode_[p]];
+        head[col_snode_[p]] = s;
+      }
+    }
+
+    // Row indices of each supernode: its columns, the rows of the lower triangular part
+    // of the matrix and the row indices of the children, below the supernode
+    Sparsity CT = C.T();
+    const int* CT_colind = CT.colind();
+    const int* CT_row = CT.row();
+    snode_rowind_.resize(nsnode+1);
+    snode_rowind_[0] = 0;
+    snode_row_.clear();
+    snode_offset_.resize(nsnode+1);
+    snode_offset_[0] = 0;
+    vector<int> marker(n, -1);
+    size_t w_sz = 0;
+    double nnz_factor = 0, flops_factor = 0;
+    for (int s=0; s<nsnode; ++s) {
+      int f = snode_col_[s], l = snode_col_[s+1];
+      for (int j=f; j<l; ++j) {
+        snode_row_.push_back(j);
+        marker[j] = s;
+      }
+      int first_below = snode_row_.size();
+      for (int j=f; j<l; ++j) {
+        for (int el=CT_colind[j]; el<CT_colind[j+1]; ++el) {
+          int i = CT_row[el];
+          if (i>=l && marker[i]!=s) {
+            snode_row_.push_back(i);
+            marker[i] = s;
+          }
+        }
+      }
+      for (int c=head[s]; c>=0; c=next[c]) {
+        for (int k=snode_rowind_[c]; k<snode_rowind_[c+1]; ++k) {
+          int i = snode_row_[k];
+          if (i>=l && marker[i]!=s) {
+            snode_row_.push_back(i);
+            marker[i] = s;
+          }
+        }
+      }
+      sort(snode_row_.begin()+first_below, snode_row_.end());
+      snode_rowind_[s+1] = snode_row_.size();
+
+      // Dense block of the supernode
+      int ns = l-f, nr = snode_rowind_[s+1]-snode_rowind_[s];
+      casadi_assert_message(nr==count[f], "SupernodalCholesky::init: inconsistent column count");
+      snode_offset_[s+1] = snode_offset_[s] + nr*ns;
+      w_sz = max(w_sz, static_cast<size_t>(nr-ns)*(nr-ns));
+
+      // Statistics, cf. cs_schol
+      for (int j=0; j<ns; ++j) {
+        nnz_factor += nr-j;
+        flops_factor += static_cast<double>(nr-j)*(nr-j);
+      }
+    }
+
+    // Where the nonzeros of A end up in the factor
+    amap_.resize(sp.nnz());
+    relmap_.resize(n);
+    const int* colind = sp.colind();
+    const int* row = sp.row();
+    vector<int> pinv(n);
+    for (int k=0; k<n; ++k) pinv[perm_[k]] = k;
+    for (int s=0; s<nsnode; ++s) {
+      int f = snode_col_[s], nr = snode_rowind_[s+1]-snode_rowind_[s];
+      for (int k=snode_rowind_[s]; k<snode_rowind_[s+1]; ++k) {
+        relmap_[snode_row_[k]] = k-snode_rowind_[s];
+      }
+      for (int j=f; j<snode_col_[s+1]; ++j) {
+        int cc = perm_[j];
+        for (int el=colind[cc]; el<colind[cc+1]; ++el) {
+          int i = pinv[row[el]];
+          amap_[el] = i>=j ? snode_offset_[s] + (j-f)*nr + relmap_[i] : -1;
+        }
+      }
+    }
+
+    // Allocate memory
+    lx_.resize(snode_offset_.back());
+    d_.resize(ldl_ ? n : 0);
+    w_.resize(w_sz);
+    iw_.resize(3*nsnode);
+    y_.resize(n*rhs_block_);
+
+    stats_["n_supernodes"] = nsnode;
+    stats_["nnz_factor"] = nnz_factor;
+    stats_["flops_factor"] = flops_factor;
+  }
+
+  void SupernodalCholesky::prepare() {
+    prepared_ = false;
+
+    // Scatter the lower triangular part of the linear system to the supernode blocks
+    const vector<double>& A = input(LINSOL_A).data();
+    fill(lx_.begin(), lx_.end(), 0);
+    for (int k=0; k<amap_.size(); ++k) {
+      if (amap_[k]>=0) lx_[amap_[k]] = A[k];
+    }
+
+    // Left-looking factorization, one supernode at a time. Each factorized supernode s
+    // waits in the list of the next ancestor it updates, ptr[s] is the first row of s
+    // that has not been used in an update.
+    int nsnode = snode_col_.size()-1;
+    int* head = getPtr(iw_);
+    int* next = head + nsnode;
+    int* ptr = next + nsnode;
+    fill(head, head+nsnode, -1);
+    for (int t=0; t<nsnode; ++t) {
+      int tf = snode_col_[t], tns = snode_col_[t+1]-tf;
+      int tnr = snode_rowind_[t+1]-snode_rowind_[t];
+      const int* trow = getPtr(snode_row_) + snode_rowind_[t];
+      double* Lt = getPtr(lx_) + snode_offset_[t];
+
+      // Position of the rows of t in its block
+      for (int k=0; k<tnr; ++k) relmap_[trow[k]] = k;
+
+      // Updates from the descendants
+      for (int s=head[t], s_next; s>=0; s=s_next) {
+        s_next = next[s];
+        int f = snode_col_[s], ns = snode_col_[s+1]-f;
+        int nr = snode_rowind_[s+1]-snode_rowind_[s];
+        const int* srow = getPtr(snode_row_) + snode_rowind_[s];
+        const double* L = getPtr(lx_) + snode_offset_[s];
+
+        // Rows a to b-1 of s correspond to columns of t
+        int a = ptr[s], b;
+        for (b=a; b<nr && srow[b]<tf+tns; ++b) {}
+        int m = nr-a, q = b-a;
+
+        // Dense update W = L(a:nr, :) * D * L(a:b, :)', lower triangular part
+        double* W = getPtr(w_);
+        fill(W, W+m*q, 0);
+        for (int jj=0; jj<q; ++jj) {
+          double* Wj = W + jj*m;
+          for (int k=0; k<ns; ++k) {
+            const double* Lk = L + k*nr + a;
+            double c = ldl_ ? Lk[jj]*d_[f+k] : Lk[jj];
+            if (c==0) continue;
+            for (int i=jj; i<m; ++i) Wj[i] += Lk[i]*c;
+          }
+        }
+
+        // Subtract from t
+        for (int jj=0; jj<q; ++jj) {
+          double* Ltj = Lt + (srow[a+jj]-tf)*tnr;
+          const double* Wj = W + jj*m;
+          for (int i=jj; i<m; ++i) Ltj[relmap_[srow[a+i]]] -= Wj[i];
+        }
+
+        // Move s to the list of the next ancestor it updates
+        ptr[s] = b;
+        if (b<nr) {
+          int t2 = col_snode_[srow[b]];
+          next[s] = head[t2];
+          head[t2] = s;
+        }
+      }
+
+      // Factorize the dense panel, column by column
+      for (int j=0; j<tns; ++j) {
+        double* Lj = Lt + j*tnr;
+        for (int k=0; k<j; ++k) {
+          const double* Lk = Lt + k*tnr;
+          double ljk = ldl_ ? Lk[j]*d_[tf+k] : Lk[j];
+          if (ljk==0) continue;
+          for (int i=j; i<tnr; ++i) Lj[i] -= Lk[i]*ljk;
+        }
+        double piv = Lj[j];
+        if (ldl_) {
+          casadi_assert_message(piv!=0 && !isnan(piv),
+                                "SupernodalCholesky::prepare: zero pivot in column "
+                                << perm_[tf+j] << ", the matrix is not quasi-definite");
+          d_[tf+j] = piv;
+          Lj[j] = 1;
+        } else {
+          casadi_assert_message(piv>0,
+                                "SupernodalCholesky::prepare: non-positive pivot in column "
+                                << perm_[tf+j] << ", the matrix is not positive definite");
+          piv = Lj[j] = sqrt(piv);
+        }
+        for (int i=j+1; i<tnr; ++i) Lj[i] /= piv;
+      }
+
+      // Add t to the list of its parent
+      ptr[t] = tns;
+      if (tns<tnr) {
+        int t2 = col_snode_[trow[tns]];
+        next[t] = head[t2];
+        head[t2] = t;
+      }
+    }
+
+    prepared_ = true;
+  }
+
+  void SupernodalCholesky::solve(double* x, int nrhs, bool transpose) {
+    casadi_assert(prepared_);
+
+    // The matrix is symmetric, so transpose can be ignored
+    int n = ncol();
+    int nsnode = snode_col_.size()-1;
+
+    // Process blocks of right-hand-sides, interleaved so that each supernode column
+    // is applied to all right-hand-sides in the block at once
+    for (int r0=0; r0<nrhs; r0+=rhs_block_) {
+      int nb = min(rhs_block_, nrhs-r0);
+      double* xb = x + r0*n;
+      double* y = getPtr(y_);
+
+      // Permute
+      for (int k=0; k<n; ++k) {
+        for (int r=0; r<nb; ++r) y[k*nb+r] = xb[r*n+perm_[k]];
+      }
+
+      // Forward substitution, L*y = b
+      for (int s=0; s<nsnode; ++s) {
+        int f = snode_col_[s], ns = snode_col_[s+1]-f;
+        int nr = snode_rowind_[s+1]-snode_rowind_[s];
+        const int* srow = getPtr(snode_row_) + snode_rowind_[s];
+        const double* L = getPtr(lx_) + snode_offset_[s];
+        for (int j=0; j<ns; ++j) {
+          const double* Lj = L + j*nr;
+          double* yj = y + (f+j)*nb;
+          if (!ldl_) {
+            for (int r=0; r<nb; ++r) yj[r] /= Lj[j];
+          }
+          for (int i=j+1; i<nr; ++i) {
+            double l = Lj[i];
+            if (l==0) continue;
+            double* yi = y + srow[i]*nb;
+            for (int r=0; r<nb; ++r) yi[r] -= l*yj[r];
+          }
+        }
+      }
+
+      // Diagonal, D*y = y
+      if (ldl_) {
+        for (int k=0; k<n; ++k) {
+          for (int r=0; r<nb; ++r) y[k*nb+r] /= d_[k];
+        }
+      }
+
+      // Backward substitution, L'*y = y
+      for (int s=nsnode-1; s>=0; --s) {
+        int f = snode_col_[s], ns = snode_col_[s+1]-f;
+        int nr = snode_rowind_[s+1]-snode_rowind_[s];
+        const int* srow = getPtr(snode_row_) + snode_rowind_[s];
+        const double* L = getPtr(lx_) + snode_offset_[s];
+        for (int j=ns-1; j>=0; --j) {
+          const double* Lj = L + j*nr;
+          double* yj = y + (f+j)*nb;
+          for (int i=j+1; i<nr; ++i) {
+            double l = Lj[i];
+            if (l==0) continue;
+            const double* yi = y + srow[i]*nb;
+            for (int r=0; r<nb; ++r) yj[r] -= l*yi[r];
+          }
+          if (!ldl_) {
+            for (int r=0; r<nb; ++r) yj[r] /= Lj[j];
+          }
+        }
+      }
+
+      // Permute back
+      for (int k=0; k<n; ++k) {
+        for (int r=0; r<nb; ++r) xb[r*n+perm_[k]] = y[k*nb+r];
+      }
+    }
+  }
+
+} // namespace casadi
@@ -0,0 +1,115 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_SUPERNODAL_CHOLESKY_HPP
+#define CASADI_SUPERNODAL_CHOLESKY_HPP
+
+#include "casadi/core/function/linear_solver_internal.hpp"
+#include <casadi/solvers/casadi_linearsolver_supernodal_export.h>
+
+/** \defgroup plugin_LinearSolver_supernodal
+
+       LinearSolver for symmetric matrices based on a supernodal Cholesky (LL') or
+       LDL' factorization without pivoting. Columns with identical sparsity pattern
+       in the factor are grouped into supernodes, which are stored and updated as
+       dense blocks. The LDL' variant is suitable for quasi-definite matrices, such as
+       regularized KKT systems.
+*/
+
+/** \pluginsection{LinearSolver,supernodal} */
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief \pluginbrief{LinearSolver,supernodal}
+
+      @copydoc LinearSolver_doc
+      @copydoc plugin_LinearSolver_supernodal
+  */
+  class CASADI_LINEARSOLVER_SUPERNODAL_EXPORT SupernodalCholesky
+    : public LinearSolverInternal {
+  public:
+    // Constructor
+    SupernodalCholesky(const Sparsity& sparsity, int nrhs);
+
+    // Destructor
+    virtual ~SupernodalCholesky();
+
+    /** \brief  Clone */
+    virtual SupernodalCholesky* clone() const { return new SupernodalCholesky(*this);}
+
+    /** \brief  Create a new LinearSolver */
+    static LinearSolverInternal* creator(const Sparsity& sp, int nrhs)
+    { return new SupernodalCholesky(sp, nrhs);}
+
+    // Initialize, symbolic factorization
+    virtual void init();
+
+    // Numeric factorization
+    virtual void prepare();
+
+    // Solve the system of equations
+    virtual void solve(double* x, int nrhs, bool transpose);
+
+    // LDL' instead of LL'
+    bool ldl_;
+
+    // Fill-reducing, postordered permutation: pivot k is row/column perm_[k] of A
+    std::vector<int> perm_;
+
+    // Columns of the supernodes: supernode s is formed by columns snode_col_[s] to
+    // snode_col_[s+1]-1 of the permuted matrix
+    std::vector<int> snode_col_;
+
+    // Supernode of each column
+    std::vector<int> col_snode_;
+
+    // Row indices of the supernodes, sorted and starting with the columns of the supernode
+    std::vector<int> snode_rowind_, snode_row_;
+
+    // Offset of each supernode in lx_: a dense, column major block with as many rows as
+    // the supernode has row indices
+    std::vector<int> snode_offset_;
+
+    // Position of each nonzero of A in lx_, -1 for the strictly upper triangular part
+    std::vector<int> amap_;
+
+    // Numeric factorization: supernode blocks and, for LDL', the diagonal
+    std::vector<double> lx_, d_;
+
+    // Work vectors for the factorization and the solve
+    std::vector<double> w_, y_;
+    std::vector<int> relmap_, iw_;
+
+    /// A documentation string
+    static const std::string meta_doc;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_SUPERNODAL_CHOLESKY_HPP
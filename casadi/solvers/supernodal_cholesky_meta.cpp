@@ -0,0 +1,85 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "supernodal_cholesky.hpp"
+      #include <string>
+
+      const std::string casadi::SupernodalCholesky::meta_doc=
+      "\n"
+"LinearSolver for symmetric matrices based on a supernodal Cholesky (LL')\n"
+"or LDL' factorization without pivoting. Columns with identical sparsity\n"
+"pattern in the factor are grouped into supernodes, which are stored and\n"
+"updated as dense blocks. The LDL' variant is suitable for quasi-definite\n"
+"matrices, such as regularized KKT systems.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| factorization   | OT_STRING       | \"cholesky\"      | Factorization   |\n"
+"|                 |                 |                 | to be           |\n"
+"|                 |                 |                 | calculated: LL' |\n"
+"|                 |                 |                 | for positive    |\n"
+"|                 |                 |                 | definite        |\n"
+"|                 |                 |                 | matrices or     |\n"
+"|                 |                 |                 | LDL' (without   |\n"
+"|                 |                 |                 | pivoting) for   |\n"
+"|                 |                 |                 | quasi-definite  |\n"
+"|                 |                 |                 | matrices        |\n"
+"|                 |                 |                 | (cholesky|ldl)  |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| nd_leaf_size    | OT_INTEGER      | 64              | Size of the     |\n"
+"|                 |                 |                 | subgraphs       |\n"
+"|                 |                 |                 | ordered by      |\n"
+"|                 |                 |                 | minimum degree  |\n"
+"|                 |                 |                 | in nested       |\n"
+"|                 |                 |                 | dissection      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| ordering        | OT_STRING       | \"amd\"           | Fill-reducing   |\n"
+"|                 |                 |                 | ordering (natur |\n"
+"|                 |                 |                 | al|amd|nested_d |\n"
+"|                 |                 |                 | issection)      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+--------------+\n"
+"|      Id      |\n"
+"+==============+\n"
+"| flops_factor |\n"
+"+--------------+\n"
+"| n_supernodes |\n"
+"+--------------+\n"
+"| nnz_factor   |\n"
+"+--------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -54,6 +54,9 @@ namespace casadi {
     addOption("codegen",           OT_BOOLEAN,  false,               "C-code generation");
     addOption("compiler",          OT_STRING,    "gcc -fPIC -O2",
               "Compiler command to be used for compiling generated code");
+    addOption("codegen_split",     OT_INTEGER,   0,
+              "Split the generated code into functions of at most this many operations, "
+              "cf. SXFunction");
   }
 
   SymbolicQr::~SymbolicQr() {
@@ -73,6 +76,7 @@ namespace casadi {
 
     // Read options
     bool codegen = getOption("codegen");
+    int codegen_split = getOption("codegen_split");
     string compiler = getOption("compiler");
 
     // Make sure that command processor is available
@@ -105,6 +109,7 @@ namespace casadi {
     vector<SX> QR(2);
     qr(Aperm, QR[0], QR[1]);
     SXFunction fact_fcn(A, QR);
+    fact_fcn.setOption("codegen_split", codegen_split);
 
     // Optionally generate c code and load as DLL
     if (codegen) {
@@ -143,6 +148,7 @@ namespace casadi {
     solv_in[1] = R;
     solv_in[2] = b;
     SXFunction solv_fcn(solv_in, x);
+    solv_fcn.setOption("codegen_split", codegen_split);
 
     // Optionally generate c code and load as DLL
     if (codegen) {
@@ -173,6 +179,7 @@ namespace casadi {
 
     // Mofify the QR solve function
     solv_fcn = SXFunction(solv_in, x);
+    solv_fcn.setOption("codegen_split", codegen_split);
 
     // Optionally generate c code and load as DLL
     if (codegen) {
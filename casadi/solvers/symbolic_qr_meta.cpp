@@ -40,6 +40,14 @@
 "| codegen         | OT_BOOLEAN      | false           | C-code          |\n"
 "|                 |                 |                 | generation      |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| codegen_split   | OT_INTEGER      | 0               | Split the       |\n"
+"|                 |                 |                 | generated code  |\n"
+"|                 |                 |                 | into functions  |\n"
+"|                 |                 |                 | of at most this |\n"
+"|                 |                 |                 | many            |\n"
+"|                 |                 |                 | operations, cf. |\n"
+"|                 |                 |                 | SXFunction      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| compiler        | OT_STRING       | \"gcc -fPIC -O2\" | Compiler        |\n"
 "|                 |                 |                 | command to be   |\n"
 "|                 |                 |                 | used for        |\n"
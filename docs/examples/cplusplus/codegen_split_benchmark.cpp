@@ -0,0 +1,109 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark of split-unit code generation
+ * Generates a large SXFunction, compiles it to a shared library as a single function and
+ * split into parts in separate translation units, compiled serially and in parallel.
+ * Reports the number of operations, the compile time and the evaluation time.
+ *
+ * Usage: codegen_split_benchmark [number of steps] [operations per part]
+ */
+
+#include "casadi/casadi.hpp"
+#include "casadi/core/function/function_internal.hpp"
+#include <cstdlib>
+#include <iomanip>
+#include <sys/time.h>
+
+using namespace casadi;
+using namespace std;
+
+// Wall clock time in seconds, including the time spent in the compiler processes
+double wallTime() {
+  timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + 1e-6*t.tv_usec;
+}
+
+int main(int argc, char* argv[]) {
+  int nsteps = argc>1 ? atoi(argv[1]) : 500;
+  int split = argc>2 ? atoi(argv[2]) : 5000;
+
+  // A chain of coupled nonlinear maps
+  int n = 20;
+  SX x = SX::sym("x", n);
+  SX y = x;
+  for (int k=0; k<nsteps; ++k) {
+    SX y_next = SX::zeros(n);
+    for (int i=0; i<n; ++i) {
+      y_next[i] = sin(y[i])*y[(i+1)%n] + 0.5*cos(y[(i+n-1)%n]) + 0.01*k;
+    }
+    y = y_next;
+  }
+
+  cout << setw(12) << "split" << setw(10) << "threads" << setw(12) << "operations"
+       << setw(14) << "compile [s]" << setw(14) << "eval [us]" << setw(14) << "error" << endl;
+
+  vector<double> ref;
+  for (int variant=0; variant<3; ++variant) {
+    SXFunction f(x, y);
+    f.setOption("codegen_split", variant==0 ? 0 : split);
+    f.init();
+
+    // Single thread for the serial variant, all cores otherwise
+    CasadiOptions::compile_num_threads = variant==1 ? 1 : 0;
+
+    // Compile and load
+    stringstream fname;
+    fname << "split_benchmark_" << variant;
+    double t0 = wallTime();
+    Function fcn = f;
+    Function g = fcn->dynamicCompilation(f, fname.str(), "benchmark function",
+                                         "gcc -fPIC -O2");
+    double t_compile = wallTime() - t0;
+
+    // Evaluate
+    for (int i=0; i<n; ++i) g.input().at(i) = 0.1*i;
+    int nrep = 100;
+    t0 = wallTime();
+    for (int r=0; r<nrep; ++r) g.evaluate();
+    double t_eval = (wallTime() - t0)/nrep;
+
+    // Compare with the monolithic function
+    vector<double> res = g.output().data();
+    if (ref.empty()) ref = res;
+    double err = 0;
+    for (int i=0; i<n; ++i) err = max(err, fabs(res[i]-ref[i]));
+
+    cout << setw(12) << (variant==0 ? 0 : split)
+         << setw(10) << (variant==1 ? "1" : "all")
+         << setw(12) << f.getAlgorithmSize()
+         << setw(14) << t_compile
+         << setw(14) << 1e6*t_eval
+         << setw(14) << err << endl;
+  }
+
+  return 0;
+}
@@ -30,15 +30,18 @@
  *  Note that other usage, e.g. accessing the internal data structures in the 
  *  generated files is not recommended and subject to change.
  *
- *  We show three ways of calling generated code. First from C with the signature
- *  of the generated file known, secondly from C with the signature unknown
- *  and thirdly from C++ using the CasADi function ExternalFunction.
+ *  We show four ways of calling generated code. First from C with the signature
+ *  of the generated file known, secondly from C with the signature unknown,
+ *  thirdly with caller-provided work memory, which is re-entrant and
+ *  allows evaluating a batch of inputs in one call, and fourthly from C++ using
+ *  the CasADi function ExternalFunction.
  *
  *  Joel Andersson, K.U. Leuven 2013
  */
 
 #include <stdio.h>
 #include <dlfcn.h>
+#include <vector>
 
 
 /* Usage from C with known signature of the generated function */
@@ -186,6 +189,69 @@ int usage_c_unknown_signature(){
   return 0;
 }
 
+/* Re-entrant usage, the caller provides the work vectors */
+int usage_c_reentrant(){
+  printf("---\n");
+  printf("Re-entrant and batched usage.\n");
+  printf("\n");
+
+  /* Signature of the entry points */
+  typedef int (*nworkPtr)(int *ni, int *nr);
+  typedef int (*evalBatchPtr)(int n, const double* const* arg, double* const* res,
+                              int* iw, double* w);
+
+  /* Load the dll */
+  void* handle = dlopen("./f.so", RTLD_LAZY);
+  if(handle==0){
+    printf("Cannot open f.so, error %s\n", dlerror());
+    return 1;
+  }
+
+  /* Reset error */
+  dlerror();
+
+  /* Function for getting the length of the work vectors */
+  nworkPtr nwork = (nworkPtr)dlsym(handle, "nwork");
+  if(dlerror()){
+    printf("Failed to retrieve \"nwork\" function.\n");
+    return 1;
+  }
+
+  /* Function for evaluating several sets of inputs, one after the other (not vectorized) */
+  evalBatchPtr evalBatch = (evalBatchPtr)dlsym(handle, "evalBatch");
+  if(dlerror()){
+    printf("Failed to retrieve \"evalBatch\" function.\n");
+    return 1;
+  }
+
+  /* Allocate work vectors, one pair per thread if called concurrently */
+  int ni, nr;
+  nwork(&ni, &nr);
+  printf("ni = %d, nr = %d\n", ni, nr);
+  std::vector<int> iw(ni+1);
+  std::vector<double> w(nr+1);
+
+  /* Evaluate for two sets of inputs, stored one after the other */
+  const double x_val[] = {1,2,3,4, 5,6,7,8};
+  const double y_val[] = {5, 6};
+  double res0[2];
+  double res1[8];
+  const double *all_inputs[] = {x_val,y_val};
+  double *all_outputs[] = {res0,res1};
+  evalBatch(2, all_inputs, all_outputs, &iw[0], &w[0]);
+
+  int k;
+  for(k=0; k<2; ++k){
+    printf("set %d, result (0): %g\n",k,res0[k]);
+    printf("set %d, result (1): [%g,%g;%g,%g]\n",k,res1[4*k],res1[4*k+1],res1[4*k+2],res1[4*k+3]);
+  }
+
+  /* Free the handle */
+  dlclose(handle);
+
+  return 0;
+}
+
 
 // C++ (and CasADi) from here on
 #include <casadi/casadi.hpp>
@@ -245,7 +311,11 @@ int main(){
   flag = usage_c_unknown_signature();
   casadi_assert_message(flag==0, "Example 2 failed");
 
-  // Example 3, usage from C++
+  // Example 3, re-entrant and batched usage from C
+  flag = usage_c_reentrant();
+  casadi_assert_message(flag==0, "Example 3 failed");
+
+  // Example 4, usage from C++
   usage_cplusplus();
 
   return 0;
@@ -0,0 +1,106 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/** \brief Benchmark of the structured Newton method of the collocation integrator
+ * Integrates the Brusselator reaction-diffusion equations, discretized on a grid of N points,
+ * with the collocation integrator. The collocation equations are solved once with the generic
+ * Newton implicit function solver and once with the structured Newton method, which factorizes
+ * one block per (pair of) eigenvalue(s) of the collocation scheme and keeps factorizations
+ * between finite elements. Reports the time per integration.
+ */
+
+#include "casadi/casadi.hpp"
+#include <ctime>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+// Brusselator with diffusion, N grid points
+SXFunction brusselator(int N) {
+  SX u = SX::sym("u", N), v = SX::sym("v", N);
+  double alpha = 0.02*(N+1)*(N+1);
+  SX du = SX::zeros(N), dv = SX::zeros(N);
+  for (int i=0; i<N; ++i) {
+    SX u_l = i>0 ? u(i-1) : SX(1), u_r = i<N-1 ? u(i+1) : SX(1);
+    SX v_l = i>0 ? v(i-1) : SX(3), v_r = i<N-1 ? v(i+1) : SX(3);
+    du(i) = 1 + u(i)*u(i)*v(i) - 4*u(i) + alpha*(u_l - 2*u(i) + u_r);
+    dv(i) = 3*u(i) - u(i)*u(i)*v(i) + alpha*(v_l - 2*v(i) + v_r);
+  }
+  SXFunction f(daeIn("x", vertcat(u, v)), daeOut("ode", vertcat(du, dv)));
+  f.init();
+  return f;
+}
+
+// Time per integration in milliseconds
+double timeIntegrator(Integrator& I, const DMatrix& x0, int nrep) {
+  I.setInput(x0, "x0");
+  clock_t t0 = clock();
+  for (int rep=0; rep<nrep; ++rep) I.evaluate();
+  return (clock()-t0)*1e3/CLOCKS_PER_SEC/nrep;
+}
+
+int main() {
+  cout << setw(6) << "N" << setw(6) << "deg" << setw(16) << "generic [ms]"
+       << setw(16) << "structured [ms]" << setw(10) << "speedup" << setw(8) << "n_jac"
+       << setw(14) << "difference" << endl;
+  for (int N=10; N<=80; N*=2) {
+    SXFunction f = brusselator(N);
+    DMatrix x0 = DMatrix::zeros(2*N, 1);
+    for (int i=0; i<N; ++i) {
+      x0(i) = 1 + sin(2*M_PI*(i+1)/(N+1));
+      x0(N+i) = 3;
+    }
+    for (int deg=3; deg<=5; deg+=2) {
+      Dictionary opts;
+      opts["tf"] = 10.0;
+      opts["number_of_finite_elements"] = 50;
+      opts["interpolation_order"] = deg;
+
+      // Generic Newton method on the stacked collocation equations
+      Integrator generic("collocation", f);
+      generic.setOption(opts);
+      generic.setOption("implicit_solver", "newton");
+      Dictionary newton_opts;
+      newton_opts["linear_solver"] = "csparse";
+      generic.setOption("implicit_solver_options", newton_opts);
+      generic.init();
+
+      // Structured Newton method
+      Integrator structured("collocation", f);
+      structured.setOption(opts);
+      structured.setOption("structured_newton", true);
+      structured.setOption("gather_stats", true);
+      structured.init();
+
+      int nrep = max(1, 200/N);
+      double t_generic = timeIntegrator(generic, x0, nrep);
+      double t_structured = timeIntegrator(structured, x0, nrep);
+      int n_jac = structured.getStats().at("n_jac");
+      cout << setw(6) << N << setw(6) << deg << setw(16) << t_generic << setw(16) << t_structured
+           << setw(10) << t_generic/t_structured << setw(8) << n_jac << setw(14)
+           << norm_inf(generic.output("xf")-structured.output("xf")).at(0) << endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark of the graph coloring algorithms
+ * Colors representative Jacobian and Hessian sparsity patterns with the available column
+ * orderings, with and without iterated greedy recoloring, and with star and acyclic
+ * colorings for the symmetric patterns. Reports the number of colors, i.e. the number of
+ * directional derivatives per Jacobian evaluation, and the coloring time.
+ */
+
+#include "casadi/casadi.hpp"
+#include <ctime>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+const char* ordering_name[] = {"none", "largest_first", "smallest_last", "incidence_degree"};
+
+// Unidirectional (forward mode) coloring of an unsymmetric pattern
+void benchmark(const string& descr, const Sparsity& sp) {
+  cout << descr << ": " << sp.dimString() << endl;
+  cout << setw(18) << "ordering" << setw(10) << "recolor" << setw(10) << "colors"
+       << setw(14) << "time [ms]" << endl;
+  Sparsity spT = sp.T();
+  for (int ordering=0; ordering<4; ++ordering) {
+    for (int recolor=0; recolor<=20; recolor+=20) {
+      clock_t t0 = clock();
+      Sparsity D = sp.unidirectionalColoring(spT, numeric_limits<int>::max(), ordering, recolor);
+      double t = (clock()-t0)/static_cast<double>(CLOCKS_PER_SEC);
+      cout << setw(18) << ordering_name[ordering] << setw(10) << recolor << setw(10)
+           << D.size2() << setw(14) << t*1e3 << endl;
+    }
+  }
+}
+
+// Star and acyclic coloring of a symmetric pattern
+void benchmarkSymmetric(const string& descr, const Sparsity& sp) {
+  cout << descr << ": " << sp.dimString() << endl;
+  cout << setw(18) << "ordering" << setw(10) << "coloring" << setw(10) << "colors"
+       << setw(14) << "time [ms]" << endl;
+  for (int ordering=0; ordering<4; ++ordering) {
+    for (int acyclic=0; acyclic<2; ++acyclic) {
+      clock_t t0 = clock();
+      Sparsity D = acyclic ? sp.acyclicColoring(ordering) : sp.starColoring(ordering);
+      double t = (clock()-t0)/static_cast<double>(CLOCKS_PER_SEC);
+      cout << setw(18) << ordering_name[ordering] << setw(10) << (acyclic ? "acyclic" : "star")
+           << setw(10) << D.size2() << setw(14) << t*1e3 << endl;
+    }
+  }
+}
+
+int main() {
+  vector<int> row, col;
+
+  // Banded Jacobian (bandwidth 2) plus scattered coupling terms
+  int n = 50000;
+  for (int i=0; i<n; ++i) {
+    for (int j=max(0, i-2); j<=min(n-1, i+2); ++j) {
+      row.push_back(i);
+      col.push_back(j);
+    }
+    row.push_back(i);
+    col.push_back((7*i+3)%n);
+    row.push_back(i);
+    col.push_back((13*i+5)%n);
+  }
+  benchmark("Banded plus coupling", Sparsity::triplet(n, n, row, col));
+
+  // Multiple shooting: block bidiagonal with dense 10-by-10 blocks and a dense parameter column
+  row.clear();
+  col.clear();
+  int nx = 10, nk = 2000;
+  for (int k=0; k<nk; ++k) {
+    for (int i=0; i<nx; ++i) {
+      for (int j=0; j<nx; ++j) {
+        row.push_back(k*nx+i);
+        col.push_back(k*nx+j);
+        if (k+1<nk) {
+          row.push_back(k*nx+i);
+          col.push_back((k+1)*nx+j);
+        }
+      }
+      row.push_back(k*nx+i);
+      col.push_back(nx*nk);
+    }
+  }
+  benchmark("Multiple shooting", Sparsity::triplet(nx*nk, nx*nk+1, row, col));
+
+  // Random sparse pattern, five nonzeros per row
+  row.clear();
+  col.clear();
+  n = 20000;
+  unsigned int seed = 12345;
+  for (int i=0; i<n; ++i) {
+    for (int k=0; k<5; ++k) {
+      seed = 1103515245*seed + 12345;
+      row.push_back(i);
+      col.push_back((seed/65536)%n);
+    }
+  }
+  benchmark("Random", Sparsity::triplet(n, n, row, col));
+
+  // 2D Laplacian (five-point stencil) on a 200-by-200 grid
+  row.clear();
+  col.clear();
+  int m = 200;
+  for (int i=0; i<m; ++i) {
+    for (int j=0; j<m; ++j) {
+      int k = i*m+j;
+      row.push_back(k);
+      col.push_back(k);
+      if (i>0) { row.push_back(k); col.push_back(k-m); }
+      if (i<m-1) { row.push_back(k); col.push_back(k+m); }
+      if (j>0) { row.push_back(k); col.push_back(k-1); }
+      if (j<m-1) { row.push_back(k); col.push_back(k+1); }
+    }
+  }
+  benchmarkSymmetric("2D Laplacian", Sparsity::triplet(m*m, m*m, row, col));
+
+  // Arrowhead: tridiagonal with a dense last row and column
+  row.clear();
+  col.clear();
+  n = 20000;
+  for (int i=0; i<n; ++i) {
+    for (int j=max(0, i-1); j<=min(n-1, i+1); ++j) {
+      row.push_back(i);
+      col.push_back(j);
+    }
+    if (i<n-2) {
+      row.push_back(i);
+      col.push_back(n-1);
+      row.push_back(n-1);
+      col.push_back(i);
+    }
+  }
+  benchmarkSymmetric("Arrowhead", Sparsity::triplet(n, n, row, col));
+
+  return 0;
+}
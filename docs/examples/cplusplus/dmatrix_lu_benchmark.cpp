@@ -0,0 +1,96 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Scaling of the numeric determinant and inverse of a DMatrix
+ * For a dense and a sparse (tridiagonal plus random entries) matrix of
+ * dimension n, the LU-based det() and inv() are timed and the residual of
+ * A*inv(A) - I is reported. For the smallest sizes, the cofactor expansion
+ * which is still used for SX is timed for comparison.
+ */
+
+#include "casadi/casadi.hpp"
+#include <ctime>
+#include <cstdlib>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+// Time per call of det or inv in ms
+double timeit(const DMatrix& A, bool inverse, DMatrix& res) {
+  int n_rep = 0;
+  clock_t t0 = clock();
+  do {
+    res = inverse ? inv(A) : det(A);
+    n_rep++;
+  } while (clock()-t0 < CLOCKS_PER_SEC/20);
+  return 1e3*(clock()-t0)/static_cast<double>(CLOCKS_PER_SEC)/n_rep;
+}
+
+int main() {
+  srand(0);
+  cout << setw(6) << "n" << setw(8) << "type" << setw(8) << "nnz" << setw(14) << "det [ms]"
+       << setw(14) << "inv [ms]" << setw(12) << "nnz(inv)" << setw(14) << "residual"
+       << setw(18) << "cofactor [ms]" << endl;
+  int sizes[] = {4, 8, 16, 32, 64, 100, 200};
+  for (int s=0; s<sizeof(sizes)/sizeof(int); ++s) {
+    int n = sizes[s];
+    for (int sparse=0; sparse<2; ++sparse) {
+      DMatrix A = sparse ? DMatrix(n, n) : DMatrix::zeros(n, n);
+      for (int i=0; i<n; ++i) {
+        A(i, i) = 4;
+        if (sparse) {
+          if (i>0) A(i, i-1) = -1;
+          if (i+1<n) A(i, i+1) = -1;
+          A(rand() % n, i) = rand()/static_cast<double>(RAND_MAX);
+        } else {
+          for (int j=0; j<n; ++j) A(i, j) = A(i, j).toScalar() + rand()/static_cast<double>(RAND_MAX);
+        }
+      }
+
+      DMatrix d, Ainv;
+      double t_det = timeit(A, false, d);
+      double t_inv = timeit(A, true, Ainv);
+      double residual = norm_inf(mul(A, Ainv) - DMatrix::eye(n)).toScalar();
+
+      cout << setw(6) << n << setw(8) << (sparse ? "sparse" : "dense") << setw(8) << A.nnz()
+           << setw(14) << t_det << setw(14) << t_inv << setw(12) << Ainv.nnz()
+           << setw(14) << residual;
+
+      // Cofactor expansion, as for symbolic matrices
+      if (n<=8) {
+        SX As = A;
+        clock_t t0 = clock();
+        SX ds = det(As);
+        double t_cof = 1e3*(clock()-t0)/static_cast<double>(CLOCKS_PER_SEC);
+        cout << setw(18) << t_cof;
+        casadi_assert(std::abs(ds.getValue()-d.toScalar()) <= 1e-8*std::abs(d.toScalar()));
+      }
+      cout << endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark of linear solves with multiple right-hand-sides
+ * Solves with 1 to 256 right-hand-sides using the sparse (CSparse, supernodal) and dense
+ * (LAPACK) linear solver plugins, once one right-hand-side at a time (rhs_block=1) and
+ * once with panels of right-hand-sides processed together (default rhs_block). Reports
+ * the solution time per right-hand-side.
+ */
+
+#include "casadi/casadi.hpp"
+#include <ctime>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+// Time per right-hand-side in microseconds
+double timeSolve(const string& solver, const DMatrix& A, int nrhs, int rhs_block) {
+  LinearSolver linsol(solver, A.sparsity(), nrhs);
+  if (rhs_block>0) linsol.setOption("rhs_block", rhs_block);
+  linsol.init();
+  linsol.setInput(A, LINSOL_A);
+  DMatrix B = DMatrix::zeros(A.size1(), nrhs);
+  for (int k=0; k<B.nnz(); ++k) B.at(k) = sin(0.1*k);
+  linsol.setInput(B, LINSOL_B);
+  linsol.prepare();
+  int nrep = max(1, 1024/nrhs);
+  clock_t t0 = clock();
+  for (int rep=0; rep<nrep; ++rep) linsol.solve();
+  return (clock()-t0)*1e6/CLOCKS_PER_SEC/nrep/nrhs;
+}
+
+void benchmark(const string& descr, const DMatrix& A, const vector<string>& solvers) {
+  cout << descr << ": " << A.dimString() << endl;
+  cout << setw(20) << "solver" << setw(8) << "nrhs" << setw(16) << "single [us]"
+       << setw(16) << "panel [us]" << setw(10) << "speedup" << endl;
+  for (int k=0; k<solvers.size(); ++k) {
+    for (int nrhs=1; nrhs<=256; nrhs*=2) {
+      double t_single = timeSolve(solvers[k], A, nrhs, 1);
+      double t_panel = timeSolve(solvers[k], A, nrhs, 0);
+      cout << setw(20) << solvers[k] << setw(8) << nrhs << setw(16) << t_single
+           << setw(16) << t_panel << setw(10) << t_single/t_panel << endl;
+    }
+  }
+}
+
+int main() {
+  // 2D Laplacian (five-point stencil) on a 60-by-60 grid
+  vector<int> row, col;
+  vector<double> val;
+  int m = 60;
+  for (int i=0; i<m; ++i) {
+    for (int j=0; j<m; ++j) {
+      int k = i*m+j;
+      row.push_back(k);
+      col.push_back(k);
+      val.push_back(4.1);
+      if (i>0) { row.push_back(k); col.push_back(k-m); val.push_back(-1); }
+      if (i<m-1) { row.push_back(k); col.push_back(k+m); val.push_back(-1); }
+      if (j>0) { row.push_back(k); col.push_back(k-1); val.push_back(-1); }
+      if (j<m-1) { row.push_back(k); col.push_back(k+1); val.push_back(-1); }
+    }
+  }
+  vector<string> sparse_solvers;
+  sparse_solvers.push_back("csparse");
+  sparse_solvers.push_back("csparsecholesky");
+  sparse_solvers.push_back("supernodal");
+  benchmark("2D Laplacian", DMatrix::triplet(row, col, val, m*m, m*m), sparse_solvers);
+
+  // Dense, diagonally dominant matrix
+  int n = 200;
+  DMatrix A = DMatrix::zeros(n, n);
+  for (int i=0; i<n; ++i) {
+    for (int j=0; j<n; ++j) {
+      A(i, j) = i==j ? n : cos(0.7*i+1.3*j);
+    }
+  }
+  vector<string> dense_solvers;
+  dense_solvers.push_back("lapacklu");
+  dense_solvers.push_back("lapackqr");
+  benchmark("Dense", A, dense_solvers);
+
+  return 0;
+}
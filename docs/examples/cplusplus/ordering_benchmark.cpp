@@ -0,0 +1,139 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark of the fill-reducing orderings
+ * Factorizes representative symmetric positive definite matrices with the supernodal
+ * Cholesky solver using the natural, approximate minimum degree and nested dissection
+ * orderings. Reports the nonzeros in the factor, the floating point operations of the
+ * factorization, the number of supernodes and the ordering/analysis and factorization times.
+ */
+
+#include "casadi/casadi.hpp"
+#include <ctime>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+// Add a symmetric pair of entries
+void addEntry(vector<int>& row, vector<int>& col, int i, int j) {
+  row.push_back(i);
+  col.push_back(j);
+  if (i!=j) {
+    row.push_back(j);
+    col.push_back(i);
+  }
+}
+
+// Diagonally dominant matrix with a given pattern
+DMatrix spdMatrix(const vector<int>& row, const vector<int>& col, int n) {
+  vector<double> val(row.size(), -1.), degree(n, 1.);
+  for (int k=0; k<row.size(); ++k) {
+    if (row[k]!=col[k]) degree[row[k]] += 1;
+  }
+  for (int k=0; k<row.size(); ++k) {
+    if (row[k]==col[k]) val[k] = degree[row[k]];
+  }
+  return DMatrix::triplet(row, col, val, n, n);
+}
+
+void benchmark(const string& descr, const DMatrix& A) {
+  cout << descr << ": " << A.dimString() << endl;
+  cout << setw(20) << "ordering" << setw(14) << "nnz(L)" << setw(14) << "flops"
+       << setw(12) << "supernodes" << setw(14) << "init [ms]" << setw(14) << "factor [ms]"
+       << endl;
+  const char* orderings[] = {"natural", "amd", "nested_dissection"};
+  for (int k=0; k<3; ++k) {
+    LinearSolver linsol("supernodal", A.sparsity(), 1);
+    linsol.setOption("ordering", orderings[k]);
+    clock_t t0 = clock();
+    linsol.init();
+    clock_t t1 = clock();
+    linsol.setInput(A, LINSOL_A);
+    linsol.prepare();
+    clock_t t2 = clock();
+    cout << setw(20) << orderings[k]
+         << setw(14) << static_cast<double>(linsol.getStat("nnz_factor"))
+         << setw(14) << static_cast<double>(linsol.getStat("flops_factor"))
+         << setw(12) << static_cast<int>(linsol.getStat("n_supernodes"))
+         << setw(14) << (t1-t0)*1e3/CLOCKS_PER_SEC
+         << setw(14) << (t2-t1)*1e3/CLOCKS_PER_SEC << endl;
+  }
+}
+
+int main() {
+  vector<int> row, col;
+
+  // 2D Laplacian (five-point stencil) on a 150-by-150 grid
+  int m = 150;
+  for (int i=0; i<m; ++i) {
+    for (int j=0; j<m; ++j) {
+      int k = i*m+j;
+      addEntry(row, col, k, k);
+      if (i>0) addEntry(row, col, k, k-m);
+      if (j>0) addEntry(row, col, k, k-1);
+    }
+  }
+  benchmark("2D Laplacian", spdMatrix(row, col, m*m));
+
+  // 3D Laplacian (seven-point stencil) on a 25-by-25-by-25 grid
+  row.clear();
+  col.clear();
+  m = 25;
+  for (int i=0; i<m; ++i) {
+    for (int j=0; j<m; ++j) {
+      for (int l=0; l<m; ++l) {
+        int k = (i*m+j)*m+l;
+        addEntry(row, col, k, k);
+        if (i>0) addEntry(row, col, k, k-m*m);
+        if (j>0) addEntry(row, col, k, k-m);
+        if (l>0) addEntry(row, col, k, k-1);
+      }
+    }
+  }
+  benchmark("3D Laplacian", spdMatrix(row, col, m*m*m));
+
+  // Optimal control, long horizon: block tridiagonal with dense 8-by-8 blocks, coupled
+  // to a few parameters shared by all stages
+  row.clear();
+  col.clear();
+  int nx = 8, nk = 2000, np = 4;
+  int n = nx*nk+np;
+  for (int k=0; k<nk; ++k) {
+    for (int i=0; i<nx; ++i) {
+      for (int j=0; j<=i; ++j) addEntry(row, col, k*nx+i, k*nx+j);
+      if (k+1<nk) {
+        for (int j=0; j<nx; ++j) addEntry(row, col, (k+1)*nx+j, k*nx+i);
+      }
+      for (int j=0; j<np; ++j) addEntry(row, col, nx*nk+j, k*nx+i);
+    }
+  }
+  for (int i=0; i<np; ++i) {
+    for (int j=0; j<=i; ++j) addEntry(row, col, nx*nk+i, nx*nk+j);
+  }
+  benchmark("Optimal control", spdMatrix(row, col, n));
+
+  return 0;
+}
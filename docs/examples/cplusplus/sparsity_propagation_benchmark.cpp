@@ -0,0 +1,94 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark of Jacobian sparsity detection with wide bit vectors
+ * The Jacobian sparsity pattern of a large, sparse SXFunction is calculated with
+ * 1, 2, 4 and 8 64-bit words propagated per nonzero (option "sp_words"), reporting
+ * the number of sweeps through the algorithm and the wall time.
+ */
+
+#include "casadi/casadi.hpp"
+#include <ctime>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+void benchmark(const string& descr, const SX& x, const SX& f) {
+  cout << descr << endl;
+  cout << setw(10) << "sp_words" << setw(10) << "sweeps" << setw(14) << "time [ms]"
+       << setw(12) << "nnz" << endl;
+  Sparsity ref;
+  for (int nw=1; nw<=8; nw*=2) {
+    SXFunction fcn(x, f);
+    fcn.setOption("sp_words", nw);
+    fcn.init();
+    clock_t t0 = clock();
+    Sparsity sp = fcn.jacSparsity();
+    double t = (clock()-t0)/static_cast<double>(CLOCKS_PER_SEC);
+    if (nw==1) ref = sp;
+    casadi_assert_message(sp==ref, "Sparsity pattern mismatch");
+    cout << setw(10) << nw << setw(10) << static_cast<int>(fcn.getStats().at("n_sp_sweeps"))
+         << setw(14) << t*1e3 << setw(12) << sp.nnz() << endl;
+  }
+}
+
+int main() {
+  // Large sparse function: banded coupling plus a scattered term (hierarchical algorithm)
+  int n = 100000;
+  SX x = SX::sym("x", n);
+  vector<SX> f(n);
+  for (int i=0; i<n; ++i) {
+    f[i] = x[i]*x[(i+1)%n] + sin(x[(i+n-1)%n]) + x[(7*i+3)%n];
+  }
+  benchmark("Banded plus scattered, n = 100000", x, vertcat(f));
+
+  // Explicit Euler steps of a discretized reaction-diffusion equation, long algorithm
+  n = 20000;
+  x = SX::sym("x", n);
+  SX u = x;
+  for (int k=0; k<10; ++k) {
+    vector<SX> u_next(n);
+    for (int i=0; i<n; ++i) {
+      SX lap = u[(i+n-1)%n] - 2*u[i] + u[(i+1)%n];
+      u_next[i] = u[i] + 0.1*(lap + u[i]*(1-u[i]*u[i]));
+    }
+    u = vertcat(u_next);
+  }
+  benchmark("10 explicit Euler steps of a reaction-diffusion equation, n = 20000", x, u);
+
+  // Few outputs depending on many inputs (single level algorithm, adjoint mode)
+  int m = 200;
+  n = 20000;
+  x = SX::sym("x", n);
+  f.resize(m);
+  for (int i=0; i<m; ++i) {
+    f[i] = 0;
+    for (int j=0; j<50; ++j) f[i] += x[(i*997 + j*389)%n];
+  }
+  benchmark("Sums of 50 out of 20000 variables, 200 outputs", x, vertcat(f));
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark of multithreaded Jacobian sparsity detection
+ * The Jacobian sparsity pattern of a large, sparse SXFunction is calculated with the
+ * sweeps of the hierarchical algorithm distributed over 1, 2, 4 and 8 threads
+ * (option "sp_threads"), reporting the wall time. The pattern must not depend on the
+ * number of threads.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+int main() {
+  // Large sparse function: banded coupling plus two scattered terms
+  int n = 200000;
+  SX x = SX::sym("x", n);
+  vector<SX> f(n);
+  for (int i=0; i<n; ++i) {
+    f[i] = x[i]*x[(i+1)%n] + sin(x[(i+n-1)%n]) + x[(7*i+3)%n]*x[(13*i+5)%n];
+  }
+
+  cout << setw(12) << "sp_threads" << setw(10) << "sweeps" << setw(14) << "time [ms]"
+       << setw(12) << "nnz" << endl;
+  Sparsity ref;
+  for (int nt=1; nt<=8; nt*=2) {
+    SXFunction fcn(x, vertcat(f));
+    fcn.setOption("sp_threads", nt);
+    fcn.init();
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    Sparsity sp = fcn.jacSparsity();
+    double t = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+    if (nt==1) ref = sp;
+    casadi_assert_message(sp==ref, "Sparsity pattern depends on the number of threads");
+    cout << setw(12) << nt << setw(10) << static_cast<int>(fcn.getStats().at("n_sp_sweeps"))
+         << setw(14) << t*1e3 << setw(12) << sp.nnz() << endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark of batched evaluation of an SXFunction
+ * The same function (20 RK4 steps of a damped pendulum) is evaluated for N parameter
+ * sets, first with N calls to evaluate() and then with a single call to evaluateBatch()
+ * using a structure-of-arrays layout.
+ */
+
+#include "casadi/casadi.hpp"
+#include <ctime>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+int main() {
+  // Damped pendulum, parameters: initial state and damping
+  SX x0 = SX::sym("x0", 2);
+  SX p = SX::sym("p");
+  SX x = x0;
+  double h = 0.05;
+  for (int k=0; k<20; ++k) {
+    SX k1 = vertcat(x[1], -sin(x[0]) - p*x[1]);
+    SX x2 = x + h/2*k1;
+    SX k2 = vertcat(x2[1], -sin(x2[0]) - p*x2[1]);
+    SX x3 = x + h/2*k2;
+    SX k3 = vertcat(x3[1], -sin(x3[0]) - p*x3[1]);
+    SX x4 = x + h*k3;
+    SX k4 = vertcat(x4[1], -sin(x4[0]) - p*x4[1]);
+    x = x + h/6*(k1 + 2*k2 + 2*k3 + k4);
+  }
+  vector<SX> f_in(2);
+  f_in[0] = x0;
+  f_in[1] = p;
+  SXFunction f(f_in, x);
+  f.init();
+  cout << "Algorithm size: " << f.getAlgorithmSize() << endl;
+
+  cout << setw(8) << "N" << setw(16) << "scalar [ms]" << setw(16) << "batch [ms]"
+       << setw(12) << "speedup" << setw(14) << "max diff" << endl;
+  for (int n=8; n<=8192; n*=4) {
+    // Input sets, structure of arrays
+    vector<double> x0_batch(2*n), p_batch(n), xf_batch(2*n), xf_ref(2*n);
+    for (int j=0; j<n; ++j) {
+      x0_batch[j] = 0.1 + j/static_cast<double>(n);
+      x0_batch[n + j] = 0;
+      p_batch[j] = 0.5*j/n;
+    }
+
+    // Reference: one call per input set
+    clock_t t0 = clock();
+    for (int j=0; j<n; ++j) {
+      f.input(0).at(0) = x0_batch[j];
+      f.input(0).at(1) = x0_batch[n + j];
+      f.input(1).at(0) = p_batch[j];
+      f.evaluate();
+      xf_ref[j] = f.output().at(0);
+      xf_ref[n + j] = f.output().at(1);
+    }
+    double t_scalar = (clock()-t0)/static_cast<double>(CLOCKS_PER_SEC);
+
+    // Batched: one pass over the algorithm
+    vector<const double*> arg(2);
+    arg[0] = getPtr(x0_batch);
+    arg[1] = getPtr(p_batch);
+    vector<double*> res(1, getPtr(xf_batch));
+    vector<double> w(f.getWorkSize()*n);
+    t0 = clock();
+    f.evaluateBatch(arg, res, n, getPtr(w));
+    double t_batch = (clock()-t0)/static_cast<double>(CLOCKS_PER_SEC);
+
+    double max_diff = 0;
+    for (int j=0; j<2*n; ++j) max_diff = std::max(max_diff, std::abs(xf_batch[j]-xf_ref[j]));
+
+    cout << setw(8) << n << setw(16) << t_scalar*1e3 << setw(16) << t_batch*1e3
+         << setw(12) << t_scalar/t_batch << setw(14) << max_diff << endl;
+  }
+
+  return 0;
+}
@@ -1204,6 +1204,8 @@ def PyFunction(obj,inputs,outputs):
 %include <casadi/core/function/sdqp_solver.hpp>
 %include <casadi/core/function/external_function.hpp>
 %include <casadi/core/function/parallelizer.hpp>
+%include <casadi/core/function/map.hpp>
+%include <casadi/core/function/colored_jacobian.hpp>
 %include <casadi/core/function/custom_function.hpp>
 %include <casadi/core/functor.hpp>
 %include <casadi/core/function/nullspace.hpp>
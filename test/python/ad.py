@@ -406,8 +406,43 @@ class ADtests(casadiTestCase):
               J = self.jacobians[inputtype][outputtype](*n)
               self.checkarray(array(Jf.getOutput()),J,"jacobian")
               self.checkarray(array(DMatrix.ones(f.jacSparsity())),array(J!=0,int),"jacsparsity")
-              
-     
+
+  def test_jacsparsity_words(self):
+    self.message("jacsparsity with several words per nonzero")
+    n = 1000
+    x = SX.sym("x",n)
+    e = vertcat([x[i]*x[(i*13+5)%n]+sin(x[(i+n-1)%n]) for i in range(n)])
+    fs = SXFunction([x],[e])
+    fs.init()
+    xm = MX.sym("x",n)
+    ref = fs.jacSparsity()
+    self.assertEqual(ref.nnz(),3*n)
+    for sp_words in [1,3,4,8]:
+      for mode in ["forward","reverse"]:
+        for f in [SXFunction([x],[e]), MXFunction([xm],fs.call([xm]))]:
+          f.setOption("sp_words", sp_words)
+          f.setOption("ad_weight_sp", 0 if mode=='forward' else 1)
+          f.init()
+          self.assertTrue(f.jacSparsity()==ref)
+          self.assertTrue(f.getStats()["n_sp_sweeps"]>0)
+
+  def test_jacsparsity_threads(self):
+    self.message("jacsparsity on several threads")
+    n = 3000
+    x = SX.sym("x",n)
+    e = vertcat([x[i]*x[(i*13+5)%n]+sin(x[(i+n-1)%n])+x[(7*i+3)%n] for i in range(n)])
+    fs = SXFunction([x],[e])
+    fs.init()
+    ref = fs.jacSparsity()
+    for sp_threads in [1,2,3,0]:
+      for mode in ["forward","reverse"]:
+        f = SXFunction([x],[e])
+        f.setOption("sp_threads", sp_threads)
+        f.setOption("ad_weight_sp", 0 if mode=='forward' else 1)
+        f.init()
+        self.assertTrue(f.jacSparsity()==ref)
+
+
               
   def test_hessian(self):
     self.message("Jacobian chaining")
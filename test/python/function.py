@@ -76,7 +76,7 @@ class Functiontests(casadiTestCase):
     #! Evaluate this function ten times in parallel
     p = Parallelizer([f]*2)
     
-    for mode in ["openmp","serial"]:
+    for mode in ["openmp","serial","threads","processes"]:
       p.setOption("parallelization",mode)
       p.init()
       
@@ -94,7 +94,46 @@ class Functiontests(casadiTestCase):
 
       self.checkarray(sin(n1)+N1,p.getOutput(0),"output")
       self.checkarray(sin(n2)+N2,p.getOutput(1),"output")
-      
+
+  def test_threadpool_deepcopy(self):
+    self.message("deep copy of initialized functions with their own thread pool")
+    import copy
+    x = MX.sym("x",2)
+    y = MX.sym("y")
+    f = MXFunction([x,y],[sin(x) + y])
+    f.init()
+    xs = SX.sym("x",2)
+    g = SXFunction([xs],[vertcat([xs[0]*xs[1],sin(xs[1])])])
+    g.init()
+    X = DMatrix([[0.3*i,1.1-i] for i in range(4)]).T
+
+    for mode in ["serial","threads"]:
+      p = Parallelizer([f]*2)
+      J = ColoredJacobian(g)
+      m = g.map(4)
+      for fcn in [p,J,m]:
+        fcn.setOption("parallelization",mode)
+        fcn.setOption("num_threads",2)
+        fcn.init()
+      # The copies must start their own workers, the originals are destroyed
+      p,J,m = [copy.deepcopy(fcn) for fcn in [p,J,m]]
+
+      p.setInput([4,5],0)
+      p.setInput(3,1)
+      p.setInput([5,7],2)
+      p.setInput(8,3)
+      p.evaluate()
+      self.checkarray(sin(DMatrix([4,5]))+3,p.getOutput(0),"Parallelizer")
+      self.checkarray(sin(DMatrix([5,7]))+8,p.getOutput(1),"Parallelizer")
+
+      J.setInput([2,3])
+      J.evaluate()
+      self.checkarray(J.getOutput(),DMatrix([[3,2],[0,cos(3)]]),"ColoredJacobian")
+
+      m.setInput(X)
+      m.evaluate()
+      self.checkarray(m.getOutput(),vertcat([X[0,:]*X[1,:],sin(X[1,:])]),"Map")
+
   def test_MXFunctionSeed(self):
     self.message("MXFunctionSeed")
     x1 = MX.sym("x",2)
@@ -129,7 +168,7 @@ class Functiontests(casadiTestCase):
     
     #! Evaluate this function ten times in parallel
     pp = Parallelizer([f]*2)
-    for mode in ["serial","openmp"]:
+    for mode in ["serial","openmp","threads","processes"]:
       pp.setOption("parallelization",mode)
       pp.init()
       
@@ -187,6 +226,220 @@ class Functiontests(casadiTestCase):
     self.checkarray(sin(n1)+N1,p.getOutput(0),"output")
     self.checkarray(sin(n2)+N2,p.getOutput(1),"output")
 
+  def test_map(self):
+    self.message("Map")
+    x = SX.sym("x",2)
+    y = SX.sym("y")
+
+    f = SXFunction([x,y],[sin(x)*y, x[0]*x[1]+y**2])
+    f.init()
+
+    n = 5
+    X = [MX.sym("x",2) for i in range(n)]
+    Y = [MX.sym("y") for i in range(n)]
+    R = [f.call([X[i],Y[i]]) for i in range(n)]
+    solution = MXFunction(X+Y,[horzcat([r[0] for r in R]),horzcat([r[1] for r in R])])
+    solution.init()
+
+    for mode in ["serial","threads","batch"]:
+      m = f.map(n,{"parallelization": mode})
+      self.assertEqual(m.input(0).shape,(2,n))
+      self.assertEqual(m.output(1).shape,(1,n))
+
+      F = m.call([horzcat(X),horzcat(Y)])
+      trial = MXFunction(X+Y,F)
+      trial.init()
+
+      for i in range(n):
+        trial.setInput([0.3*i,1.1-i],i)
+        solution.setInput([0.3*i,1.1-i],i)
+        trial.setInput(0.7+i,n+i)
+        solution.setInput(0.7+i,n+i)
+
+      self.checkfunction(trial,solution,sparsity_mod=False)
+
+  def test_coloredjacobian(self):
+    self.message("ColoredJacobian")
+    n = 30
+    x = SX.sym("x",n)
+    p = SX.sym("p")
+    e = vertcat([x[i]*x[(i*13+5)%n]+sin(x[(i+n-1)%n])*p for i in range(n)])
+    f = SXFunction([x,p],[e,sumAll(e**2)])
+    f.init()
+    g = f.gradient(0,1)
+    g.init()
+
+    for F,oind,symmetric in [(f,0,False),(g,0,True)]:
+      for ad_weight in [0,1]:
+        F.setOption("ad_weight",ad_weight)
+        solution = F.jacobian(0,oind,False,symmetric)
+        solution.init()
+        for mode in ["serial","threads"]:
+          trial = ColoredJacobian(F,0,oind,False,symmetric)
+          trial.setOption("parallelization",mode)
+          trial.setOption("num_threads",3)
+          trial.setOption("chunk_size",2)
+          trial.init()
+          for fcn in [trial,solution]:
+            fcn.setInput(range(n),0)
+            fcn.setInput(1.3,1)
+            fcn.evaluate()
+          for i in range(trial.getNumOutputs()):
+            self.assertTrue(trial.output(i).sparsity()==solution.output(i).sparsity())
+            self.checkarray(trial.output(i),solution.output(i),digits=10)
+
+  def test_coloredjacobian_acyclic(self):
+    self.message("ColoredJacobian with acyclic coloring")
+    n = 30
+    x = SX.sym("x",n)
+    e = sumAll(vertcat([x[i]*x[(i*13+5)%n]+sin(x[(i+n-1)%n])*x[i] for i in range(n)])**2)
+    f = SXFunction([x],[e])
+    f.init()
+    g = f.gradient()
+    g.init()
+    solution = g.jacobian(0,0,False,True)
+    solution.init()
+    for ordering in ["none","largest_first","smallest_last","incidence_degree"]:
+      G = f.gradient()
+      G.setOption("symmetric_coloring","acyclic")
+      G.setOption("coloring_ordering",ordering)
+      G.init()
+      trial = G.jacobian(0,0,False,True)
+      trial.init()
+      for fcn in [trial,solution]:
+        fcn.setInput([cos(i) for i in range(n)],0)
+        fcn.evaluate()
+      self.assertTrue(trial.output(0).sparsity()==solution.output(0).sparsity())
+      self.checkarray(trial.output(0),solution.output(0),digits=10)
+
+  def test_coloredjacobian_triangular(self):
+    self.message("ColoredJacobian, upper triangular part only")
+    n = 30
+    x = SX.sym("x",n)
+    e = sumAll(vertcat([x[i]*x[(i*13+5)%n]+sin(x[(i+n-1)%n])*x[i] for i in range(n)])**2)
+    for coloring in ["star","acyclic"]:
+      f = SXFunction([x],[e])
+      f.init()
+      g = f.gradient()
+      g.setOption("symmetric_coloring",coloring)
+      g.init()
+      solution = g.jacobian(0,0,False,True)
+      solution.init()
+      for mode in ["serial","threads"]:
+        trial = ColoredJacobian(g,0,0,False,True)
+        trial.setOption("triangular",True)
+        trial.setOption("parallelization",mode)
+        trial.init()
+        for fcn in [trial,solution]:
+          fcn.setInput([cos(i) for i in range(n)],0)
+          fcn.evaluate()
+        self.assertTrue(trial.output(0).sparsity()==triu(solution.output(0).sparsity()))
+        self.checkarray(trial.output(0),triu(solution.output(0)),digits=10)
+
+  def test_coloredjacobian_symbolic(self):
+    self.message("ColoredJacobian: symbolic evaluation, derivatives and sparsity")
+    n = 12
+    x = SX.sym("x",n)
+    e = vertcat([x[i]*x[(i*5+3)%n]+sin(x[(i+n-1)%n]) for i in range(n)])
+    f = SXFunction([x],[e])
+    f.init()
+    solution = f.jacobian()
+    solution.init()
+    f = SXFunction([x],[e])
+    f.setOption("jac_num_threads",2)
+    f.init()
+    trial = f.jacobian()
+    trial.init()
+
+    # SX evaluation
+    [J] = trial.call([x])[:1]
+    Js = SXFunction([x],[J])
+    Js.init()
+    for fcn in [Js,solution]:
+      fcn.setInput([cos(i) for i in range(n)])
+      fcn.evaluate()
+    self.checkarray(Js.getOutput(),solution.getOutput(),digits=10)
+
+    # Second derivatives and sparsity propagation through an MX graph
+    xm = MX.sym("x",n)
+    v = MX.sym("v",n)
+    H = []
+    for fcn in [trial,solution]:
+      h = MXFunction([xm,v],[mul(fcn.call([xm])[0],v)])
+      h.init()
+      H.append(h.jacobian(0,0))
+      H[-1].init()
+      H[-1].setInput([cos(i) for i in range(n)],0)
+      H[-1].setInput([sin(i) for i in range(n)],1)
+      H[-1].evaluate()
+    self.assertTrue(H[0].output(0).sparsity()==H[1].output(0).sparsity())
+    self.checkarray(H[0].getOutput(0),H[1].getOutput(0),digits=10)
+
+  def test_codegen_batch(self):
+    self.message("Generated code: batched and re-entrant entry points")
+    import tempfile, shutil, os, subprocess, ctypes
+    x = SX.sym("x",2,2)
+    y = SX.sym("y")
+    n = 3
+    X = [DMatrix([[k+1,0.5*k+0.3],[2,k+0.7]]) for k in range(n)]
+    Y = [k+1.5 for k in range(n)]
+    dp = ctypes.POINTER(ctypes.c_double)
+    def buf(v):
+      return (ctypes.c_double*max(len(v),1))(*v)
+    root = tempfile.mkdtemp()
+    try:
+      for reentrant in [False,True]:
+        f = SXFunction([x,y],[sqrt(y)-1,sin(x)-y,mul(x,x)*y])
+        f.setOption("codegen_reentrant",reentrant)
+        f.init()
+        name = os.path.join(root,"f%d" % reentrant)
+        f.generateCode(name+".c")
+        subprocess.check_call(["gcc","-fPIC","-shared","-O2",name+".c","-o",name+".so","-lm"])
+        lib = ctypes.CDLL(name+".so")
+
+        # Wrappers with static work vectors unless re-entrant
+        code = open(name+".c").read()
+        self.assertEqual("static int iw[" in code,not reentrant)
+
+        # Work vectors from the caller
+        ni = ctypes.c_int()
+        nr = ctypes.c_int()
+        self.assertEqual(lib.nwork(ctypes.byref(ni),ctypes.byref(nr)),0)
+        iw = (ctypes.c_int*(ni.value+1))()
+        w = (ctypes.c_double*(nr.value+1))()
+
+        # Reference values
+        ref = []
+        for k in range(n):
+          f.setInput(X[k],0)
+          f.setInput(Y[k],1)
+          f.evaluate()
+          ref.append([DMatrix(f.getOutput(i)) for i in range(f.getNumOutputs())])
+
+        # All sets at once, the second output not requested
+        xb = buf(sum([list(X[k].data()) for k in range(n)],[]))
+        yb = buf(Y)
+        res = [buf([0]*(n*f.output(i).nnz())) for i in range(f.getNumOutputs())]
+        arg_ptr = (dp*2)(ctypes.cast(xb,dp),ctypes.cast(yb,dp))
+        res_ptr = (dp*3)(ctypes.cast(res[0],dp),None,ctypes.cast(res[2],dp))
+        self.assertEqual(lib.evalBatch(n,arg_ptr,res_ptr,iw,w),0)
+        for k in range(n):
+          for i in [0,2]:
+            nz = f.output(i).nnz()
+            self.checkarray(DMatrix(list(res[i][k*nz:(k+1)*nz])),DMatrix(list(ref[k][i].data())),
+                            digits=12)
+        self.assertTrue(all(v==0 for v in res[1]))
+
+        # One set through the wrapper
+        res = [buf([0]*f.output(i).nnz()) for i in range(f.getNumOutputs())]
+        arg_ptr = (dp*2)(ctypes.cast(xb,dp),ctypes.cast(yb,dp))
+        res_ptr = (dp*3)(*[ctypes.cast(r,dp) for r in res])
+        self.assertEqual(lib.evaluateWrap(arg_ptr,res_ptr),0)
+        for i in range(f.getNumOutputs()):
+          self.checkarray(DMatrix(list(res[i])),DMatrix(list(ref[0][i].data())),digits=12)
+    finally:
+      shutil.rmtree(root)
+
   def test_set_wrong(self):
     self.message("setter, wrong sparsity")
     x = SX.sym("x")
@@ -357,6 +357,34 @@ class NLPtests(casadiTestCase):
     a = SX.sym("a",2)
     f = SXFunction([x,a],[tan(x)-a,sqrt(a)*x**2 ])
 
+  def test_jacobian_reuse(self):
+    self.message("Newton with Jacobian reuse")
+    x = SX.sym("x",3)
+    a = SX.sym("a")
+    f = SXFunction([x,a],[vertcat([3*x[0]+sin(x[1])-a, 2*x[1]+x[2]**2-1, 4*x[2]+x[0]*x[1]]),sqrt(a)*x[0]])
+    f.init()
+    for reuse in ["frozen","broyden"]:
+      for warm_start in [False, True]:
+        ref=ImplicitFunction("newton",f)
+        ref.setOption("linear_solver","csparse")
+        ref.init()
+        solver=ImplicitFunction("newton",f)
+        solver.setOption("linear_solver","csparse")
+        solver.setOption("jacobian_reuse",reuse)
+        solver.setOption("warm_start",warm_start)
+        solver.setOption("gather_stats",True)
+        solver.init()
+        n_jac = 0
+        for k in range(5):
+          for fcn in [ref, solver]:
+            fcn.setInput(0,0)
+            fcn.setInput(1+0.1*k,1)
+            fcn.evaluate()
+          self.checkarray(solver.getOutput(0),ref.getOutput(0),digits=10)
+          self.checkarray(solver.getOutput(1),ref.getOutput(1),digits=10)
+          n_jac += solver.getStat("n_jac")
+        self.assertTrue(n_jac<5)
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -53,6 +53,7 @@ except:
   pass
 
 integrators.append(("collocation",["dae","ode"],{"implicit_solver":"kinsol","number_of_finite_elements": 18}))
+integrators.append(("collocation",["dae","ode"],{"structured_newton":True,"implicit_solver":"kinsol","number_of_finite_elements": 18}))
 
 try:
   Integrator.loadPlugin("oldcollocation")
@@ -1269,6 +1270,75 @@ class Integrationtests(casadiTestCase):
 
     integrator.evaluate()
     
+  def test_collocation_structured_newton(self):
+    self.message("collocation with structured Newton method")
+    x=SX.sym("x",2)
+    z=SX.sym("z")
+    p=SX.sym("p")
+    f=SXFunction(daeIn(x=x,z=z,p=p),daeOut(ode=vertcat([x[1],p*(1-z)*x[1]-x[0]]),alg=z-x[0]**2,quad=z))
+    f.init()
+    for scheme in ["radau","legendre"]:
+      for deg in range(1,6):
+        opts = {"tf":4.0,"number_of_finite_elements":40,"interpolation_order":deg,"collocation_scheme":scheme}
+        ref = Integrator("collocation",f)
+        ref.setOption(opts)
+        ref.setOption("implicit_solver","kinsol")
+        ref.setOption("implicit_solver_options",{"abstol":1e-14})
+        ref.init()
+        integrator = Integrator("collocation",f)
+        integrator.setOption(opts)
+        integrator.setOption("structured_newton",True)
+        integrator.setOption("gather_stats",True)
+        integrator.init()
+        for I in [ref,integrator]:
+          I.setInput([1,0],"x0")
+          I.setInput(1,"z0")
+          I.setInput(1.5,"p")
+          I.evaluate()
+        self.checkarray(integrator.getOutput("xf"),ref.getOutput("xf"),digits=9)
+        self.checkarray(integrator.getOutput("qf"),ref.getOutput("qf"),digits=9)
+        self.assertTrue(integrator.getStats()["n_jac"]<40)
+
+    # The generic implicit function solver is required unless the structured Newton method is used
+    integrator = Integrator("collocation",f)
+    with self.assertRaises(Exception):
+      integrator.init()
+
+  def test_checkpoints(self):
+    self.message("fixed step integrators with checkpointing for the backward problem")
+    x=SX.sym("x",2)
+    rx=SX.sym("rx",2)
+    p=SX.sym("p")
+    ode=vertcat([x[1],p*(1-x[0]**2)*x[1]-x[0]])
+    f=SXFunction(daeIn(x=x,p=p),daeOut(ode=ode,quad=x[0]**2))
+    f.init()
+    g=SXFunction(rdaeIn(rx=rx,x=x,p=p),rdaeOut(ode=mul(jacobian(ode,x).T,rx)+vertcat([2*x[0],0]),quad=mul(jacobian(ode,p).T,rx)))
+    g.init()
+    for plugin, opts in [("rk",{}),("collocation",{"implicit_solver":"kinsol","implicit_solver_options":{"abstol":1e-14}})]:
+      results = []
+      for checkpoints in [0,1,3,10,30]:
+        integrator = Integrator(plugin,f,g)
+        integrator.setOption(opts)
+        integrator.setOption("tf",4.0)
+        integrator.setOption("number_of_finite_elements",100)
+        integrator.setOption("checkpoints",checkpoints)
+        integrator.setOption("gather_stats",True)
+        integrator.init()
+        integrator.setInput([1,0],"x0")
+        integrator.setInput(1.5,"p")
+        integrator.evaluate()
+        stats = integrator.getStats()
+        results.append((checkpoints,integrator.getOutput("rxf"),integrator.getOutput("rqf"),stats["n_recompute"],stats["peak_tape_memory"]))
+      ref = results[0]
+      self.assertEqual(ref[3],0)
+      for checkpoints, rxf, rqf, n_recompute, peak_tape_memory in results[1:]:
+        self.checkarray(rxf,ref[1],digits=10)
+        self.checkarray(rqf,ref[2],digits=10)
+        self.assertTrue(peak_tape_memory<ref[4])
+        self.assertTrue(n_recompute>=100)
+      # Fewer checkpoints, more recomputation
+      self.assertTrue(results[1][3]>results[2][3]>results[3][3]>results[4][3])
+
   def test_collocationPoints(self):
     self.message("collocation points")
     with self.assertRaises(Exception):
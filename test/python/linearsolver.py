@@ -183,6 +183,25 @@ class LinearSolverTests(casadiTestCase):
       self.checkarray(f.getOutput(),DMatrix([1.5,-0.5]))
       self.checkarray(mul(A_,f.getOutput()),b_)
 
+  def test_multiple_rhs(self):
+    numpy.random.seed(0)
+    n = 10
+    A_ = self.randDMatrix(n,n,sparsity=0.4) + 5*DMatrix.eye(n)
+    B_ = self.randDMatrix(n,37)
+    for Solver, options in lsolvers:
+      for rhs_block in [1,4,16,64]:
+        S = LinearSolver(Solver,A_.sparsity(),B_.size2())
+        S.setOption(options)
+        S.setOption("rhs_block",rhs_block)
+        S.init()
+        S.setInput(A_,0)
+        S.setInput(B_,1)
+        S.prepare()
+        S.solve(False)
+        self.checkarray(mul(A_,S.getOutput()),B_)
+        S.solve(True)
+        self.checkarray(mul(A_.T,S.getOutput()),B_)
+
   def test_pseudo_inverse(self):
     numpy.random.seed(0)
     A_ = DMatrix(numpy.random.rand(4,6))
@@ -459,7 +478,62 @@ class LinearSolverTests(casadiTestCase):
 
     C = S.getFactorization()
     self.checkarray(mul(C,C.T),M)
-    
+
+  @requiresPlugin(LinearSolver,"supernodal")
+  def test_supernodal(self):
+    numpy.random.seed(0)
+    n = 20
+    L = self.randDMatrix(n,n,sparsity=0.2) +  1.5*c.diag(range(1,n+1))
+    L = L[Sparsity.lower(n)]
+    M = mul(L,L.T)
+    A = self.randDMatrix(5,n,sparsity=0.3)
+    K = blockcat(M,A.T,A,-0.1*DMatrix.eye(5))
+    for X, fact in [(M,"cholesky"),(K,"ldl")]:
+      for ordering in ["amd","natural","nested_dissection"]:
+        b = self.randDMatrix(X.size1(),21)
+        S = LinearSolver("supernodal",X.sparsity(),b.size2())
+        S.setOption("factorization",fact)
+        S.setOption("ordering",ordering)
+        S.setOption("rhs_block",4)
+        S.init()
+        S.setInput(X,0)
+        S.setInput(b,1)
+        S.evaluate()
+        self.checkarray(mul(X,S.getOutput()),b,digits=8)
+
+  @requiresPlugin(LinearSolver,"supernodal")
+  def test_supernodal_nested_dissection(self):
+    # Grid larger than the default leaf size, so that bisection takes place
+    numpy.random.seed(0)
+    m = 12
+    n = m*m
+    rows = []
+    cols = []
+    for i in range(m):
+      for j in range(m):
+        k = i*m+j
+        if i>0:
+          rows+= [k,k-m]
+          cols+= [k-m,k]
+        if j>0:
+          rows+= [k,k-1]
+          cols+= [k-1,k]
+    M = DMatrix(Sparsity.triplet(n,n,rows,cols),-1) + c.diag([4.5+0.01*i for i in range(n)])
+    A = self.randDMatrix(5,n,sparsity=0.05)
+    K = blockcat(M,A.T,A,-0.1*DMatrix.eye(5))
+    for X, fact in [(M,"cholesky"),(K,"ldl")]:
+      for nd_leaf_size in [8,64]:
+        b = self.randDMatrix(X.size1(),3)
+        S = LinearSolver("supernodal",X.sparsity(),b.size2())
+        S.setOption("factorization",fact)
+        S.setOption("ordering","nested_dissection")
+        S.setOption("nd_leaf_size",nd_leaf_size)
+        S.init()
+        S.setInput(X,0)
+        S.setInput(b,1)
+        S.evaluate()
+        self.checkarray(mul(X,S.getOutput()),b,digits=8)
+
   def test_large_sparse(self):
     numpy.random.seed(1)
     n = 10
@@ -504,6 +578,87 @@ class LinearSolverTests(casadiTestCase):
         f.evaluate()
 
         self.checkarray(mul(A_,f.getOutput()),b)
+
+  @requiresPlugin(LinearSolver,"symbolicqr")
+  def test_compile_cache(self):
+    import tempfile, shutil, os
+    A = DMatrix([[3,1,0],[1,4,2],[0,2,5]])
+    b = DMatrix([1,2,3])
+    root = tempfile.mkdtemp()
+    # Not existing yet, nested, with a space and a quote in the name
+    cache_dir = os.path.join(root,"compile cache","it's")
+    old_cache_dir = CasadiOptions.getCompileCacheDir()
+    CasadiOptions.setCompileCacheDir(cache_dir)
+    try:
+      for k in range(2):
+        S = LinearSolver("symbolicqr",A.sparsity())
+        S.setOption("codegen",True)
+        S.init()
+        S.setInput(A,"A")
+        S.setInput(b,"B")
+        S.evaluate()
+        self.checkarray(mul(A,S.getOutput()),b)
+        stats = S.getStats()
+        if k==0:
+          # Factorization and the two solve functions are compiled
+          self.assertEqual(stats["n_compile_cache_miss"],3)
+          self.assertFalse("n_compile_cache_hit" in stats)
+        else:
+          self.assertEqual(stats["n_compile_cache_hit"],3)
+          self.assertFalse("n_compile_cache_miss" in stats)
+
+      # A failed compilation leaves no temporary files in the cache
+      S = LinearSolver("symbolicqr",Sparsity.dense(2,2))
+      S.setOption("codegen",True)
+      S.setOption("compiler","false")
+      self.assertRaises(Exception,S.init)
+      self.assertEqual([f for f in os.listdir(cache_dir) if ".tmp" in f],[])
+    finally:
+      CasadiOptions.setCompileCacheDir(old_cache_dir)
+      shutil.rmtree(root)
+
+  @requiresPlugin(LinearSolver,"symbolicqr")
+  def test_codegen_split(self):
+    numpy.random.seed(0)
+    n = 8
+    A = self.randDMatrix(n,n,sparsity=0.5) + 4*c.diag(DMatrix.ones(n))
+    b = self.randDMatrix(n,2)
+    old_num_threads = CasadiOptions.getCompileNumThreads()
+    try:
+      # Parts compiled as separate translation units, in parallel
+      for num_threads in [1,2]:
+        CasadiOptions.setCompileNumThreads(num_threads)
+        S = LinearSolver("symbolicqr",A.sparsity(),b.size2())
+        S.setOption("codegen",True)
+        S.setOption("codegen_split",20)
+        S.init()
+        S.setInput(A,"A")
+        S.setInput(b,"B")
+        S.prepare()
+        S.solve(False)
+        self.checkarray(mul(A,S.getOutput()),b,digits=10)
+        S.solve(True)
+        self.checkarray(mul(A.T,S.getOutput()),b,digits=10)
+    finally:
+      CasadiOptions.setCompileNumThreads(old_num_threads)
+
+  @requiresPlugin(LinearSolver,"csparse")
+  def test_csparse_refactorize(self):
+    numpy.random.seed(0)
+    n = 10
+    A = self.randDMatrix(n,n,sparsity=0.3) + 4*c.diag(DMatrix.ones(n))
+    b = self.randDMatrix(n,1)
+    S = LinearSolver("csparse",A.sparsity())
+    S.init()
+    for k in range(4):
+      # Same pattern, new values: only the first call needs a full factorization
+      A_k = A*(1+0.1*k)
+      S.setInput(A_k,"A")
+      S.setInput(b,"B")
+      S.evaluate()
+      self.checkarray(mul(A_k,S.getOutput()),b)
+    self.assertEqual(S.getStats()["n_factorize"],1)
+    self.assertEqual(S.getStats()["n_refactorize"],3)
       
 if __name__ == '__main__':
     unittest.main()
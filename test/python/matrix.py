@@ -48,6 +48,32 @@ class Matrixtests(casadiTestCase):
     a = DMatrix([[1,2],[1,3]])
     self.checkarray(mul(c.inv(a),a),eye(2),"DMatrix inverse")
 
+  def test_inv_lu(self):
+    self.message("Matrix inverse, sparse and dense LU factorization")
+    numpy.random.seed(0)
+    n = 40
+    a = DMatrix(Sparsity.diag(n),[4+i%3 for i in range(n)])
+    for k in range(3*n):
+      a[numpy.random.randint(n),numpy.random.randint(n)] = numpy.random.rand()-0.5
+    # Less than a quarter of the entries: sparse LU
+    self.assertTrue(4*a.nnz()<n*n)
+    a_inv = c.inv(a)
+    self.checkarray(a_inv,c.inv(densify(a)),"sparse vs dense LU")
+    self.checkarray(a_inv,numpy.linalg.inv(array(a)),"sparse LU vs numpy")
+    self.checkarray(det(a)/numpy.linalg.det(array(a)),1,"det()")
+
+  def test_inv_singular(self):
+    self.message("Matrix inverse of a singular matrix")
+    # No error, the entries are inf or nan as with the Laplace formula
+    a = DMatrix([[1,2],[2,4]])
+    self.assertTrue(all(isinf(array(c.inv(a)))))
+    for n in [20,300]:
+      a = DMatrix(Sparsity.diag(n),range(n))
+      a_inv = c.inv(a)
+      self.assertTrue(isinf(float(a_inv[0,0])))
+      self.assertEqual(float(a_inv[n-1,n-1]),1./(n-1))
+      self.assertEqual(float(det(a)),0)
+
   def test_iter(self):
     self.message("iterator")
     L = []
@@ -2691,5 +2691,104 @@ class MXtests(casadiTestCase):
 
     h = g.jacobian(0,0,False,True)
 
+  def test_evaluate_no_realloc(self):
+    x = MX.sym("x",3)
+    y = MX.sym("y",3,3)
+    g = MXFunction([x],[sin(x)])
+    g.init()
+    f = MXFunction([x,y],[mul(y,g([x])[0])+x,inner_prod(x,x)])
+    f.init()
+
+    f.evaluate()
+    # The counters are only kept in debug builds
+    if "n_alloc_eval" not in f.getStats():
+      self.skipTest("allocations are only counted in debug builds")
+    n_realloc = f.getStat("n_realloc_work")
+    n_alloc = f.getStat("n_alloc_eval")
+    for i in range(10):
+      f.setInput(i,0)
+      f.evaluate()
+    self.assertEqual(f.getStat("n_realloc_work"),n_realloc)
+    # No heap allocations in evalD, including the nested call of g
+    self.assertEqual(f.getStat("n_alloc_eval"),n_alloc)
+
+  def test_reentrant_nested(self):
+    self.message("nested MXFunction calls in work vectors of the caller")
+    x = MX.sym("x",3)
+    y = MX.sym("y",3,3)
+    g = MXFunction([x],[sin(x)])
+    g.init()
+    h = MXFunction([x],[g([x])[0]*2+g([2*x])[0]])
+    h.init()
+    f = MXFunction([x,y],[mul(y,h([x])[0])+x,inner_prod(x,h([x])[0])])
+    f.init()
+
+    # Map evaluates f in its own work vector, with one part per thread
+    n = 12
+    X = DMatrix([[cos(i+j) for j in range(n)] for i in range(3)])
+    Y = DMatrix([[sin(i*j+1) for j in range(3*n)] for i in range(3)])
+    for mode in ["serial","threads"]:
+      m = f.map(n,{"parallelization": mode, "num_threads": 3, "gather_stats": True})
+      m.setInput(X,0)
+      m.setInput(Y,1)
+      for k in range(3):
+        m.evaluate()
+        for j in range(n):
+          f.setInput(X[:,j],0)
+          f.setInput(Y[:,3*j:3*j+3],1)
+          f.evaluate()
+          self.checkarray(m.getOutput(0)[:,j],f.getOutput(0),"output 0")
+          self.checkarray(m.getOutput(1)[:,j],f.getOutput(1),"output 1")
+      if mode=="threads":
+        # f is re-entrant, so Map did not fall back to serial evaluation
+        self.assertEqual(m.getStats()["num_threads"],3)
+
+  def test_reentrant_concurrent(self):
+    self.message("concurrent evaluation of shared functions in work vectors of the callers")
+    # Inner function: one RK4 step of a damped pendulum
+    xs = SX.sym("x",2)
+    ps = SX.sym("p")
+    dt = 0.05
+    ode = lambda x: vertcat([x[1],-sin(x[0])-ps*x[1]])
+    k1 = ode(xs)
+    k2 = ode(xs+dt/2*k1)
+    k3 = ode(xs+dt/2*k2)
+    k4 = ode(xs+dt*k3)
+    f = SXFunction([xs,ps],[xs+dt/6*(k1+2*k2+2*k3+k4)])
+    f.init()
+
+    # Middle function: 20 steps and a quadratic cost
+    x0 = MX.sym("x0",2)
+    p = MX.sym("p")
+    x = x0
+    cost = 0
+    for k in range(20):
+      x = f([x,p])[0]
+      cost += inner_prod(x,x)
+    h = MXFunction([x0,p],[x,cost])
+    h.init()
+    self.assertTrue(h.isReentrant())
+
+    # Distinct outer functions that all call h, and through it f. The functions are
+    # only referenced by the Parallelizer, which hence does not copy them: the threads
+    # evaluate the same h and f at the same time, each in the work vectors of its caller.
+    n = 8
+    par = Parallelizer([MXFunction([x0,p],h([2*x0,p])) for j in range(n)])
+    par.setOption("parallelization","threads")
+    par.setOption("num_threads",4)
+    par.init()
+
+    for r in range(20):
+      for j in range(n):
+        par.setInput([0.1+0.01*(j+n*r),-0.2],2*j)
+        par.setInput(0.05*j,2*j+1)
+      par.evaluate()
+      for j in range(n):
+        h.setInput(2*par.getInput(2*j),0)
+        h.setInput(par.getInput(2*j+1),1)
+        h.evaluate()
+        self.checkarray(par.getOutput(2*j),h.getOutput(0),"state")
+        self.checkarray(par.getOutput(2*j+1),h.getOutput(1),"cost")
+
 if __name__ == '__main__':
     unittest.main()
@@ -1519,6 +1519,70 @@ class NLPtests(casadiTestCase):
       self.checkarray(solver.getOutput("x"),DMatrix([0]),digits=7)
       self.checkarray(solver.getOutput("lam_x"),DMatrix([0]),digits=7)
       
+  @requiresPlugin(NlpSolver,"ipopt")
+  def test_ipopt_eval_cache(self):
+    x=SX.sym("x")
+    y=SX.sym("y")
+    nlp=SXFunction(nlpIn(x=vertcat([x,y])),nlpOut(f=(1-x)**2+100*(y-x**2)**2,g=x+y))
+    solver = NlpSolver("ipopt", nlp)
+    solver.setOption("tol",1e-10)
+    solver.init()
+    solver.setInput([-10]*2,"lbx")
+    solver.setInput([10]*2,"ubx")
+    solver.setInput(-10,"lbg")
+    solver.setInput(10,"ubg")
+    solver.evaluate()
+    self.checkarray(solver.getOutput("x"),DMatrix([1,1]),digits=6)
+    # f and g are evaluated together, at most once per iterate
+    stats = solver.getStats()
+    self.assertTrue(stats["n_eval_f_cached"]+stats["n_eval_g_cached"]>0)
+
+  @requiresPlugin(NlpSolver,"ipopt")
+  def test_ipopt_triangular_hessian(self):
+    n = 6
+    x=SX.sym("x",n)
+    f = sumAll(vertcat([(1-x[i])**2+10*(x[i+1]-x[i]**2)**2 for i in range(n-1)]))
+    results = []
+    for triangular in [True,False]:
+      for jac_num_threads in [1,2]:
+        nlp=SXFunction(nlpIn(x=x),nlpOut(f=f,g=x[0]*x[n-1]))
+        nlp.setOption("jac_num_threads",jac_num_threads)
+        solver = NlpSolver("ipopt", nlp)
+        solver.setOption("tol",1e-10)
+        solver.setOption("triangular_hessian",triangular)
+        solver.setOption("regularity_check",True)
+        solver.init()
+        solver.setInput(0.5,"x0")
+        solver.setInput(0.5,"lbg")
+        solver.setInput(2,"ubg")
+        solver.evaluate()
+        results.append((solver.getOutput("x"),solver.getStats()["iter_count"]))
+    for x_opt,iter_count in results[1:]:
+      self.checkarray(x_opt,results[0][0],digits=8)
+      self.assertEqual(iter_count,results[0][1])
+
+  @requiresPlugin(NlpSolver,"ipopt")
+  def test_ipopt_triangular_hessian_function(self):
+    n = 6
+    x=SX.sym("x",n)
+    f = sumAll(vertcat([(1-x[i])**2+10*(x[i+1]-x[i]**2)**2 for i in range(n-1)]))
+    g = vertcat([x[0]*x[n-1],sin(x[1])*x[2]**2])
+    H = []
+    for triangular in [True,False]:
+      nlp=SXFunction(nlpIn(x=x),nlpOut(f=f,g=g))
+      solver = NlpSolver("ipopt", nlp)
+      solver.setOption("triangular_hessian",triangular)
+      solver.init()
+      h = solver.hessLag()
+      h.setInput([cos(i) for i in range(n)],"x")
+      h.setInput(0.7,"lam_f")
+      h.setInput([0.3,-1.2],"lam_g")
+      h.evaluate()
+      H.append(h.getOutput("hess"))
+    # Upper triangular part of the symbolic Hessian
+    self.assertTrue(H[0].sparsity()==triu(H[1].sparsity()))
+    self.checkarray(H[0],triu(H[1]),digits=10)
+
 if __name__ == '__main__':
     unittest.main()
     print solvers
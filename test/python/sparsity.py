@@ -572,6 +572,98 @@ class Sparsitytests(casadiTestCase):
     
     self.checkarray(IMatrix(c_,1),IMatrix(c.kron(a,b).sparsity(),1))
     
+  def test_coloring(self):
+    self.message("Graph coloring")
+    n = 40
+    r = []
+    c = []
+    for i in range(n):
+      for j in [i-1,i,i+1,(7*i+3)%n]:
+        if j>=0 and j<n:
+          r.append(i)
+          c.append(j)
+    A = Sparsity.triplet(n,n,r,c)
+    Ad = array(DMatrix(A,1))
+
+    def checkcoloring(D,B):
+      # No two columns of the same color share a row
+      Dd = array(DMatrix(D,1))
+      self.assertTrue(all(sum(Dd,1)==1))
+      self.assertTrue(all(dot(B,Dd)<=1))
+
+    for p in [A.largestFirstOrdering(),A.smallestLastOrdering(),A.incidenceDegreeOrdering()]:
+      self.assertEqual(sorted(p),range(n))
+
+    for ordering in range(4):
+      D0 = A.unidirectionalColoring(A.T(),n,ordering,0)
+      checkcoloring(D0,Ad)
+      D1 = A.unidirectionalColoring(A.T(),n,ordering,5)
+      checkcoloring(D1,Ad)
+      self.assertTrue(D1.size2()<=D0.size2())
+
+    # Symmetric pattern: adjacent columns have different colors
+    S = A + A.T()
+    Sd = array(DMatrix(S,1))
+    for ordering in range(4):
+      for D in [S.starColoring(ordering),S.acyclicColoring(ordering)]:
+        Dd = array(DMatrix(D,1))
+        self.assertTrue(all(sum(Dd,1)==1))
+        self.assertTrue(all(dot(Sd-diag(diag(Sd)),Dd)*Dd==0))
+
+  def test_nested_dissection(self):
+    self.message("Nested dissection ordering")
+    m = 30
+    r = []
+    c = []
+    for i in range(m):
+      for j in range(m):
+        k = i*m+j
+        r.append(k)
+        c.append(k)
+        if i>0:
+          r+= [k,k-m]
+          c+= [k-m,k]
+        if j>0:
+          r+= [k,k-1]
+          c+= [k-1,k]
+    A = Sparsity.triplet(m*m,m*m,r,c)
+    n = m*m
+    edges = [(r[k],c[k]) for k in range(len(r)) if r[k]<c[k]]
+
+    # Number of nonzeros of the Cholesky factor after reordering
+    def nnz_factor(p):
+      pos = [0]*n
+      for i,v in enumerate(p): pos[v] = i
+      struct = [set() for i in range(n)]
+      for u,v in edges: struct[min(pos[u],pos[v])].add(max(pos[u],pos[v]))
+      nnz = 0
+      for k in range(n):
+        nnz += len(struct[k])+1
+        if struct[k]:
+          parent = min(struct[k])
+          struct[parent] |= struct[k]-set([parent])
+      return nnz
+
+    # Smallest trailing block that separates two leading blocks of at least n/5 vertices
+    def top_separator(p):
+      pos = [0]*n
+      for i,v in enumerate(p): pos[v] = i
+      e = [(min(pos[u],pos[v]),max(pos[u],pos[v])) for u,v in edges]
+      best = n
+      for s in range(n/5,n):
+        t = min([b for a,b in e if a<s<=b]+[n])
+        if t-s>=n/5: best = min(best,n-t)
+      return best
+
+    fill_natural = nnz_factor(range(n))
+    for leaf_size in [1,16,64,10000]:
+      p = A.nestedDissection(leaf_size)
+      self.assertEqual(sorted(p),range(n))
+      self.assertTrue(nnz_factor(p)<0.6*fill_natural)
+      if leaf_size<n:
+        # The grid is split by a separator of about one grid line, ordered last
+        self.assertTrue(top_separator(p)<=2*m)
+
 if __name__ == '__main__':
     unittest.main()
 
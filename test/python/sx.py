@@ -1296,7 +1296,109 @@ class SXtests(casadiTestCase):
         isSmooth(x)
       warnings.simplefilter("ignore")
       isSmooth(x)
-    
+
+  def test_cse(self):
+    x = SX.sym("x")
+    y = SX.sym("y")
+    e = [sin(x*y)+cos(y*x), sin(x*y)*2, -0.0*x+0.0*y]
+    f = SXFunction([x,y],[vertcat(e)])
+    f.init()
+    g = SXFunction([x,y],[vertcat(e)])
+    g.setOption("cse",True)
+    g.init()
+    self.assertTrue(g.getAlgorithmSize()<f.getAlgorithmSize())
+    for F in [f,g]:
+      F.setInput(0.3,0)
+      F.setInput(0.7,1)
+      F.evaluate()
+    self.checkarray(f.output(),g.output())
+
+  def test_node_pool(self):
+    self.message("statistics of the expression node pool")
+    s0 = SXElement.getNodeStats()
+    x = SX.sym("x",100000)
+    y = sin(x)*2+x
+    s1 = SXElement.getNodeStats()
+    self.assertTrue(s1["live_nodes"]>=s0["live_nodes"]+300000)
+    self.assertTrue(s1["live_bytes"]>s0["live_bytes"])
+    self.assertTrue(s1["peak_nodes"]>=s1["live_nodes"])
+    self.assertTrue(s1["peak_bytes"]>=s1["live_bytes"])
+    self.assertTrue(s1["reserved_bytes"]>=s1["live_bytes"])
+    del x, y
+    s2 = SXElement.getNodeStats()
+    self.assertEqual(s2["live_nodes"],s0["live_nodes"])
+    self.assertEqual(s2["live_bytes"],s0["live_bytes"])
+    self.assertEqual(s2["peak_nodes"],s1["peak_nodes"])
+    # Empty slabs are returned to the system
+    self.assertTrue(s2["reserved_bytes"]<s1["reserved_bytes"]/10)
+
+  def test_batch(self):
+    self.message("batched evaluation")
+    x = SX.sym("x",2)
+    y = SX.sym("y")
+    f = SXFunction([x,y],[sin(x)*y+3, x[0]*x[1]/y, 2])
+    f.init()
+    for n in [0,1,7]:
+      # Map's batch mode evaluates the n input sets in a single batched pass
+      m = f.map(n,{"parallelization": "batch"})
+      X = DMatrix.zeros(2,n)
+      Y = DMatrix.zeros(1,n)
+      for j in range(n):
+        X[:,j] = [0.3*j,1.1-j]
+        Y[0,j] = 0.7+j
+      m.setInput(X,0)
+      m.setInput(Y,1)
+      m.evaluate()
+      for i in range(f.getNumOutputs()):
+        self.assertEqual(m.output(i).shape,(f.output(i).size1(),n))
+      for j in range(n):
+        f.setInput(X[:,j],0)
+        f.setInput(Y[0,j],1)
+        f.evaluate()
+        for i in range(f.getNumOutputs()):
+          self.checkarray(m.getOutput(i)[:,j],f.getOutput(i),"batch %d, set %d" % (n,j))
+
+  def test_codegen_split(self):
+    self.message("generated code split into parts")
+    import tempfile, shutil, os, subprocess, ctypes
+    x = SX.sym("x",4)
+    # Values defined early and read in later parts
+    a = sin(x)
+    z = x[0]
+    for i in range(200):
+      z = sin(z)*0.9+a[i%4]*0.01
+    X = [0.3,-1.2,2.1,0.7]
+    dp = ctypes.POINTER(ctypes.c_double)
+    root = tempfile.mkdtemp()
+    try:
+      for codegen_split in [0,7,25]:
+        f = SXFunction([x],[z+sumAll(a),a*z])
+        f.setOption("codegen_split",codegen_split)
+        f.init()
+        name = os.path.join(root,"f%d" % codegen_split)
+        f.generateCode(name+".c")
+        subprocess.check_call(["gcc","-fPIC","-shared","-O2",name+".c","-o",name+".so","-lm"])
+        lib = ctypes.CDLL(name+".so")
+
+        # Several parts that pass values in the work vector
+        code = open(name+".c").read()
+        if codegen_split>0:
+          self.assertTrue(code.count("_p1(arg, res, w)")==1)
+          self.assertTrue("w[" in code)
+
+        # Compare with the virtual machine
+        f.setInput(X)
+        f.evaluate()
+        xb = (ctypes.c_double*4)(*X)
+        res = [(ctypes.c_double*f.output(i).nnz())() for i in range(2)]
+        arg_ptr = (dp*1)(ctypes.cast(xb,dp))
+        res_ptr = (dp*2)(*[ctypes.cast(r,dp) for r in res])
+        self.assertEqual(lib.evaluateWrap(arg_ptr,res_ptr),0)
+        for i in range(2):
+          self.checkarray(DMatrix(list(res[i])),DMatrix(list(f.getOutput(i).data())),digits=12)
+    finally:
+      shutil.rmtree(root)
+
 if __name__ == '__main__':
     unittest.main()
 